@@ -0,0 +1,153 @@
+#include "DescriptorAllocator.h"
+
+#include <algorithm>
+
+
+/**
+ * @param device Logical device the pools are created on.
+ * @param allocator Host allocation callbacks (nullptr for the driver default).
+ * @param initialSetsPerPool Set capacity of the first pool; later pools grow by half each time.
+ * @param ratios Descriptors of each type to reserve per set.
+ */
+DescriptorAllocator::DescriptorAllocator(VkDevice device, const VkAllocationCallbacks* allocator, uint32_t initialSetsPerPool, const std::vector<PoolSizeRatio>& ratios)
+    : device(device), allocator(allocator), ratios(ratios), setsPerPool(std::max(initialSetsPerPool, 1u)) {}
+DescriptorAllocator::~DescriptorAllocator() {
+    for (VkDescriptorPool pool : readyPools) {
+        vkDestroyDescriptorPool(device, pool, allocator);
+    }
+    for (VkDescriptorPool pool : fullPools) {
+        vkDestroyDescriptorPool(device, pool, allocator);
+    }
+}
+
+/**
+ * @brief Allocates one descriptor set, adding a pool if every existing pool is exhausted.
+ *
+ * @throws std::runtime_error if the set cannot be allocated even from a new pool.
+ */
+VkDescriptorSet DescriptorAllocator::Allocate(VkDescriptorSetLayout layout) {
+    VkDescriptorPool pool = GetPool();
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &layout;
+
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    VkResult result = vkAllocateDescriptorSets(device, &allocInfo, &set);
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+        // Retire the pool until the next Reset and retry once from a fresh one.
+        fullPools.push_back(pool);
+        pool = GetPool();
+        allocInfo.descriptorPool = pool;
+        result = vkAllocateDescriptorSets(device, &allocInfo, &set);
+    }
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate descriptor set!");
+    }
+
+    readyPools.push_back(pool);
+    return set;
+}
+/**
+ * @brief Returns every set allocated so far to its pool. The pools themselves are kept.
+ *
+ * The caller must make sure none of the sets are still in use by the GPU.
+ */
+void DescriptorAllocator::Reset() {
+    for (VkDescriptorPool pool : readyPools) {
+        vkResetDescriptorPool(device, pool, 0);
+    }
+    for (VkDescriptorPool pool : fullPools) {
+        vkResetDescriptorPool(device, pool, 0);
+        readyPools.push_back(pool);
+    }
+    fullPools.clear();
+}
+uint32_t DescriptorAllocator::GetPoolCount() const {
+    return static_cast<uint32_t>(readyPools.size() + fullPools.size());
+}
+
+/**
+ * @brief Takes a pool with possible room off the ready list, creating a larger one if there is none.
+ */
+VkDescriptorPool DescriptorAllocator::GetPool() {
+    if (!readyPools.empty()) {
+        VkDescriptorPool pool = readyPools.back();
+        readyPools.pop_back();
+        return pool;
+    }
+
+    VkDescriptorPool pool = CreatePool(setsPerPool);
+    setsPerPool = std::min(setsPerPool + setsPerPool / 2 + 1, MAX_SETS_PER_POOL);
+    return pool;
+}
+/**
+ * @throws std::runtime_error if pool creation fails.
+ */
+VkDescriptorPool DescriptorAllocator::CreatePool(uint32_t setCount) {
+    std::vector<VkDescriptorPoolSize> poolSizes;
+    poolSizes.reserve(ratios.size());
+    for (const PoolSizeRatio& ratio : ratios) {
+        uint32_t descriptorCount = static_cast<uint32_t>(ratio.ratio * static_cast<float>(setCount));
+        poolSizes.push_back({ ratio.type, std::max(descriptorCount, 1u) });
+    }
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = setCount;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    if (vkCreateDescriptorPool(device, &poolInfo, allocator, &pool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor pool!");
+    }
+    return pool;
+}
+
+void DescriptorWriter::WriteBuffer(VkDescriptorSet set, uint32_t binding, VkDescriptorType type, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+    VkDescriptorBufferInfo& bufferInfo = bufferInfos.emplace_back();
+    bufferInfo.buffer = buffer;
+    bufferInfo.offset = offset;
+    bufferInfo.range = range;
+
+    VkWriteDescriptorSet& write = writes.emplace_back();
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = set;
+    write.dstBinding = binding;
+    write.dstArrayElement = 0;
+    write.descriptorType = type;
+    write.descriptorCount = 1;
+    write.pBufferInfo = &bufferInfo;
+}
+void DescriptorWriter::WriteImage(VkDescriptorSet set, uint32_t binding, uint32_t arrayElement, VkDescriptorType type, VkImageView imageView, VkSampler sampler, VkImageLayout imageLayout) {
+    VkDescriptorImageInfo& imageInfo = imageInfos.emplace_back();
+    imageInfo.imageView = imageView;
+    imageInfo.sampler = sampler;
+    imageInfo.imageLayout = imageLayout;
+
+    VkWriteDescriptorSet& write = writes.emplace_back();
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = set;
+    write.dstBinding = binding;
+    write.dstArrayElement = arrayElement;
+    write.descriptorType = type;
+    write.descriptorCount = 1;
+    write.pImageInfo = &imageInfo;
+}
+/**
+ * @brief Submits every pending write in a single vkUpdateDescriptorSets call, then clears them.
+ */
+void DescriptorWriter::Update(VkDevice device) {
+    if (!writes.empty()) {
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+    Clear();
+}
+void DescriptorWriter::Clear() {
+    bufferInfos.clear();
+    imageInfos.clear();
+    writes.clear();
+}
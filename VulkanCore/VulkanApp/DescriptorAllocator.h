@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Utilities.h"
+
+#include <deque>
+
+
+/**
+ * @file DescriptorAllocator.h
+ * @brief Defines the DescriptorAllocator class, a growable pool of descriptor pools, and the DescriptorWriter batching helper.
+ */
+
+/**
+ * @class DescriptorAllocator
+ * @brief Allocates descriptor sets from a list of pools, creating a new pool whenever the current one runs out.
+ *
+ * Pools are never sized up front for a worst case. When an allocation fails because a pool is full
+ * or fragmented, the pool is retired and the allocation is retried from a fresh one, each new pool
+ * holding more sets than the last. Sets are not freed one by one; Reset returns every set at once
+ * and keeps the pools for reuse, so an allocator owned by one frame can be recycled once that
+ * frame's fence has signaled.
+ */
+class DescriptorAllocator {
+public:
+    /**
+     * @brief Descriptors of one type to reserve per set in each pool.
+     */
+    struct PoolSizeRatio {
+        VkDescriptorType type; ///< Descriptor type.
+        float ratio;           ///< Descriptors of this type per set.
+    };
+
+    DescriptorAllocator(VkDevice device, const VkAllocationCallbacks* allocator, uint32_t initialSetsPerPool, const std::vector<PoolSizeRatio>& ratios);
+    ~DescriptorAllocator();
+
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+    VkDescriptorSet Allocate(VkDescriptorSetLayout layout);
+    void Reset();
+
+    uint32_t GetPoolCount() const;
+
+private:
+    static constexpr uint32_t MAX_SETS_PER_POOL = 4096; ///< Upper bound for the geometric pool growth.
+
+    // Vulkan handles
+    VkDevice device = VK_NULL_HANDLE;                 ///< Vulkan logical device handle.
+    const VkAllocationCallbacks* allocator = nullptr; ///< Host allocation callbacks (nullptr for the driver default).
+
+    // Pools
+    std::vector<PoolSizeRatio> ratios;        ///< Descriptor mix every pool is created with.
+    std::vector<VkDescriptorPool> readyPools; ///< Pools that may still have room.
+    std::vector<VkDescriptorPool> fullPools;  ///< Pools that failed an allocation since the last Reset.
+    uint32_t setsPerPool = 0;                 ///< Set capacity of the next pool created.
+
+    VkDescriptorPool GetPool();
+    VkDescriptorPool CreatePool(uint32_t setCount);
+};
+
+/**
+ * @class DescriptorWriter
+ * @brief Collects descriptor writes for any number of sets and submits them in one vkUpdateDescriptorSets call.
+ *
+ * Buffer and image infos are kept in deques so the pointers stored in the pending writes stay valid
+ * as more writes are added.
+ */
+class DescriptorWriter {
+public:
+    void WriteBuffer(VkDescriptorSet set, uint32_t binding, VkDescriptorType type, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+    void WriteImage(VkDescriptorSet set, uint32_t binding, uint32_t arrayElement, VkDescriptorType type, VkImageView imageView, VkSampler sampler, VkImageLayout imageLayout);
+    void Update(VkDevice device);
+    void Clear();
+
+private:
+    std::deque<VkDescriptorBufferInfo> bufferInfos; ///< Targets of pending buffer writes.
+    std::deque<VkDescriptorImageInfo> imageInfos;   ///< Targets of pending image writes.
+    std::vector<VkWriteDescriptorSet> writes;       ///< Pending writes, in the order they were added.
+};
@@ -0,0 +1,124 @@
+#include "FileWatcher.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+
+void AddUnique(std::vector<std::string>& paths, const std::string& path) {
+    if (std::find(paths.begin(), paths.end(), path) == paths.end()) {
+        paths.push_back(path);
+    }
+}
+
+} // namespace
+
+FileWatcher::FileWatcher() {
+#ifdef __linux__
+    notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+    if (notifyFd != -1) {
+        close(notifyFd);
+    }
+#endif
+}
+
+/**
+ * @brief Starts tracking path. Its current contents count as seen, so it is only reported once written again.
+ *
+ * A missing file is tracked too and reported once it appears.
+ */
+void FileWatcher::Watch(const std::string& path) {
+    const std::filesystem::path filePath(path);
+    WatchedFile file;
+    file.path = path;
+    file.fileName = filePath.filename().string();
+
+    std::error_code error;
+    file.lastWriteTime = std::filesystem::last_write_time(filePath, error);
+
+#ifdef __linux__
+    if (notifyFd != -1) {
+        const std::string directory = filePath.has_parent_path() ? filePath.parent_path().string() : ".";
+        // Watching the same directory again returns its existing descriptor.
+        file.directoryWatch = inotify_add_watch(notifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    }
+#endif
+    files.push_back(std::move(file));
+}
+/**
+ * @brief Returns every watched path written since the last call, each once.
+ */
+std::vector<std::string> FileWatcher::PollChanges() {
+    std::vector<std::string> changed;
+    if (UsesNotifications()) {
+        ReadNotifications(changed);
+    }
+    else {
+        CompareWriteTimes(changed);
+    }
+    return changed;
+}
+/**
+ * @brief True if changes come from inotify rather than from polling modification times.
+ */
+bool FileWatcher::UsesNotifications() const {
+    return notifyFd != -1;
+}
+
+/**
+ * @brief Drains the inotify queue without blocking.
+ */
+void FileWatcher::ReadNotifications(std::vector<std::string>& changed) {
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        const ssize_t length = read(notifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;  // EAGAIN: the queue is empty.
+        }
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            if (event->len == 0) {
+                continue;
+            }
+            for (const WatchedFile& file : files) {
+                if (file.directoryWatch == event->wd && file.fileName == event->name) {
+                    AddUnique(changed, file.path);
+                }
+            }
+        }
+    }
+#else
+    (void)changed;
+#endif
+}
+/**
+ * @brief Compares each file's modification time with the one last seen, at most every POLL_INTERVAL.
+ */
+void FileWatcher::CompareWriteTimes(std::vector<std::string>& changed) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - lastPoll < POLL_INTERVAL) {
+        return;
+    }
+    lastPoll = now;
+
+    for (WatchedFile& file : files) {
+        std::error_code error;
+        const auto writeTime = std::filesystem::last_write_time(file.path, error);
+        if (error || writeTime == file.lastWriteTime) {
+            continue;
+        }
+        file.lastWriteTime = writeTime;
+        AddUnique(changed, file.path);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+
+/**
+ * @file FileWatcher.h
+ * @brief Defines the FileWatcher class, which reports files that changed on disk.
+ */
+
+/**
+ * @class FileWatcher
+ * @brief Tracks a set of files and reports the ones written since the last poll.
+ *
+ * On Linux the watched files' directories are registered with inotify, so a poll is a single
+ * non-blocking read that usually returns nothing. Directories are watched rather than the files
+ * themselves because many editors save by writing a new file and renaming it over the old one,
+ * which would silently end a per-file watch. Elsewhere, or if inotify is unavailable, the files'
+ * modification times are compared at most every POLL_INTERVAL.
+ *
+ * A file is reported once per poll no matter how many writes it saw in between.
+ */
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    void Watch(const std::string& path);
+    std::vector<std::string> PollChanges();
+
+    bool UsesNotifications() const;
+
+private:
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{ 250 };
+
+    /**
+     * @brief One watched file.
+     */
+    struct WatchedFile {
+        std::string path;                                ///< As passed to Watch, and as reported.
+        std::string fileName;                            ///< Name within its directory, matched against inotify events.
+        int directoryWatch = -1;                         ///< inotify watch descriptor of its directory.
+        std::filesystem::file_time_type lastWriteTime{}; ///< Used when polling modification times.
+    };
+
+    std::vector<WatchedFile> files;
+    int notifyFd = -1;                                   ///< inotify instance; -1 when polling instead.
+    std::chrono::steady_clock::time_point lastPoll{};
+
+    void ReadNotifications(std::vector<std::string>& changed);
+    void CompareWriteTimes(std::vector<std::string>& changed);
+};
@@ -0,0 +1,94 @@
+#include "FrameRingBuffer.h"
+
+#include <algorithm>
+
+
+namespace {
+
+VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+/**
+ * @param device Logical device the buffer is created on.
+ * @param physicalDevice Physical device whose offset alignment limits and memory types are used.
+ * @param allocator Host allocation callbacks (nullptr for the driver default).
+ * @param frameCount Frames in flight; each gets its own region.
+ * @param frameSize Bytes each frame needs, rounded up to the slice alignment.
+ *
+ * @throws std::runtime_error if the buffer cannot be created or mapped.
+ */
+FrameRingBuffer::FrameRingBuffer(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator, uint32_t frameCount, VkDeviceSize frameSize)
+    : device(device), allocator(allocator) {
+    // Slices are bound as both uniform and storage buffers, so they satisfy the stricter alignment.
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    alignment = std::max({ properties.limits.minUniformBufferOffsetAlignment, properties.limits.minStorageBufferOffsetAlignment, VkDeviceSize{ 1 } });
+    this->frameSize = AlignUp(std::max(frameSize, VkDeviceSize{ 1 }), alignment);
+
+    VkDeviceSize bufferSize = this->frameSize * frameCount;
+    createBuffer(
+        device,
+        physicalDevice,
+        bufferSize,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        buffer,
+        memory,
+        allocator
+    );
+
+    void* data = nullptr;
+    if (vkMapMemory(device, memory, 0, bufferSize, 0, &data) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to map frame ring buffer!");
+    }
+    mapped = static_cast<uint8_t*>(data);
+}
+FrameRingBuffer::~FrameRingBuffer() {
+    if (buffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device, buffer, allocator);
+    }
+    if (memory != VK_NULL_HANDLE) {
+        vkUnmapMemory(device, memory);
+        vkFreeMemory(device, memory, allocator);
+    }
+}
+
+/**
+ * @brief Rewinds the frame's region. Its fence must already be signaled.
+ */
+void FrameRingBuffer::BeginFrame(uint32_t frame) {
+    frameBegin = frameSize * frame;
+    cursor = frameBegin;
+}
+/**
+ * @brief Takes the next aligned slice of the current frame's region.
+ *
+ * Slices come out in call order, so a frame that makes the same allocations as last time gets the
+ * same offsets, and data it chose not to rewrite is still in place.
+ *
+ * @throws std::runtime_error if the slice does not fit in the rest of the region.
+ */
+FrameRingBuffer::Allocation FrameRingBuffer::Allocate(VkDeviceSize size) {
+    VkDeviceSize offset = AlignUp(cursor, alignment);
+    if (offset + size > frameBegin + frameSize) {
+        throw std::runtime_error("Frame ring buffer region is full!");
+    }
+    cursor = offset + size;
+    return { offset, mapped + offset };
+}
+
+VkBuffer FrameRingBuffer::GetBuffer() const {
+    return buffer;
+}
+VkDeviceSize FrameRingBuffer::GetFrameSize() const {
+    return frameSize;
+}
+VkDeviceSize FrameRingBuffer::GetAlignment() const {
+    return alignment;
+}
+VkDeviceSize FrameRingBuffer::GetUsedSize() const {
+    return cursor - frameBegin;
+}
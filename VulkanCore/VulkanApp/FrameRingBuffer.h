@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Utilities.h"
+
+
+/**
+ * @file FrameRingBuffer.h
+ * @brief Defines the FrameRingBuffer class, a persistently mapped buffer carved into one linear region per frame in flight.
+ */
+
+/**
+ * @class FrameRingBuffer
+ * @brief One host-visible buffer holding all of a frame's per-view and per-object shader data.
+ *
+ * The buffer is split into a fixed-size region per frame in flight. BeginFrame rewinds the frame's
+ * region, and Allocate hands out consecutive, suitably aligned slices of it, so a frame's data is
+ * written linearly into memory that stays mapped for the buffer's lifetime. Shaders reach each slice
+ * through a dynamic descriptor (UNIFORM_BUFFER_DYNAMIC or STORAGE_BUFFER_DYNAMIC) bound with the
+ * slice's offset, so one descriptor set layout serves every frame and every slice. The caller
+ * guarantees a frame's fence has signaled before rewinding its region.
+ */
+class FrameRingBuffer {
+public:
+    /**
+     * @brief A slice of the current frame's region.
+     */
+    struct Allocation {
+        VkDeviceSize offset = 0; ///< Offset from the start of the buffer, used as the dynamic offset.
+        void* data = nullptr;    ///< Mapped pointer to the slice.
+    };
+
+    FrameRingBuffer(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator, uint32_t frameCount, VkDeviceSize frameSize);
+    ~FrameRingBuffer();
+
+    FrameRingBuffer(const FrameRingBuffer&) = delete;
+    FrameRingBuffer& operator=(const FrameRingBuffer&) = delete;
+
+    void BeginFrame(uint32_t frame);
+    Allocation Allocate(VkDeviceSize size);
+
+    VkBuffer GetBuffer() const;
+    VkDeviceSize GetFrameSize() const;
+    VkDeviceSize GetAlignment() const;
+    VkDeviceSize GetUsedSize() const;
+
+private:
+    // Vulkan handles
+    VkDevice device = VK_NULL_HANDLE;                 ///< Vulkan logical device handle.
+    const VkAllocationCallbacks* allocator = nullptr; ///< Host allocation callbacks (nullptr for the driver default).
+    VkBuffer buffer = VK_NULL_HANDLE;                 ///< Every frame's region, back to back.
+    VkDeviceMemory memory = VK_NULL_HANDLE;           ///< Host-visible, coherent backing memory.
+    uint8_t* mapped = nullptr;                        ///< Start of the buffer, mapped for its whole lifetime.
+
+    // Layout
+    VkDeviceSize alignment = 1;   ///< Offset alignment for uniform and storage buffer slices.
+    VkDeviceSize frameSize = 0;   ///< Bytes per frame region, a multiple of alignment.
+    VkDeviceSize frameBegin = 0;  ///< Start of the current frame's region.
+    VkDeviceSize cursor = 0;      ///< Next free byte in the current frame's region.
+};
@@ -0,0 +1,348 @@
+#include "FrustumCuller.h"
+
+#include <iomanip>
+#include <random>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FRUSTUM_CULLER_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC accepts AVX intrinsics in any function, so no per-function target is needed.
+#define FRUSTUM_CULLER_AVX2_TARGET
+#else
+// GCC and Clang only emit AVX instructions in functions compiled for that target.
+#define FRUSTUM_CULLER_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+
+namespace {
+
+/**
+ * @brief Read-only view of the culler's component arrays.
+ */
+struct SphereArrays {
+    const float* x;
+    const float* y;
+    const float* z;
+    const float* r;
+};
+
+/**
+ * @brief Tests spheres [first, count) one at a time and appends the visible indices.
+ *
+ * @return The new number of visible indices.
+ */
+uint32_t CullScalar(const Frustum& frustum, const SphereArrays& spheres, uint32_t first, uint32_t count, uint32_t* visible, uint32_t visibleCount) {
+    for (uint32_t i = first; i < count; i++) {
+        bool inside = true;
+        for (const glm::vec4& plane : frustum.planes) {
+            // Same association as the SIMD paths, so a sphere exactly on a plane gets the same answer from each.
+            float distance = (plane.x * spheres.x[i] + plane.y * spheres.y[i]) + (plane.z * spheres.z[i] + plane.w);
+            inside &= distance >= -spheres.r[i];
+        }
+        // Always write and only advance on a hit, so the loop has no unpredictable branch.
+        visible[visibleCount] = i;
+        visibleCount += inside ? 1 : 0;
+    }
+    return visibleCount;
+}
+
+#if defined(FRUSTUM_CULLER_X86)
+/**
+ * @brief Tests spheres 4 at a time with SSE and appends the visible indices.
+ *
+ * @return The first index left for the scalar tail.
+ */
+uint32_t CullSse(const Frustum& frustum, const SphereArrays& spheres, uint32_t count, uint32_t* visible, uint32_t& visibleCount) {
+    __m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+    for (size_t p = 0; p < 6; p++) {
+        planeX[p] = _mm_set1_ps(frustum.planes[p].x);
+        planeY[p] = _mm_set1_ps(frustum.planes[p].y);
+        planeZ[p] = _mm_set1_ps(frustum.planes[p].z);
+        planeW[p] = _mm_set1_ps(frustum.planes[p].w);
+    }
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(spheres.x + i);
+        __m128 y = _mm_loadu_ps(spheres.y + i);
+        __m128 z = _mm_loadu_ps(spheres.z + i);
+        __m128 negRadius = _mm_xor_ps(_mm_loadu_ps(spheres.r + i), signMask);
+
+        __m128 inside = _mm_cmpeq_ps(x, x);
+        for (size_t p = 0; p < 6; p++) {
+            __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(x, planeX[p]), _mm_mul_ps(y, planeY[p])),
+                _mm_add_ps(_mm_mul_ps(z, planeZ[p]), planeW[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        if (mask == 0) {
+            continue;
+        }
+        for (uint32_t lane = 0; lane < 4; lane++) {
+            visible[visibleCount] = i + lane;
+            visibleCount += (mask >> lane) & 1;
+        }
+    }
+    return i;
+}
+
+/**
+ * @brief Tests spheres 8 at a time with AVX2 and appends the visible indices.
+ *
+ * Only call when GetBestPath() reports AVX2.
+ *
+ * @return The first index left for the scalar tail.
+ */
+FRUSTUM_CULLER_AVX2_TARGET
+uint32_t CullAvx2(const Frustum& frustum, const SphereArrays& spheres, uint32_t count, uint32_t* visible, uint32_t& visibleCount) {
+    __m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+    for (size_t p = 0; p < 6; p++) {
+        planeX[p] = _mm256_set1_ps(frustum.planes[p].x);
+        planeY[p] = _mm256_set1_ps(frustum.planes[p].y);
+        planeZ[p] = _mm256_set1_ps(frustum.planes[p].z);
+        planeW[p] = _mm256_set1_ps(frustum.planes[p].w);
+    }
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(spheres.x + i);
+        __m256 y = _mm256_loadu_ps(spheres.y + i);
+        __m256 z = _mm256_loadu_ps(spheres.z + i);
+        __m256 negRadius = _mm256_xor_ps(_mm256_loadu_ps(spheres.r + i), signMask);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (size_t p = 0; p < 6; p++) {
+            __m256 distance = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(x, planeX[p]), _mm256_mul_ps(y, planeY[p])),
+                _mm256_add_ps(_mm256_mul_ps(z, planeZ[p]), planeW[p]));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+        }
+
+        int mask = _mm256_movemask_ps(inside);
+        if (mask == 0) {
+            continue;
+        }
+        for (uint32_t lane = 0; lane < 8; lane++) {
+            visible[visibleCount] = i + lane;
+            visibleCount += (mask >> lane) & 1;
+        }
+    }
+    return i;
+}
+
+bool IsAvx2Supported() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // AVX also needs the OS to save the YMM registers on context switches.
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+} // namespace
+
+
+/**
+ * @brief Extracts the six normalized frustum planes from a view-projection matrix.
+ *
+ * Uses the Gribb-Hartmann method for a [0, 1] depth range (GLM_FORCE_DEPTH_ZERO_TO_ONE).
+ */
+Frustum Frustum::FromViewProjection(const glm::mat4& viewProjection) {
+    // GLM is column-major, so row i of the matrix is (m[0][i], m[1][i], m[2][i], m[3][i]).
+    glm::mat4 m = glm::transpose(viewProjection);
+
+    Frustum frustum{ {
+        m[3] + m[0], // Left
+        m[3] - m[0], // Right
+        m[3] + m[1], // Bottom
+        m[3] - m[1], // Top
+        m[2],        // Near
+        m[3] - m[2]  // Far
+    } };
+    for (auto& plane : frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+/**
+ * @brief Appends a bounding sphere.
+ *
+ * @return Index of the new sphere.
+ */
+uint32_t FrustumCuller::Add(const glm::vec4& boundingSphere) {
+    centerX.push_back(boundingSphere.x);
+    centerY.push_back(boundingSphere.y);
+    centerZ.push_back(boundingSphere.z);
+    radius.push_back(boundingSphere.w);
+    return static_cast<uint32_t>(radius.size() - 1);
+}
+void FrustumCuller::Set(uint32_t index, const glm::vec4& boundingSphere) {
+    centerX[index] = boundingSphere.x;
+    centerY[index] = boundingSphere.y;
+    centerZ[index] = boundingSphere.z;
+    radius[index] = boundingSphere.w;
+}
+/**
+ * @brief Removes a sphere by moving the last one into its index.
+ */
+void FrustumCuller::Remove(uint32_t index) {
+    centerX[index] = centerX.back();
+    centerY[index] = centerY.back();
+    centerZ[index] = centerZ.back();
+    radius[index] = radius.back();
+    centerX.pop_back();
+    centerY.pop_back();
+    centerZ.pop_back();
+    radius.pop_back();
+}
+void FrustumCuller::Clear() {
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    radius.clear();
+}
+uint32_t FrustumCuller::Size() const {
+    return static_cast<uint32_t>(radius.size());
+}
+
+/**
+ * @brief Culls every sphere with the fastest path the CPU supports.
+ *
+ * @param frustum World-space frustum to test against.
+ * @param visible Receives the indices of the spheres that intersect the frustum, in ascending order.
+ */
+void FrustumCuller::Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+    Cull(frustum, visible, GetBestPath());
+}
+/**
+ * @brief Culls every sphere with the given path, falling back to a slower one if the CPU lacks it.
+ *
+ * A sphere is visible unless its center lies more than its radius behind one of the planes.
+ */
+void FrustumCuller::Cull(const Frustum& frustum, std::vector<uint32_t>& visible, Path path) const {
+    const uint32_t count = Size();
+    const SphereArrays spheres{ centerX.data(), centerY.data(), centerZ.data(), radius.data() };
+
+    // Every path writes at most one index per sphere, so the worst case is sized up front.
+    visible.resize(count);
+    uint32_t visibleCount = 0;
+    uint32_t first = 0;
+
+    if (path == Path::AVX2 && GetBestPath() != Path::AVX2) {
+        path = Path::SSE;
+    }
+#if defined(FRUSTUM_CULLER_X86)
+    if (path == Path::AVX2) {
+        first = CullAvx2(frustum, spheres, count, visible.data(), visibleCount);
+    }
+    else if (path == Path::SSE) {
+        first = CullSse(frustum, spheres, count, visible.data(), visibleCount);
+    }
+#endif
+    visibleCount = CullScalar(frustum, spheres, first, count, visible.data(), visibleCount);
+    visible.resize(visibleCount);
+}
+
+FrustumCuller::Path FrustumCuller::GetBestPath() {
+#if defined(FRUSTUM_CULLER_X86)
+    static const Path bestPath = IsAvx2Supported() ? Path::AVX2 : Path::SSE;
+    return bestPath;
+#else
+    return Path::Scalar;
+#endif
+}
+const char* FrustumCuller::GetPathName(Path path) {
+    switch (path) {
+    case Path::Scalar: return "Scalar";
+    case Path::SSE:    return "SSE";
+    case Path::AVX2:   return "AVX2";
+    default:           return "Unknown";
+    }
+}
+
+/**
+ * @brief Culls randomly placed spheres with every available path and reports the timings.
+ *
+ * Runs entirely on the CPU; no Vulkan objects are created. The camera sits at the origin looking
+ * down -Z, so roughly a tenth of the spheres end up visible. Each path must produce the same
+ * visible list as the scalar reference.
+ *
+ * @param objectCount Number of spheres to cull.
+ * @param out Stream the results are written to.
+ */
+void FrustumCuller::RunBenchmark(uint32_t objectCount, std::ostream& out) {
+    constexpr uint32_t WARMUP_RUNS = 3;
+    constexpr uint32_t SAMPLE_RUNS = 20;
+
+    FrustumCuller culler;
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> size(0.5f, 4.0f);
+    for (uint32_t i = 0; i < objectCount; i++) {
+        culler.Add(glm::vec4(position(generator), position(generator), position(generator), size(generator)));
+    }
+
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 250.0f);
+    Frustum frustum = Frustum::FromViewProjection(projection * view);
+
+    std::vector<uint32_t> reference;
+    culler.Cull(frustum, reference, Path::Scalar);
+
+    out << "Culling benchmark (" << objectCount << " spheres, best path " << GetPathName(GetBestPath()) << "):\n"
+        << std::setw(8) << "Path" << std::setw(12) << "Visible" << std::setw(12) << "ms" << std::setw(16) << "Mspheres/s" << "\n";
+
+    double scalarMs = 0.0;
+    std::vector<uint32_t> visible;
+    for (Path path : { Path::Scalar, Path::SSE, Path::AVX2 }) {
+        if (path > GetBestPath()) {
+            continue;
+        }
+
+        for (uint32_t run = 0; run < WARMUP_RUNS; run++) {
+            culler.Cull(frustum, visible, path);
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t run = 0; run < SAMPLE_RUNS; run++) {
+            culler.Cull(frustum, visible, path);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count() / SAMPLE_RUNS;
+        if (path == Path::Scalar) {
+            scalarMs = ms;
+        }
+
+        out << std::setw(8) << GetPathName(path)
+            << std::setw(12) << visible.size()
+            << std::setw(12) << std::fixed << std::setprecision(3) << ms
+            << std::setw(16) << std::setprecision(1) << objectCount / (ms * 1000.0);
+        if (path != Path::Scalar && ms > 0.0) {
+            out << "  (" << std::setprecision(2) << scalarMs / ms << "x)";
+        }
+        if (visible != reference) {
+            out << "  MISMATCH";
+        }
+        out << "\n";
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Utilities.h"
+
+#include <array>
+
+
+/**
+ * @file FrustumCuller.h
+ * @brief Defines the view frustum and the FrustumCuller class, a SIMD CPU culler over structure-of-arrays bounds.
+ */
+
+/**
+ * @brief Six normalized clip planes. A point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0.
+ */
+struct Frustum {
+    std::array<glm::vec4, 6> planes; ///< Left, right, bottom, top, near, far.
+
+    static Frustum FromViewProjection(const glm::mat4& viewProjection);
+};
+
+/**
+ * @class FrustumCuller
+ * @brief Stores world-space bounding spheres as separate x, y, z and radius arrays and culls them on the CPU.
+ *
+ * Keeping each component in its own array lets a single load fill a SIMD register with the same
+ * component of consecutive objects, so the plane tests run on 8 spheres at once with AVX2, or 4 with
+ * SSE on CPUs without it. The path is picked at runtime, so the build needs no extra compiler flags.
+ * Objects are addressed by the index returned from Add, which the renderer keeps equal to the model index.
+ */
+class FrustumCuller {
+public:
+    /**
+     * @brief Instruction set used for the plane tests.
+     */
+    enum class Path {
+        Scalar,
+        SSE,
+        AVX2
+    };
+
+    uint32_t Add(const glm::vec4& boundingSphere);
+    void Set(uint32_t index, const glm::vec4& boundingSphere);
+    void Remove(uint32_t index);
+    void Clear();
+    uint32_t Size() const;
+
+    void Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+    void Cull(const Frustum& frustum, std::vector<uint32_t>& visible, Path path) const;
+
+    static Path GetBestPath();
+    static const char* GetPathName(Path path);
+    static void RunBenchmark(uint32_t objectCount, std::ostream& out);
+
+private:
+    // Bounding spheres, one entry per object in each array.
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+};
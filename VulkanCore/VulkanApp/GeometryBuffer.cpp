@@ -0,0 +1,163 @@
+#include "GeometryBuffer.h"
+
+#include <algorithm>
+
+
+GeometryBuffer::GeometryBuffer(VkDevice device, VkPhysicalDevice physicalDevice, VkQueue graphicsQueue, VkCommandPool commandPool, const VkAllocationCallbacks* allocator)
+    : device(device), physicalDevice(physicalDevice), graphicsQueue(graphicsQueue), commandPool(commandPool), allocator(allocator) {}
+GeometryBuffer::~GeometryBuffer() {
+    if (vertexBuffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device, vertexBuffer, allocator);
+        vertexBuffer = VK_NULL_HANDLE;
+    }
+    if (vertexBufferMemory != VK_NULL_HANDLE) {
+        vkFreeMemory(device, vertexBufferMemory, allocator);
+        vertexBufferMemory = VK_NULL_HANDLE;
+    }
+    if (positionBuffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device, positionBuffer, allocator);
+        positionBuffer = VK_NULL_HANDLE;
+    }
+    if (positionBufferMemory != VK_NULL_HANDLE) {
+        vkFreeMemory(device, positionBufferMemory, allocator);
+        positionBufferMemory = VK_NULL_HANDLE;
+    }
+    if (indexBuffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device, indexBuffer, allocator);
+        indexBuffer = VK_NULL_HANDLE;
+    }
+    if (indexBufferMemory != VK_NULL_HANDLE) {
+        vkFreeMemory(device, indexBufferMemory, allocator);
+        indexBufferMemory = VK_NULL_HANDLE;
+    }
+}
+
+/**
+ * @brief Appends a mesh's vertices and indices to the shared buffers.
+ *
+ * Indices are stored unchanged; the returned vertexOffset is applied by the draw instead.
+ *
+ * @return Where the mesh lives in the shared buffers.
+ *
+ * @throws std::runtime_error if the mesh is empty or a buffer cannot be created.
+ */
+MeshRange GeometryBuffer::Upload(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
+    if (vertices.empty() || indices.empty()) {
+        throw std::runtime_error("Cannot upload an empty mesh to the geometry buffer.");
+    }
+
+    Reserve(vertexCount + static_cast<uint32_t>(vertices.size()), indexCount + static_cast<uint32_t>(indices.size()));
+
+    MeshRange range{};
+    range.firstIndex = indexCount;
+    range.indexCount = static_cast<uint32_t>(indices.size());
+    range.vertexOffset = static_cast<int32_t>(vertexCount);
+
+    std::vector<glm::vec3> positions(vertices.size());
+    std::transform(vertices.begin(), vertices.end(), positions.begin(), [](const Vertex& vertex) { return vertex.pos; });
+
+    UploadData(vertexBuffer, sizeof(Vertex) * vertexCount, vertices.data(), sizeof(Vertex) * vertices.size());
+    UploadData(positionBuffer, sizeof(glm::vec3) * vertexCount, positions.data(), sizeof(glm::vec3) * positions.size());
+    UploadData(indexBuffer, sizeof(uint32_t) * indexCount, indices.data(), sizeof(uint32_t) * indices.size());
+
+    vertexCount += static_cast<uint32_t>(vertices.size());
+    indexCount += static_cast<uint32_t>(indices.size());
+    return range;
+}
+void GeometryBuffer::Bind(VkCommandBuffer commandBuffer) const {
+    VkBuffer buffers[] = { vertexBuffer };
+    VkDeviceSize offsets[] = { 0 };
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+    vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+}
+/**
+ * @brief Binds the position stream to binding 0 in place of the full vertices, for Vertex::GetPositionBindingDescription.
+ */
+void GeometryBuffer::BindPositions(VkCommandBuffer commandBuffer) const {
+    VkBuffer buffers[] = { positionBuffer };
+    VkDeviceSize offsets[] = { 0 };
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+    vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+}
+
+uint32_t GeometryBuffer::GetVertexCount() const {
+    return vertexCount;
+}
+uint32_t GeometryBuffer::GetIndexCount() const {
+    return indexCount;
+}
+
+/**
+ * @brief Makes sure the buffers can hold the given totals, doubling their capacity as needed.
+ */
+void GeometryBuffer::Reserve(uint32_t requiredVertices, uint32_t requiredIndices) {
+    if (requiredVertices > vertexCapacity) {
+        uint32_t newCapacity = std::max({ requiredVertices, vertexCapacity * 2, INITIAL_VERTEX_CAPACITY });
+        GrowBuffer(vertexBuffer, vertexBufferMemory, sizeof(Vertex) * vertexCount, sizeof(Vertex) * newCapacity,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+        GrowBuffer(positionBuffer, positionBufferMemory, sizeof(glm::vec3) * vertexCount, sizeof(glm::vec3) * newCapacity,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+        vertexCapacity = newCapacity;
+
+        SetObjectName(device, (uint64_t)vertexBuffer, VK_OBJECT_TYPE_BUFFER, "Geometry : Vertex Buffer");
+        SetObjectName(device, (uint64_t)positionBuffer, VK_OBJECT_TYPE_BUFFER, "Geometry : Position Buffer");
+    }
+    if (requiredIndices > indexCapacity) {
+        uint32_t newCapacity = std::max({ requiredIndices, indexCapacity * 2, INITIAL_INDEX_CAPACITY });
+        GrowBuffer(indexBuffer, indexBufferMemory, sizeof(uint32_t) * indexCount, sizeof(uint32_t) * newCapacity,
+            VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+        indexCapacity = newCapacity;
+
+        SetObjectName(device, (uint64_t)indexBuffer, VK_OBJECT_TYPE_BUFFER, "Geometry : Index Buffer");
+    }
+}
+/**
+ * @brief Replaces a buffer with a larger one, copying the bytes already in use on the GPU.
+ *
+ * copyBuffer waits for the graphics queue to go idle, so no submitted frame can still be
+ * reading the old buffer when it is destroyed.
+ */
+void GeometryBuffer::GrowBuffer(VkBuffer& buffer, VkDeviceMemory& memory, VkDeviceSize usedSize, VkDeviceSize newSize, VkBufferUsageFlags usage) {
+    VkBuffer newBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory newMemory = VK_NULL_HANDLE;
+    createBuffer(
+        device, physicalDevice, newSize,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        newBuffer, newMemory, allocator
+    );
+
+    if (buffer != VK_NULL_HANDLE) {
+        if (usedSize > 0) {
+            copyBuffer(device, commandPool, graphicsQueue, buffer, newBuffer, usedSize);
+        }
+        vkDestroyBuffer(device, buffer, allocator);
+        vkFreeMemory(device, memory, allocator);
+    }
+
+    buffer = newBuffer;
+    memory = newMemory;
+}
+/**
+ * @brief Copies host data into a device-local buffer at the given offset through a staging buffer.
+ */
+void GeometryBuffer::UploadData(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size) {
+    VkBuffer stagingBuffer;
+    VkDeviceMemory stagingBufferMemory;
+    createBuffer(
+        device, physicalDevice, size,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        stagingBuffer, stagingBufferMemory, allocator
+    );
+
+    void* mapped;
+    vkMapMemory(device, stagingBufferMemory, 0, size, 0, &mapped);
+    memcpy(mapped, data, (size_t)size);
+    vkUnmapMemory(device, stagingBufferMemory);
+
+    copyBuffer(device, commandPool, graphicsQueue, stagingBuffer, dstBuffer, size, dstOffset);
+
+    vkDestroyBuffer(device, stagingBuffer, allocator);
+    vkFreeMemory(device, stagingBufferMemory, allocator);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Utilities.h"
+
+
+/**
+ * @file GeometryBuffer.h
+ * @brief Defines the GeometryBuffer class, a shared vertex and index buffer for every loaded mesh.
+ */
+
+/**
+ * @brief Location of one mesh inside the shared geometry buffer.
+ */
+struct MeshRange {
+    uint32_t firstIndex = 0;   ///< First index of the mesh in the shared index buffer.
+    uint32_t indexCount = 0;   ///< Number of indices in the mesh.
+    int32_t vertexOffset = 0;  ///< Added to each index to address the shared vertex buffer.
+};
+
+/**
+ * @class GeometryBuffer
+ * @brief Device-local vertex and index buffers that all meshes are sub-allocated from.
+ *
+ * Keeping every mesh in the same pair of buffers means the buffers are bound once per frame and
+ * draws differ only by firstIndex and vertexOffset, which is what lets a whole batch list be
+ * submitted with one vkCmdDrawIndexedIndirect. Space is handed out linearly and never reclaimed;
+ * the buffers are reallocated at twice the size when they run out.
+ *
+ * Every vertex's position is also kept in a tightly packed stream of its own. A depth-only pass
+ * binds it with BindPositions and fetches 12 bytes per vertex instead of a whole Vertex; it
+ * shares the index buffer and vertex numbering, so the same draws work with either binding.
+ */
+class GeometryBuffer {
+public:
+    GeometryBuffer(VkDevice device, VkPhysicalDevice physicalDevice, VkQueue graphicsQueue, VkCommandPool commandPool, const VkAllocationCallbacks* allocator);
+    ~GeometryBuffer();
+
+    GeometryBuffer(const GeometryBuffer&) = delete;
+    GeometryBuffer& operator=(const GeometryBuffer&) = delete;
+
+    MeshRange Upload(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+    void Bind(VkCommandBuffer commandBuffer) const;
+    void BindPositions(VkCommandBuffer commandBuffer) const;
+
+    uint32_t GetVertexCount() const;
+    uint32_t GetIndexCount() const;
+
+private:
+    static constexpr uint32_t INITIAL_VERTEX_CAPACITY = 64 * 1024;  ///< Vertices reserved on first upload.
+    static constexpr uint32_t INITIAL_INDEX_CAPACITY = 256 * 1024;  ///< Indices reserved on first upload.
+
+    // Vulkan handles
+    VkDevice device = VK_NULL_HANDLE;                 ///< Vulkan logical device handle.
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE; ///< Vulkan physical device handle.
+    VkQueue graphicsQueue = VK_NULL_HANDLE;           ///< Vulkan queue for transfer commands.
+    VkCommandPool commandPool = VK_NULL_HANDLE;       ///< Vulkan command pool for command buffers.
+    const VkAllocationCallbacks* allocator = nullptr; ///< Host allocation callbacks (nullptr for the driver default).
+
+    // Buffers
+    VkBuffer vertexBuffer = VK_NULL_HANDLE;             ///< Shared vertex buffer.
+    VkDeviceMemory vertexBufferMemory = VK_NULL_HANDLE; ///< Memory for the vertex buffer.
+    VkBuffer positionBuffer = VK_NULL_HANDLE;             ///< Position of every vertex, indexed like vertexBuffer.
+    VkDeviceMemory positionBufferMemory = VK_NULL_HANDLE; ///< Memory for the position buffer.
+    VkBuffer indexBuffer = VK_NULL_HANDLE;              ///< Shared index buffer.
+    VkDeviceMemory indexBufferMemory = VK_NULL_HANDLE;  ///< Memory for the index buffer.
+
+    // Allocation state
+    uint32_t vertexCount = 0;     ///< Vertices written so far.
+    uint32_t indexCount = 0;      ///< Indices written so far.
+    uint32_t vertexCapacity = 0;  ///< Vertices the vertex buffer can hold.
+    uint32_t indexCapacity = 0;   ///< Indices the index buffer can hold.
+
+    void Reserve(uint32_t requiredVertices, uint32_t requiredIndices);
+    void GrowBuffer(VkBuffer& buffer, VkDeviceMemory& memory, VkDeviceSize usedSize, VkDeviceSize newSize, VkBufferUsageFlags usage);
+    void UploadData(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size);
+};
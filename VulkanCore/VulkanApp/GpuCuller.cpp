@@ -0,0 +1,328 @@
+#include "GpuCuller.h"
+#include "ShaderReflection.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+GpuCuller::GpuCuller(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator, VkPipelineCache pipelineCache, std::span<const uint32_t> shaderCode, uint32_t frameCount, uint32_t maxRuns)
+    : device(device), physicalDevice(physicalDevice), allocator(allocator), frameCount(frameCount), maxRuns(maxRuns) {
+    CreateDescriptorSetLayout();
+    CreatePipeline(pipelineCache, shaderCode);
+    CreateDescriptorSets();
+
+    // The draw-count buffers do not depend on the scene size, so they are created once.
+    drawCountBuffers.resize(frameCount);
+    for (auto& frameBuffer : drawCountBuffers) {
+        CreateFrameBuffer(frameBuffer, sizeof(CountHeader) + sizeof(uint32_t) * maxRuns,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, true);
+        memset(frameBuffer.mapped, 0, sizeof(CountHeader) + sizeof(uint32_t) * maxRuns);
+    }
+}
+GpuCuller::~GpuCuller() {
+    DestroyBuffers();
+    for (auto& frameBuffer : drawCountBuffers) {
+        DestroyFrameBuffer(frameBuffer);
+    }
+
+    if (descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(device, descriptorPool, allocator);
+    }
+    if (pipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device, pipeline, allocator);
+    }
+    if (pipelineLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(device, pipelineLayout, allocator);
+    }
+    if (descriptorSetLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayout, allocator);
+    }
+}
+
+/**
+ * @brief Recreates the per-instance and per-draw buffers. The GPU must be idle.
+ *
+ * @param objectCapacity Instances each frame can cull.
+ * @param drawCapacity Draw commands each frame can compact.
+ */
+void GpuCuller::Resize(uint32_t objectCapacity, uint32_t drawCapacity) {
+    DestroyBuffers();
+
+    objectBuffers.resize(frameCount);
+    visibleInstanceBuffers.resize(frameCount);
+    compactedDrawBuffers.resize(frameCount);
+    for (uint32_t frame = 0; frame < frameCount; frame++) {
+        CreateFrameBuffer(objectBuffers[frame], sizeof(CullObject) * objectCapacity,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, true);
+        CreateFrameBuffer(visibleInstanceBuffers[frame], sizeof(uint32_t) * objectCapacity,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, false);
+        CreateFrameBuffer(compactedDrawBuffers[frame], sizeof(DrawCommand) * drawCapacity,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, false);
+    }
+
+    this->objectCapacity = objectCapacity;
+    this->drawCapacity = drawCapacity;
+}
+/**
+ * @brief Returns the counters from the frame's previous use and resets them for this one.
+ *
+ * Must be called after the frame's fence has signaled and before the frame is recorded.
+ */
+GpuCuller::Stats GpuCuller::BeginFrame(uint32_t frame) {
+    auto* header = static_cast<CountHeader*>(drawCountBuffers[frame].mapped);
+
+    Stats stats{};
+    stats.visibleObjects = header->visibleObjects;
+    stats.visibleDraws = header->visibleDraws;
+
+    memset(header, 0, sizeof(CountHeader) + sizeof(uint32_t) * maxRuns);
+    return stats;
+}
+CullObject* GpuCuller::GetObjects(uint32_t frame) const {
+    return static_cast<CullObject*>(objectBuffers[frame].mapped);
+}
+/**
+ * @brief Records both culling dispatches and the barrier between them.
+ *
+ * Must be recorded outside a render pass. The caller orders the results against the draws and the
+ * host readback; the renderer's render graph does so from the culling pass's declared writes.
+ *
+ * @param instanceBuffer Buffer holding the frame's InstanceData, one per instance.
+ * @param instanceOffset Start of the frame's instances within instanceBuffer.
+ * @param instanceRange Bytes of instance data starting at instanceOffset.
+ * @param drawBuffer DrawCommands written by the CPU, each with instanceCount set to its batch size and
+ *        the draws of a run contiguous and in run order.
+ * @param runCount Number of draw runs; every draw's runIndex is below it.
+ * @param cullingEnabled When false every instance is kept, which the direct draw path relies on.
+ */
+void GpuCuller::Record(VkCommandBuffer commandBuffer, uint32_t frame, VkBuffer instanceBuffer, VkDeviceSize instanceOffset, VkDeviceSize instanceRange,
+    VkBuffer drawBuffer, uint32_t objectCount, uint32_t drawCount, uint32_t runCount, const glm::mat4& viewProjection, bool cullingEnabled) {
+    if (objectCount > objectCapacity || drawCount > drawCapacity || runCount > maxRuns) {
+        throw std::runtime_error("GPU culling buffers are too small for the scene!");
+    }
+
+    UpdateDescriptorSet(frame, instanceBuffer, instanceOffset, instanceRange, drawBuffer);
+
+    CullParams params{};
+    params.frustumPlanes = Frustum::FromViewProjection(viewProjection).planes;
+    params.objectCount = objectCount;
+    params.drawCount = drawCount;
+    params.cullingEnabled = cullingEnabled ? 1 : 0;
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSets[frame], 0, nullptr);
+
+    // Pass 0: one workgroup per draw packs its visible instances.
+    params.pass = 0;
+    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullParams), &params);
+    Dispatch(commandBuffer, drawCount);
+
+    // Pass 1 reads the instance counts pass 0 accumulated.
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    // Pass 1: one workgroup per draw run packs its non-empty draws.
+    params.pass = 1;
+    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullParams), &params);
+    Dispatch(commandBuffer, runCount);
+}
+/**
+ * @brief Dispatches groupCount workgroups, spilling into y beyond the guaranteed x limit.
+ *
+ * cull.comp flattens the id back and skips the excess groups of the last row.
+ */
+void GpuCuller::Dispatch(VkCommandBuffer commandBuffer, uint32_t groupCount) {
+    if (groupCount == 0) {
+        return;
+    }
+    const uint32_t groupsX = std::min(groupCount, MAX_WORKGROUPS_PER_DIMENSION);
+    vkCmdDispatch(commandBuffer, groupsX, (groupCount + groupsX - 1) / groupsX, 1);
+}
+
+VkBuffer GpuCuller::GetVisibleInstanceBuffer(uint32_t frame) const {
+    return visibleInstanceBuffers[frame].buffer;
+}
+VkBuffer GpuCuller::GetCompactedDrawBuffer(uint32_t frame) const {
+    return compactedDrawBuffers[frame].buffer;
+}
+VkBuffer GpuCuller::GetDrawCountBuffer(uint32_t frame) const {
+    return drawCountBuffers[frame].buffer;
+}
+/**
+ * @brief Byte offset of a draw run's draw count, for vkCmdDrawIndexedIndirectCount.
+ */
+VkDeviceSize GpuCuller::GetDrawCountOffset(uint32_t runIndex) {
+    return sizeof(CountHeader) + sizeof(uint32_t) * runIndex;
+}
+
+void GpuCuller::CreateDescriptorSetLayout() {
+    // Bindings 0-5: instances, cull objects, draws, visible instances, compacted draws, counts.
+    std::array<VkDescriptorSetLayoutBinding, 6> bindings{};
+    for (uint32_t binding = 0; binding < bindings.size(); binding++) {
+        bindings[binding].binding = binding;
+        bindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[binding].descriptorCount = 1;
+        bindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, allocator, &descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create culling descriptor set layout!");
+    }
+}
+void GpuCuller::CreatePipeline(VkPipelineCache pipelineCache, std::span<const uint32_t> shaderCode) {
+    // The buffers and push constants are filled from the structs in GpuCuller.h, so check them against cull.comp.
+    ShaderReflection reflection = ShaderReflection::Reflect(shaderCode);
+    reflection.CheckBufferLayout(0, 1, 0, sizeof(CullObject));
+    reflection.CheckBufferLayout(0, 2, 0, sizeof(DrawCommand));
+    reflection.CheckBufferLayout(0, 4, 0, sizeof(DrawCommand));
+    reflection.CheckBufferLayout(0, 5, sizeof(CountHeader), sizeof(uint32_t));
+    if (reflection.pushConstants.size != sizeof(CullParams)) {
+        throw std::runtime_error("CullParams does not match the push constant block in cull.comp!");
+    }
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(CullParams);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, allocator, &pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create culling pipeline layout!");
+    }
+
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = shaderCode.size_bytes();
+    moduleInfo.pCode = shaderCode.data();
+
+    VkShaderModule shaderModule;
+    if (vkCreateShaderModule(device, &moduleInfo, allocator, &shaderModule) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create culling shader module!");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = pipelineLayout;
+
+    VkResult result = vkCreateComputePipelines(device, pipelineCache, 1, &pipelineInfo, allocator, &pipeline);
+    vkDestroyShaderModule(device, shaderModule, allocator);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create culling pipeline!");
+    }
+}
+void GpuCuller::CreateDescriptorSets() {
+    VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 6 * frameCount };
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = frameCount;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, allocator, &descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create culling descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(frameCount, descriptorSetLayout);
+    descriptorSets.resize(frameCount);
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = descriptorPool;
+    allocInfo.descriptorSetCount = frameCount;
+    allocInfo.pSetLayouts = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate culling descriptor sets!");
+    }
+}
+void GpuCuller::CreateFrameBuffer(FrameBuffer& frameBuffer, VkDeviceSize size, VkBufferUsageFlags usage, bool hostVisible) {
+    VkMemoryPropertyFlags properties = hostVisible
+        ? VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    createBuffer(device, physicalDevice, std::max<VkDeviceSize>(size, 16), usage, properties,
+        frameBuffer.buffer, frameBuffer.memory, allocator);
+
+    if (hostVisible) {
+        vkMapMemory(device, frameBuffer.memory, 0, VK_WHOLE_SIZE, 0, &frameBuffer.mapped);
+    }
+}
+void GpuCuller::DestroyFrameBuffer(FrameBuffer& frameBuffer) {
+    if (frameBuffer.buffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device, frameBuffer.buffer, allocator);
+    }
+    if (frameBuffer.memory != VK_NULL_HANDLE) {
+        if (frameBuffer.mapped) {
+            vkUnmapMemory(device, frameBuffer.memory);
+        }
+        vkFreeMemory(device, frameBuffer.memory, allocator);
+    }
+    frameBuffer = FrameBuffer{};
+}
+void GpuCuller::DestroyBuffers() {
+    for (auto* buffers : { &objectBuffers, &visibleInstanceBuffers, &compactedDrawBuffers }) {
+        for (auto& frameBuffer : *buffers) {
+            DestroyFrameBuffer(frameBuffer);
+        }
+        buffers->clear();
+    }
+    objectCapacity = 0;
+    drawCapacity = 0;
+}
+/**
+ * @brief Points the frame's descriptor set at this frame's buffers.
+ *
+ * The renderer's instance and draw buffers can be reallocated as the scene grows, and the instances
+ * are a slice of a shared ring buffer, so the set is rewritten each time the frame is recorded.
+ * The frame's fence guarantees it is no longer in use.
+ */
+void GpuCuller::UpdateDescriptorSet(uint32_t frame, VkBuffer instanceBuffer, VkDeviceSize instanceOffset, VkDeviceSize instanceRange, VkBuffer drawBuffer) {
+    std::array<VkBuffer, 6> buffers = {
+        instanceBuffer,
+        objectBuffers[frame].buffer,
+        drawBuffer,
+        visibleInstanceBuffers[frame].buffer,
+        compactedDrawBuffers[frame].buffer,
+        drawCountBuffers[frame].buffer
+    };
+
+    std::array<VkDescriptorBufferInfo, 6> bufferInfos{};
+    std::array<VkWriteDescriptorSet, 6> descriptorWrites{};
+    for (uint32_t binding = 0; binding < buffers.size(); binding++) {
+        bufferInfos[binding].buffer = buffers[binding];
+        bufferInfos[binding].offset = 0;
+        bufferInfos[binding].range = VK_WHOLE_SIZE;
+
+        descriptorWrites[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[binding].dstSet = descriptorSets[frame];
+        descriptorWrites[binding].dstBinding = binding;
+        descriptorWrites[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorWrites[binding].descriptorCount = 1;
+        descriptorWrites[binding].pBufferInfo = &bufferInfos[binding];
+    }
+    // The instances are only the frame's slice of the renderer's ring buffer.
+    bufferInfos[0].offset = instanceOffset;
+    bufferInfos[0].range = instanceRange;
+
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "FrustumCuller.h"
+
+#include <span>
+
+
+/**
+ * @file GpuCuller.h
+ * @brief Defines the GpuCuller class, a compute pre-pass that frustum culls instances and builds indirect draws.
+ */
+
+/**
+ * @brief Indirect draw command with the extra per-draw data the culling shader needs.
+ *
+ * Layout matches `DrawCommand` in cull.comp. Used as the stride for every indirect draw.
+ */
+struct DrawCommand {
+    VkDrawIndexedIndirectCommand command; ///< Draw parameters; instanceCount is filled in by the GPU.
+    uint32_t runIndex = 0;                ///< Draw run the draw belongs to (indexes the draw-count array).
+    uint32_t runFirstDraw = 0;            ///< First compacted slot reserved for the run.
+    uint32_t padding = 0;
+};
+
+/**
+ * @brief Per-instance culling input. Layout matches `CullObject` in cull.comp.
+ */
+struct CullObject {
+    glm::vec4 boundingSphere; ///< Mesh-space center (xyz) and radius (w).
+    uint32_t drawIndex;       ///< DrawCommand the instance is drawn by.
+    uint32_t padding[3];
+};
+
+/**
+ * @class GpuCuller
+ * @brief Tests every instance against the view frustum on the GPU and compacts the survivors.
+ *
+ * The first dispatch runs one workgroup per draw. It tests the draw's instances a workgroup at a
+ * time and packs the visible ones into the draw's range of the visible-instance buffer, then
+ * replaces the draw's instanceCount with the number kept. The second dispatch runs one workgroup
+ * per draw run. It packs the run's non-empty draws into its range of the compacted buffer and
+ * stores their count, so vkCmdDrawIndexedIndirectCount draws only the survivors.
+ *
+ * Both passes compact with a prefix sum rather than atomics, so the output keeps the input order:
+ * instances stay in the order the CPU sorted them within their draw, and draws within their run.
+ * With culling disabled the visible-instance buffer is the identity mapping.
+ * The counters also feed the debug overlay; they are read back once the frame's fence has signaled.
+ */
+class GpuCuller {
+public:
+    /**
+     * @brief Visibility counters written by the culling pass.
+     */
+    struct Stats {
+        uint32_t visibleObjects = 0; ///< Instances that passed the frustum test.
+        uint32_t visibleDraws = 0;   ///< Draws with at least one visible instance.
+    };
+
+    GpuCuller(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator, VkPipelineCache pipelineCache, std::span<const uint32_t> shaderCode, uint32_t frameCount, uint32_t maxRuns);
+    ~GpuCuller();
+
+    GpuCuller(const GpuCuller&) = delete;
+    GpuCuller& operator=(const GpuCuller&) = delete;
+
+    void Resize(uint32_t objectCapacity, uint32_t drawCapacity);
+    Stats BeginFrame(uint32_t frame);
+    CullObject* GetObjects(uint32_t frame) const;
+    void Record(VkCommandBuffer commandBuffer, uint32_t frame, VkBuffer instanceBuffer, VkDeviceSize instanceOffset, VkDeviceSize instanceRange,
+        VkBuffer drawBuffer, uint32_t objectCount, uint32_t drawCount, uint32_t runCount, const glm::mat4& viewProjection, bool cullingEnabled);
+
+    VkBuffer GetVisibleInstanceBuffer(uint32_t frame) const;
+    VkBuffer GetCompactedDrawBuffer(uint32_t frame) const;
+    VkBuffer GetDrawCountBuffer(uint32_t frame) const;
+    static VkDeviceSize GetDrawCountOffset(uint32_t runIndex);
+
+private:
+    static constexpr uint32_t WORKGROUP_SIZE = 64;            ///< Matches local_size_x in cull.comp.
+    static constexpr uint32_t MAX_WORKGROUPS_PER_DIMENSION = 65535; ///< Guaranteed maxComputeWorkGroupCount.
+
+    /**
+     * @brief Push constants for cull.comp. The same pipeline runs both passes.
+     */
+    struct CullParams {
+        std::array<glm::vec4, 6> frustumPlanes; ///< Normalized planes, inside where dot(n, p) + d >= 0.
+        uint32_t objectCount;
+        uint32_t drawCount;
+        uint32_t cullingEnabled;                ///< 0 marks every instance visible.
+        uint32_t pass;                          ///< 0 = cull instances, 1 = compact draws.
+    };
+
+    /**
+     * @brief Header of the draw-count buffer, followed by one draw count per draw run.
+     */
+    struct CountHeader {
+        uint32_t visibleObjects;
+        uint32_t visibleDraws;
+        uint32_t padding[2];
+    };
+
+    /**
+     * @brief A buffer with its memory and, if host-visible, its persistent mapping.
+     */
+    struct FrameBuffer {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        void* mapped = nullptr;
+    };
+
+    // Vulkan handles
+    VkDevice device = VK_NULL_HANDLE;                 ///< Vulkan logical device handle.
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE; ///< Vulkan physical device handle.
+    const VkAllocationCallbacks* allocator = nullptr; ///< Host allocation callbacks (nullptr for the driver default).
+    uint32_t frameCount = 0;                          ///< Number of per-frame buffer sets.
+    uint32_t maxRuns = 0;                             ///< Draw runs the draw-count buffer has room for.
+
+    // Pipeline
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> descriptorSets;      ///< One per frame, rewritten when the frame is recorded.
+
+    // Per-frame buffers
+    std::vector<FrameBuffer> objectBuffers;           ///< CullObject per instance (host-visible).
+    std::vector<FrameBuffer> visibleInstanceBuffers;  ///< Compacted instance indices read by the vertex shader.
+    std::vector<FrameBuffer> compactedDrawBuffers;    ///< Surviving DrawCommands, grouped by draw run.
+    std::vector<FrameBuffer> drawCountBuffers;        ///< CountHeader + draw count per run (host-visible).
+    uint32_t objectCapacity = 0;
+    uint32_t drawCapacity = 0;
+
+    void CreateDescriptorSetLayout();
+    void CreatePipeline(VkPipelineCache pipelineCache, std::span<const uint32_t> shaderCode);
+    void CreateDescriptorSets();
+    void CreateFrameBuffer(FrameBuffer& frameBuffer, VkDeviceSize size, VkBufferUsageFlags usage, bool hostVisible);
+    void DestroyFrameBuffer(FrameBuffer& frameBuffer);
+    void DestroyBuffers();
+    static void Dispatch(VkCommandBuffer commandBuffer, uint32_t groupCount);
+    void UpdateDescriptorSet(uint32_t frame, VkBuffer instanceBuffer, VkDeviceSize instanceOffset, VkDeviceSize instanceRange, VkBuffer drawBuffer);
+};
@@ -0,0 +1,107 @@
+#include "GpuTimer.h"
+
+#include <algorithm>
+
+
+/**
+ * @param device Logical device the query pool is created on.
+ * @param physicalDevice Physical device whose timestamp period and queue support are used.
+ * @param allocator Host allocation callbacks (nullptr for the driver default).
+ * @param queueFamilyIndex Queue family the timed command buffers are submitted to.
+ * @param frameCount Frames in flight, each with its own queries.
+ * @param timestampCount Timestamps each frame can write.
+ * @throws std::runtime_error if the query pool cannot be created.
+ */
+GpuTimer::GpuTimer(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator, uint32_t queueFamilyIndex, uint32_t frameCount, uint32_t timestampCount)
+    : device(device), allocator(allocator), frameCount(frameCount), timestampCount(timestampCount) {
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+    const uint32_t validBits = queueFamilies[queueFamilyIndex].timestampValidBits;
+    if (validBits == 0) {
+        return;
+    }
+    validMask = validBits >= 64 ? UINT64_MAX : (uint64_t(1) << validBits) - 1;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    nanosecondsPerTick = properties.limits.timestampPeriod;
+
+    VkQueryPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = frameCount * timestampCount;
+
+    if (vkCreateQueryPool(device, &poolInfo, allocator, &queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create timestamp query pool!");
+    }
+    SetObjectName(device, (uint64_t)queryPool, VK_OBJECT_TYPE_QUERY_POOL, "GPU Timer : Timestamps");
+
+    results.resize(poolInfo.queryCount);
+    frameReset.resize(frameCount, false);
+}
+GpuTimer::~GpuTimer() {
+    if (queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(device, queryPool, allocator);
+    }
+}
+
+bool GpuTimer::IsSupported() const {
+    return queryPool != VK_NULL_HANDLE;
+}
+/**
+ * @brief Reads the frame's previous timestamps and records the reset of its queries.
+ *
+ * Must be called after the frame's fence has signaled, outside a render pass and before any
+ * WriteTimestamp for the frame.
+ */
+void GpuTimer::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frame) {
+    if (queryPool == VK_NULL_HANDLE) {
+        return;
+    }
+
+    const uint32_t firstQuery = frame * timestampCount;
+    QueryResult* frameResults = results.data() + firstQuery;
+    if (frameReset[frame]) {
+        // Without VK_QUERY_RESULT_WAIT_BIT a timestamp the frame never wrote is reported as unavailable.
+        vkGetQueryPoolResults(device, queryPool, firstQuery, timestampCount, sizeof(QueryResult) * timestampCount, frameResults,
+            sizeof(QueryResult), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    }
+    else {
+        std::fill(frameResults, frameResults + timestampCount, QueryResult{});
+    }
+
+    vkCmdResetQueryPool(commandBuffer, queryPool, firstQuery, timestampCount);
+    frameReset[frame] = true;
+}
+/**
+ * @brief Records a timestamp, taken once every earlier command has reached stage.
+ *
+ * Valid inside a render pass and in secondary command buffers, as long as it is executed in the
+ * frame it was recorded for.
+ */
+void GpuTimer::WriteTimestamp(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t timestamp, VkPipelineStageFlagBits stage) const {
+    if (queryPool == VK_NULL_HANDLE) {
+        return;
+    }
+    vkCmdWriteTimestamp(commandBuffer, stage, queryPool, frame * timestampCount + timestamp);
+}
+/**
+ * @brief Milliseconds between two timestamps of the frame's last completed use.
+ *
+ * @return Nothing if either timestamp was not written.
+ */
+std::optional<double> GpuTimer::GetElapsedMs(uint32_t frame, uint32_t beginTimestamp, uint32_t endTimestamp) const {
+    if (queryPool == VK_NULL_HANDLE) {
+        return std::nullopt;
+    }
+
+    const QueryResult& begin = results[frame * timestampCount + beginTimestamp];
+    const QueryResult& end = results[frame * timestampCount + endTimestamp];
+    if (!begin.available || !end.available) {
+        return std::nullopt;
+    }
+    const uint64_t ticks = ((end.value & validMask) - (begin.value & validMask)) & validMask;
+    return ticks * nanosecondsPerTick / 1.0e6;
+}
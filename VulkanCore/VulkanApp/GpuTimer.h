@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Utilities.h"
+
+#include <optional>
+
+
+/**
+ * @file GpuTimer.h
+ * @brief Defines the GpuTimer class, which measures GPU time between points of a frame with timestamp queries.
+ */
+
+/**
+ * @class GpuTimer
+ * @brief Timestamp queries for each frame in flight, read back once the frame's fence has signaled.
+ *
+ * Every frame owns timestampCount consecutive queries of one query pool. BeginFrame reads the
+ * results of the frame's previous use and records the reset of its queries, so a frame's
+ * timings arrive one round trip later without ever waiting on the GPU. A timestamp the frame did
+ * not write reads back as unavailable, so callers can record some timestamps only conditionally
+ * and tell from the results which ones a frame took.
+ *
+ * When the graphics queue has no timestamp support the timer records nothing and every
+ * measurement is empty.
+ */
+class GpuTimer {
+public:
+    GpuTimer(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator, uint32_t queueFamilyIndex, uint32_t frameCount, uint32_t timestampCount);
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    bool IsSupported() const;
+    void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frame);
+    void WriteTimestamp(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t timestamp, VkPipelineStageFlagBits stage) const;
+    std::optional<double> GetElapsedMs(uint32_t frame, uint32_t beginTimestamp, uint32_t endTimestamp) const;
+
+private:
+    /**
+     * @brief One query's result as written with VK_QUERY_RESULT_WITH_AVAILABILITY_BIT.
+     */
+    struct QueryResult {
+        uint64_t value = 0;
+        uint64_t available = 0;
+    };
+
+    // Vulkan handles
+    VkDevice device = VK_NULL_HANDLE;                 ///< Vulkan logical device handle.
+    const VkAllocationCallbacks* allocator = nullptr; ///< Host allocation callbacks (nullptr for the driver default).
+    VkQueryPool queryPool = VK_NULL_HANDLE;           ///< frameCount * timestampCount timestamp queries.
+
+    uint32_t frameCount = 0;
+    uint32_t timestampCount = 0;     ///< Queries per frame.
+    double nanosecondsPerTick = 0.0; ///< VkPhysicalDeviceLimits::timestampPeriod.
+    uint64_t validMask = 0;          ///< Bits of a timestamp the queue actually writes.
+    std::vector<QueryResult> results;  ///< Last read results, timestampCount per frame.
+    std::vector<bool> frameReset;      ///< A frame's queries have been reset at least once and may be read.
+};
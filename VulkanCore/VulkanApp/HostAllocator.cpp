@@ -0,0 +1,294 @@
+#include "HostAllocator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <new>
+
+
+HostAllocator::HostAllocator() {
+    // Size classes double from MIN_CLASS_SIZE, so the largest pooled block is MIN_CLASS_SIZE << (CLASS_COUNT - 1).
+    for (size_t i = 0; i < CLASS_COUNT; i++) {
+        sizeClasses[i].blockSize = MIN_CLASS_SIZE << i;
+    }
+
+    callbacks.pUserData = this;
+    callbacks.pfnAllocation = AllocationCallback;
+    callbacks.pfnReallocation = ReallocationCallback;
+    callbacks.pfnFree = FreeCallback;
+    callbacks.pfnInternalAllocation = InternalAllocationCallback;
+    callbacks.pfnInternalFree = InternalFreeCallback;
+}
+HostAllocator::~HostAllocator() {
+    // Anything still live here was leaked by an object that outlived the device or instance.
+    if (totalStats.liveAllocations != 0) {
+        std::cerr << "HostAllocator: " << totalStats.liveAllocations << " allocation(s) ("
+            << totalStats.currentBytes << " bytes) still live at shutdown\n";
+    }
+
+    for (auto& sizeClass : sizeClasses) {
+        for (void* chunk : sizeClass.chunks) {
+            ::operator delete(chunk, std::align_val_t(BLOCK_ALIGNMENT));
+        }
+        sizeClass.chunks.clear();
+        sizeClass.freeList = nullptr;
+    }
+}
+
+const VkAllocationCallbacks* HostAllocator::GetCallbacks() const {
+    return &callbacks;
+}
+
+HostAllocator::ScopeStats HostAllocator::GetScopeStats(VkSystemAllocationScope scope) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return scopeStats[static_cast<size_t>(scope)];
+}
+HostAllocator::ScopeStats HostAllocator::GetTotalStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return totalStats;
+}
+HostAllocator::PoolStats HostAllocator::GetPoolStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return poolStats;
+}
+size_t HostAllocator::GetInternalBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return internalBytes;
+}
+
+const char* HostAllocator::GetScopeName(VkSystemAllocationScope scope) {
+    switch (scope) {
+    case VK_SYSTEM_ALLOCATION_SCOPE_COMMAND:  return "Command";
+    case VK_SYSTEM_ALLOCATION_SCOPE_OBJECT:   return "Object";
+    case VK_SYSTEM_ALLOCATION_SCOPE_CACHE:    return "Cache";
+    case VK_SYSTEM_ALLOCATION_SCOPE_DEVICE:   return "Device";
+    case VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE: return "Instance";
+    default:                                  return "Unknown";
+    }
+}
+/**
+ * @brief Writes a per-scope usage table and the pool reservation summary.
+ *
+ * @param out Stream to write the report to.
+ */
+void HostAllocator::PrintStats(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    out << "Host allocator statistics:\n";
+    out << std::left << std::setw(10) << "Scope" << std::right
+        << std::setw(14) << "Current (B)" << std::setw(14) << "Peak (B)"
+        << std::setw(10) << "Live" << std::setw(12) << "Total" << "\n";
+    for (size_t i = 0; i < SCOPE_COUNT; i++) {
+        const ScopeStats& stats = scopeStats[i];
+        out << std::left << std::setw(10) << GetScopeName(static_cast<VkSystemAllocationScope>(i)) << std::right
+            << std::setw(14) << stats.currentBytes << std::setw(14) << stats.peakBytes
+            << std::setw(10) << stats.liveAllocations << std::setw(12) << stats.totalAllocations << "\n";
+    }
+    out << std::left << std::setw(10) << "All" << std::right
+        << std::setw(14) << totalStats.currentBytes << std::setw(14) << totalStats.peakBytes
+        << std::setw(10) << totalStats.liveAllocations << std::setw(12) << totalStats.totalAllocations << "\n";
+    out << "Pools: " << poolStats.usedBytes << " / " << poolStats.reservedBytes << " bytes in use across "
+        << poolStats.chunkCount << " chunk(s), " << poolStats.largeBytes << " bytes in large allocations, "
+        << internalBytes << " bytes driver-internal\n";
+}
+
+/**
+ * @brief Serves a driver allocation from the size-class pools or, if too large, from malloc.
+ *
+ * The header is placed directly in front of the returned pointer so Free and Reallocate can
+ * recover the block, size class and scope without a lookup.
+ *
+ * @return Pointer aligned to `alignment`, or nullptr if the allocation could not be satisfied.
+ */
+void* HostAllocator::Allocate(size_t size, size_t alignment, VkSystemAllocationScope scope) {
+    if (size == 0) {
+        return nullptr;
+    }
+    alignment = std::max(alignment, alignof(AllocationHeader));
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Blocks start on BLOCK_ALIGNMENT and the header size is a multiple of it, so only
+    // stricter alignments need extra padding inside a pooled block.
+    size_t pooledSize = sizeof(AllocationHeader) + size + (alignment > BLOCK_ALIGNMENT ? alignment - BLOCK_ALIGNMENT : 0);
+
+    uint32_t sizeClass = LARGE_CLASS;
+    for (uint32_t i = 0; i < CLASS_COUNT; i++) {
+        if (pooledSize <= sizeClasses[i].blockSize) {
+            sizeClass = i;
+            break;
+        }
+    }
+
+    void* block = nullptr;
+    size_t blockSize = 0;
+    if (sizeClass != LARGE_CLASS) {
+        block = AcquireBlock(sizeClass);
+        blockSize = sizeClasses[sizeClass].blockSize;
+    }
+    else {
+        // malloc only guarantees fundamental alignment, so reserve the worst-case padding.
+        blockSize = sizeof(AllocationHeader) + size + alignment - 1;
+        block = std::malloc(blockSize);
+        if (block) {
+            poolStats.largeBytes += blockSize;
+        }
+    }
+    if (!block) {
+        return nullptr;
+    }
+
+    uintptr_t user = (reinterpret_cast<uintptr_t>(block) + sizeof(AllocationHeader) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+    AllocationHeader* header = reinterpret_cast<AllocationHeader*>(user - sizeof(AllocationHeader));
+    header->block = block;
+    header->size = size;
+    header->capacity = reinterpret_cast<uintptr_t>(block) + blockSize - user;
+    header->sizeClass = sizeClass;
+    header->scope = static_cast<uint32_t>(scope);
+
+    RecordAllocation(header->scope, size);
+    return reinterpret_cast<void*>(user);
+}
+/**
+ * @brief Resizes a driver allocation, growing in place when the current block has room.
+ *
+ * Follows the Vulkan rules: a null original behaves like Allocate, a zero size behaves like Free,
+ * and on failure the original allocation is left untouched.
+ */
+void* HostAllocator::Reallocate(void* original, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+    if (!original) {
+        return Allocate(size, alignment, scope);
+    }
+    if (size == 0) {
+        Free(original);
+        return nullptr;
+    }
+
+    AllocationHeader* header = GetHeader(original);
+    size_t oldSize = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        oldSize = header->size;
+
+        // Reuse the block if it is large enough and the pointer already meets the alignment.
+        if (size <= header->capacity && (reinterpret_cast<uintptr_t>(original) & (alignment - 1)) == 0) {
+            RecordFree(header->scope, header->size);
+            header->size = size;
+            header->scope = static_cast<uint32_t>(scope);
+            RecordAllocation(header->scope, size);
+            return original;
+        }
+    }
+
+    void* memory = Allocate(size, alignment, scope);
+    if (!memory) {
+        return nullptr;
+    }
+    memcpy(memory, original, std::min(oldSize, size));
+    Free(original);
+    return memory;
+}
+/**
+ * @brief Returns a driver allocation to its pool, or to the system heap for large allocations.
+ */
+void HostAllocator::Free(void* memory) {
+    if (!memory) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    AllocationHeader* header = GetHeader(memory);
+    RecordFree(header->scope, header->size);
+
+    if (header->sizeClass == LARGE_CLASS) {
+        poolStats.largeBytes -= reinterpret_cast<uintptr_t>(memory) + header->capacity - reinterpret_cast<uintptr_t>(header->block);
+        std::free(header->block);
+    }
+    else {
+        ReleaseBlock(header->sizeClass, header->block);
+    }
+}
+
+/**
+ * @brief Pops a block from a size class, reserving and splitting a new chunk if the free list is empty.
+ *
+ * Must be called with the mutex held.
+ */
+void* HostAllocator::AcquireBlock(uint32_t sizeClass) {
+    SizeClass& pool = sizeClasses[sizeClass];
+
+    if (!pool.freeList) {
+        void* chunk = ::operator new(CHUNK_SIZE, std::align_val_t(BLOCK_ALIGNMENT), std::nothrow);
+        if (!chunk) {
+            return nullptr;
+        }
+        pool.chunks.push_back(chunk);
+        poolStats.reservedBytes += CHUNK_SIZE;
+        poolStats.chunkCount++;
+
+        // Thread the new blocks onto the free list, lowest address first.
+        char* base = static_cast<char*>(chunk);
+        size_t blockCount = CHUNK_SIZE / pool.blockSize;
+        for (size_t i = blockCount; i-- > 0;) {
+            void* block = base + i * pool.blockSize;
+            *static_cast<void**>(block) = pool.freeList;
+            pool.freeList = block;
+        }
+    }
+
+    void* block = pool.freeList;
+    pool.freeList = *static_cast<void**>(block);
+    poolStats.usedBytes += pool.blockSize;
+    return block;
+}
+/**
+ * @brief Pushes a block back onto its size class free list. Must be called with the mutex held.
+ */
+void HostAllocator::ReleaseBlock(uint32_t sizeClass, void* block) {
+    SizeClass& pool = sizeClasses[sizeClass];
+    *static_cast<void**>(block) = pool.freeList;
+    pool.freeList = block;
+    poolStats.usedBytes -= pool.blockSize;
+}
+
+void HostAllocator::RecordAllocation(uint32_t scope, size_t size) {
+    for (ScopeStats* stats : { &scopeStats[scope], &totalStats }) {
+        stats->currentBytes += size;
+        stats->peakBytes = std::max(stats->peakBytes, stats->currentBytes);
+        stats->liveAllocations++;
+        stats->totalAllocations++;
+    }
+}
+void HostAllocator::RecordFree(uint32_t scope, size_t size) {
+    for (ScopeStats* stats : { &scopeStats[scope], &totalStats }) {
+        stats->currentBytes -= size;
+        stats->liveAllocations--;
+    }
+}
+HostAllocator::AllocationHeader* HostAllocator::GetHeader(void* memory) {
+    return reinterpret_cast<AllocationHeader*>(static_cast<char*>(memory) - sizeof(AllocationHeader));
+}
+
+
+// Static trampolines: Vulkan passes the HostAllocator back through pUserData.
+void* HostAllocator::AllocationCallback(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+    return static_cast<HostAllocator*>(userData)->Allocate(size, alignment, scope);
+}
+void* HostAllocator::ReallocationCallback(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+    return static_cast<HostAllocator*>(userData)->Reallocate(original, size, alignment, scope);
+}
+void HostAllocator::FreeCallback(void* userData, void* memory) {
+    static_cast<HostAllocator*>(userData)->Free(memory);
+}
+void HostAllocator::InternalAllocationCallback(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope) {
+    auto* allocator = static_cast<HostAllocator*>(userData);
+    std::lock_guard<std::mutex> lock(allocator->mutex);
+    allocator->internalBytes += size;
+}
+void HostAllocator::InternalFreeCallback(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope) {
+    auto* allocator = static_cast<HostAllocator*>(userData);
+    std::lock_guard<std::mutex> lock(allocator->mutex);
+    allocator->internalBytes -= size;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Utilities.h"
+
+#include <array>
+#include <mutex>
+
+
+/**
+ * @file HostAllocator.h
+ * @brief Defines a pooled, tracking implementation of VkAllocationCallbacks for driver host allocations.
+ */
+
+/**
+ * @class HostAllocator
+ * @brief Routes Vulkan host allocations through size-class pools and records per-scope statistics.
+ *
+ * Small requests are served from fixed-size blocks carved out of larger chunks and recycled through
+ * per-class free lists, so short-lived command-scope allocations do not hit the system heap. Requests
+ * larger than the biggest size class fall through to malloc. Every allocation is tagged with its
+ * VkSystemAllocationScope so current, peak and total usage can be reported per scope.
+ */
+class HostAllocator {
+public:
+    static constexpr size_t SCOPE_COUNT = 5; ///< Number of VkSystemAllocationScope values (command .. instance).
+
+    /**
+     * @brief Usage counters for a single allocation scope.
+     */
+    struct ScopeStats {
+        size_t currentBytes = 0;      ///< Bytes currently handed out to the driver.
+        size_t peakBytes = 0;         ///< High-water mark of currentBytes.
+        uint64_t liveAllocations = 0; ///< Allocations not yet freed.
+        uint64_t totalAllocations = 0;///< Allocations made since creation (reallocations included).
+    };
+
+    /**
+     * @brief Reservation counters for the size-class pools.
+     */
+    struct PoolStats {
+        size_t reservedBytes = 0;  ///< Bytes held in pool chunks.
+        size_t usedBytes = 0;      ///< Bytes of pool blocks currently handed out.
+        size_t largeBytes = 0;     ///< Bytes in allocations too large for the pools.
+        uint64_t chunkCount = 0;   ///< Number of chunks reserved by the pools.
+    };
+
+    HostAllocator();
+    ~HostAllocator();
+
+    HostAllocator(const HostAllocator&) = delete;
+    HostAllocator& operator=(const HostAllocator&) = delete;
+
+    const VkAllocationCallbacks* GetCallbacks() const;
+
+    ScopeStats GetScopeStats(VkSystemAllocationScope scope) const;
+    ScopeStats GetTotalStats() const;
+    PoolStats GetPoolStats() const;
+    size_t GetInternalBytes() const;
+
+    static const char* GetScopeName(VkSystemAllocationScope scope);
+    void PrintStats(std::ostream& out) const;
+
+private:
+    static constexpr size_t CLASS_COUNT = 9;             ///< Size classes from 64 B to 16 KiB.
+    static constexpr size_t MIN_CLASS_SIZE = 64;         ///< Smallest block size in bytes.
+    static constexpr size_t CHUNK_SIZE = 256 * 1024;     ///< Bytes reserved per pool chunk.
+    static constexpr size_t BLOCK_ALIGNMENT = 16;        ///< Alignment of every block start.
+    static constexpr uint32_t LARGE_CLASS = 0xFFFFFFFFu; ///< Size class tag for malloc-backed allocations.
+
+    /**
+     * @brief Bookkeeping stored immediately in front of every pointer returned to the driver.
+     */
+    struct AllocationHeader {
+        void* block;        ///< Start of the underlying pool block or malloc allocation.
+        size_t size;        ///< Size requested by the driver.
+        size_t capacity;    ///< Usable bytes from the returned pointer to the end of the block.
+        uint32_t sizeClass; ///< Pool index, or LARGE_CLASS.
+        uint32_t scope;     ///< VkSystemAllocationScope the allocation was made with.
+    };
+
+    /**
+     * @brief Free list and chunk storage for one block size.
+     */
+    struct SizeClass {
+        size_t blockSize = 0;         ///< Bytes per block.
+        void* freeList = nullptr;     ///< Intrusive singly linked list of free blocks.
+        std::vector<void*> chunks;    ///< Chunks owned by this class.
+    };
+
+    VkAllocationCallbacks callbacks{};                 ///< Callbacks handed to Vulkan.
+    mutable std::mutex mutex;                          ///< Guards pools and statistics.
+    std::array<SizeClass, CLASS_COUNT> sizeClasses;    ///< Pools ordered by block size.
+    std::array<ScopeStats, SCOPE_COUNT> scopeStats;    ///< Counters indexed by VkSystemAllocationScope.
+    ScopeStats totalStats;                             ///< Counters across all scopes.
+    PoolStats poolStats;                               ///< Pool reservation counters.
+    size_t internalBytes = 0;                          ///< Driver-internal allocations reported via notifications.
+
+    void* Allocate(size_t size, size_t alignment, VkSystemAllocationScope scope);
+    void* Reallocate(void* original, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    void Free(void* memory);
+
+    void* AcquireBlock(uint32_t sizeClass);
+    void ReleaseBlock(uint32_t sizeClass, void* block);
+    void RecordAllocation(uint32_t scope, size_t size);
+    void RecordFree(uint32_t scope, size_t size);
+    static AllocationHeader* GetHeader(void* memory);
+
+    static VKAPI_ATTR void* VKAPI_CALL AllocationCallback(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    static VKAPI_ATTR void* VKAPI_CALL ReallocationCallback(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    static VKAPI_ATTR void VKAPI_CALL FreeCallback(void* userData, void* memory);
+    static VKAPI_ATTR void VKAPI_CALL InternalAllocationCallback(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+    static VKAPI_ATTR void VKAPI_CALL InternalFreeCallback(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+};
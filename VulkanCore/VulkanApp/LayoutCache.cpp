@@ -0,0 +1,172 @@
+#include "LayoutCache.h"
+
+#include <algorithm>
+
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+void HashBytes(uint64_t& hash, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+}
+
+template <typename T>
+void HashValue(uint64_t& hash, const T& value) {
+    HashBytes(hash, &value, sizeof(value));
+}
+
+} // namespace
+
+VkDescriptorSetLayoutBinding* DescriptorSetLayoutDesc::FindBinding(uint32_t binding) {
+    for (VkDescriptorSetLayoutBinding& candidate : bindings) {
+        if (candidate.binding == binding) {
+            return &candidate;
+        }
+    }
+    return nullptr;
+}
+void DescriptorSetLayoutDesc::SetBindingFlags(uint32_t binding, VkDescriptorBindingFlags bindingFlag) {
+    bindingFlags.resize(bindings.size(), 0);
+    for (size_t i = 0; i < bindings.size(); i++) {
+        if (bindings[i].binding == binding) {
+            bindingFlags[i] = bindingFlag;
+        }
+    }
+}
+bool DescriptorSetLayoutDesc::operator==(const DescriptorSetLayoutDesc& other) const {
+    auto sameBinding = [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+        return a.binding == b.binding && a.descriptorType == b.descriptorType && a.descriptorCount == b.descriptorCount
+            && a.stageFlags == b.stageFlags;
+    };
+    return flags == other.flags && bindingFlags == other.bindingFlags
+        && std::equal(bindings.begin(), bindings.end(), other.bindings.begin(), other.bindings.end(), sameBinding);
+}
+/**
+ * @brief FNV-1a over every binding's fields, the binding flags and the create flags.
+ */
+size_t DescriptorSetLayoutDesc::Hash() const {
+    uint64_t hash = FNV_OFFSET;
+    for (const VkDescriptorSetLayoutBinding& binding : bindings) {
+        HashValue(hash, binding.binding);
+        HashValue(hash, binding.descriptorType);
+        HashValue(hash, binding.descriptorCount);
+        HashValue(hash, binding.stageFlags);
+    }
+    HashBytes(hash, bindingFlags.data(), bindingFlags.size() * sizeof(VkDescriptorBindingFlags));
+    HashValue(hash, flags);
+    return static_cast<size_t>(hash);
+}
+
+size_t LayoutCache::PipelineLayoutHash::operator()(const PipelineLayoutKey& key) const {
+    uint64_t hash = FNV_OFFSET;
+    HashBytes(hash, key.setLayouts.data(), key.setLayouts.size() * sizeof(VkDescriptorSetLayout));
+    HashValue(hash, key.pushConstantStages);
+    HashValue(hash, key.pushConstantOffset);
+    HashValue(hash, key.pushConstantSize);
+    return static_cast<size_t>(hash);
+}
+
+/**
+ * @param device Logical device the layouts are created on.
+ * @param allocator Host allocation callbacks (nullptr for the driver default).
+ */
+LayoutCache::LayoutCache(VkDevice device, const VkAllocationCallbacks* allocator)
+    : device(device), allocator(allocator) {
+}
+LayoutCache::~LayoutCache() {
+    for (auto& [key, layout] : pipelineLayouts) {
+        vkDestroyPipelineLayout(device, layout, allocator);
+    }
+    for (auto& [desc, layout] : setLayouts) {
+        vkDestroyDescriptorSetLayout(device, layout, allocator);
+    }
+}
+
+/**
+ * @brief One layout description per set the shader uses, from set 0 up to its highest set.
+ *
+ * A set the shader skips gets an empty description. A runtime-sized array is described with a
+ * count of 0, which the caller must replace with the array's real size.
+ */
+std::vector<DescriptorSetLayoutDesc> LayoutCache::DescribeSets(const ShaderReflection& reflection) {
+    std::vector<DescriptorSetLayoutDesc> sets(reflection.GetSetCount());
+    for (const ShaderReflection::Binding& binding : reflection.bindings) {
+        VkDescriptorSetLayoutBinding layoutBinding{};
+        layoutBinding.binding = binding.binding;
+        layoutBinding.descriptorType = binding.type;
+        layoutBinding.descriptorCount = binding.count;
+        layoutBinding.stageFlags = binding.stages;
+        sets[binding.set].bindings.push_back(layoutBinding);
+    }
+    return sets;
+}
+
+/**
+ * @brief Returns the set layout for desc, creating it on first request.
+ *
+ * @throws std::runtime_error if the layout cannot be created.
+ */
+VkDescriptorSetLayout LayoutCache::GetSetLayout(const DescriptorSetLayoutDesc& desc) {
+    auto it = setLayouts.find(desc);
+    if (it != setLayouts.end()) {
+        stats.hits++;
+        return it->second;
+    }
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount = static_cast<uint32_t>(desc.bindingFlags.size());
+    bindingFlagsInfo.pBindingFlags = desc.bindingFlags.data();
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = desc.bindingFlags.empty() ? nullptr : &bindingFlagsInfo;
+    layoutInfo.flags = desc.flags;
+    layoutInfo.bindingCount = static_cast<uint32_t>(desc.bindings.size());
+    layoutInfo.pBindings = desc.bindings.data();
+
+    VkDescriptorSetLayout layout;
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, allocator, &layout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor set layout!");
+    }
+    setLayouts.emplace(desc, layout);
+    stats.setLayouts++;
+    return layout;
+}
+/**
+ * @brief Returns the pipeline layout for the given set layouts and push constant range, creating it on first request.
+ *
+ * @param pushConstants Range covering every stage's push constants; a size of 0 means none.
+ * @throws std::runtime_error if the layout cannot be created.
+ */
+VkPipelineLayout LayoutCache::GetPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts, const VkPushConstantRange& pushConstants) {
+    PipelineLayoutKey key{ setLayouts, pushConstants.stageFlags, pushConstants.offset, pushConstants.size };
+    auto it = pipelineLayouts.find(key);
+    if (it != pipelineLayouts.end()) {
+        stats.hits++;
+        return it->second;
+    }
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = pushConstants.size != 0 ? 1 : 0;
+    pipelineLayoutInfo.pPushConstantRanges = pushConstants.size != 0 ? &pushConstants : nullptr;
+
+    VkPipelineLayout layout;
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, allocator, &layout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline layout!");
+    }
+    pipelineLayouts.emplace(std::move(key), layout);
+    stats.pipelineLayouts++;
+    return layout;
+}
+const LayoutCache::Stats& LayoutCache::GetStats() const {
+    return stats;
+}
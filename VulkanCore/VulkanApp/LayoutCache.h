@@ -0,0 +1,94 @@
+#pragma once
+
+#include "ShaderReflection.h"
+#include "Utilities.h"
+
+#include <unordered_map>
+
+
+/**
+ * @file LayoutCache.h
+ * @brief Defines DescriptorSetLayoutDesc and the LayoutCache class, which creates each distinct layout once.
+ */
+
+/**
+ * @brief Everything that distinguishes one descriptor set layout from another.
+ *
+ * Immutable samplers are not supported, so pImmutableSamplers is always null.
+ */
+struct DescriptorSetLayoutDesc {
+    std::vector<VkDescriptorSetLayoutBinding> bindings;  ///< Sorted by binding number.
+    std::vector<VkDescriptorBindingFlags> bindingFlags;  ///< Parallel to bindings, or empty for none.
+    VkDescriptorSetLayoutCreateFlags flags = 0;
+
+    VkDescriptorSetLayoutBinding* FindBinding(uint32_t binding);
+    void SetBindingFlags(uint32_t binding, VkDescriptorBindingFlags bindingFlag);
+
+    bool operator==(const DescriptorSetLayoutDesc& other) const;
+    size_t Hash() const;
+};
+
+/**
+ * @class LayoutCache
+ * @brief Hands out descriptor set layouts and pipeline layouts, creating each distinct one once.
+ *
+ * Layouts are keyed by their full description, so two shaders with the same interface get the
+ * same VkDescriptorSetLayout and VkPipelineLayout handles. Pipelines created with the same
+ * pipeline layout can then share bound descriptor sets across a pipeline switch.
+ *
+ * DescribeSets turns a ShaderReflection into one description per set. Callers adjust what the
+ * shader cannot say, like dynamic offsets or the size of a runtime array, before asking for the
+ * layout.
+ */
+class LayoutCache {
+public:
+    /**
+     * @brief Lookup counters for the debug overlay.
+     */
+    struct Stats {
+        uint32_t setLayouts = 0;       ///< Distinct descriptor set layouts created.
+        uint32_t pipelineLayouts = 0;  ///< Distinct pipeline layouts created.
+        uint64_t hits = 0;             ///< Requests answered with an existing layout.
+    };
+
+    LayoutCache(VkDevice device, const VkAllocationCallbacks* allocator);
+    ~LayoutCache();
+
+    LayoutCache(const LayoutCache&) = delete;
+    LayoutCache& operator=(const LayoutCache&) = delete;
+
+    static std::vector<DescriptorSetLayoutDesc> DescribeSets(const ShaderReflection& reflection);
+
+    VkDescriptorSetLayout GetSetLayout(const DescriptorSetLayoutDesc& desc);
+    VkPipelineLayout GetPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts, const VkPushConstantRange& pushConstants);
+
+    const Stats& GetStats() const;
+
+private:
+    /**
+     * @brief Set layouts and push constant range of a pipeline layout. A range of size 0 means none.
+     */
+    struct PipelineLayoutKey {
+        std::vector<VkDescriptorSetLayout> setLayouts;
+        VkShaderStageFlags pushConstantStages = 0;
+        uint32_t pushConstantOffset = 0;
+        uint32_t pushConstantSize = 0;
+
+        bool operator==(const PipelineLayoutKey&) const = default;
+    };
+
+    struct SetLayoutHash {
+        size_t operator()(const DescriptorSetLayoutDesc& desc) const { return desc.Hash(); }
+    };
+    struct PipelineLayoutHash {
+        size_t operator()(const PipelineLayoutKey& key) const;
+    };
+
+    // Vulkan handles
+    VkDevice device = VK_NULL_HANDLE;                 ///< Vulkan logical device handle.
+    const VkAllocationCallbacks* allocator = nullptr; ///< Host allocation callbacks (nullptr for the driver default).
+
+    std::unordered_map<DescriptorSetLayoutDesc, VkDescriptorSetLayout, SetLayoutHash> setLayouts;
+    std::unordered_map<PipelineLayoutKey, VkPipelineLayout, PipelineLayoutHash> pipelineLayouts;
+    Stats stats;
+};
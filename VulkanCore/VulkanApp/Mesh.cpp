@@ -0,0 +1,149 @@
+#include "Mesh.h"
+
+#include <algorithm>
+#include <limits>
+
+// Model Loader
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+
+Mesh::Mesh(GeometryBuffer& geometry)
+    : geometry(geometry) {}
+
+void Mesh::Bind(VkCommandBuffer commandBuffer) const {
+    geometry.Bind(commandBuffer);
+}
+/**
+ * @brief Records an indexed draw of the whole mesh.
+ *
+ * @param commandBuffer Command buffer to record into.
+ * @param instanceCount Number of instances to draw.
+ * @param firstInstance Index of the first instance; the vertex shader sees it through gl_InstanceIndex.
+ */
+void Mesh::Draw(VkCommandBuffer commandBuffer, uint32_t instanceCount, uint32_t firstInstance) const {
+    vkCmdDrawIndexed(commandBuffer, range.indexCount, instanceCount, range.firstIndex, range.vertexOffset, firstInstance);
+}
+/**
+ * @brief Builds the indirect command equivalent to Draw, for writing into an indirect buffer.
+ */
+VkDrawIndexedIndirectCommand Mesh::GetDrawCommand(uint32_t instanceCount, uint32_t firstInstance) const {
+    VkDrawIndexedIndirectCommand command{};
+    command.indexCount = range.indexCount;
+    command.instanceCount = instanceCount;
+    command.firstIndex = range.firstIndex;
+    command.vertexOffset = range.vertexOffset;
+    command.firstInstance = firstInstance;
+    return command;
+}
+
+uint32_t Mesh::GetIndexCount() const {
+    return range.indexCount;
+}
+const glm::vec4& Mesh::GetBoundingSphere() const {
+    return boundingSphere;
+}
+uint32_t Mesh::GetSortIndex() const {
+    return sortIndex;
+}
+void Mesh::SetSortIndex(uint32_t index) {
+    sortIndex = index;
+}
+
+void Mesh::LoadOBJ(const std::string& filepath) {
+    // Initialize TinyOBJ structures to load OBJ file data
+    tinyobj::attrib_t attrib; // Holds vertex attributes such as positions, normals, and texture coordinates
+    std::vector<tinyobj::shape_t> shapes; // Holds the geometric shapes in the OBJ file
+    std::vector<tinyobj::material_t> materials; // Holds material information (not used in this example)
+    std::string warn, err; // Strings to capture warnings and errors during file loading
+
+    // Load the OBJ file and populate the TinyOBJ structures
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filepath.c_str())) {
+        // If loading fails, throw an exception with the combined warning and error messages
+        throw std::runtime_error(warn + err);
+    }
+
+    // Iterate through each shape in the OBJ file
+    for (const auto& shape : shapes) {
+        // Iterate through each index in the shape's mesh
+        for (const auto& index : shape.mesh.indices) {
+            Vertex vertex{}; // Initialize a new vertex
+
+            // Set the vertex position using the indexed position data from the attrib array
+            vertex.pos = {
+                attrib.vertices[3 * index.vertex_index + 0], // X coordinate
+                attrib.vertices[3 * index.vertex_index + 1], // Y coordinate
+                attrib.vertices[3 * index.vertex_index + 2]  // Z coordinate
+            };
+
+            // Set the vertex texture coordinates using the indexed texcoord data from the attrib array
+            // Flip the Y coordinate by subtracting it from 1.0f (to match Vulkan's coordinate system)
+            vertex.textCoor = {
+                attrib.texcoords[2 * index.texcoord_index + 0], // U coordinate
+                1.0f - attrib.texcoords[2 * index.texcoord_index + 1] // V coordinate (flipped)
+            };
+
+            // Set the vertex color (default to white as the OBJ file doesn't specify colors)
+            vertex.color = { 1.0f, 1.0f, 1.0f };
+
+            // Add the vertex to the vertices vector
+            vertices.push_back(vertex);
+
+            // Add an index to the indices vector for indexed drawing
+            indices.push_back(static_cast<uint32_t>(indices.size()));
+        }
+    }
+
+    // Append the geometry to the shared vertex and index buffers
+    range = geometry.Upload(vertices, indices);
+    ComputeBoundingSphere();
+}
+void Mesh::LoadFBX(const std::string& filepath) {
+    // Example using Assimp for FBX loading
+    // Include Assimp headers and link its library in your build system
+    // Assimp::Importer importer;
+    // const aiScene* scene = importer.ReadFile(filepath, aiProcess_Triangulate | aiProcess_FlipUVs);
+    // if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+    //     throw std::runtime_error("Failed to load FBX file: " + filepath);
+    // }
+
+    // Parse the FBX file and fill `vertices` and `indices` with data
+    // You can recursively process the scene graph to extract meshes and transform data
+    std::cerr << "FBX loading not yet implemented: " << filepath << "\n";
+
+    // For now, throw an error if unimplemented
+    throw std::runtime_error("FBX loading not implemented yet.");
+}
+/**
+ * @brief Fits a sphere around the vertices, centered on their bounding box.
+ *
+ * Not the tightest sphere, but cheap and conservative, which is all frustum culling needs.
+ */
+void Mesh::ComputeBoundingSphere() {
+    glm::vec3 minBounds(std::numeric_limits<float>::max());
+    glm::vec3 maxBounds(std::numeric_limits<float>::lowest());
+    for (const auto& vertex : vertices) {
+        minBounds = glm::min(minBounds, vertex.pos);
+        maxBounds = glm::max(maxBounds, vertex.pos);
+    }
+
+    glm::vec3 center = (minBounds + maxBounds) * 0.5f;
+    float radiusSquared = 0.0f;
+    for (const auto& vertex : vertices) {
+        glm::vec3 offset = vertex.pos - center;
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+
+    boundingSphere = glm::vec4(center, std::sqrt(radiusSquared));
+}
+void Mesh::LoadFromFile(const std::string& filepath) {
+    if (filepath.ends_with(".obj")) {
+        LoadOBJ(filepath);
+    }
+    else if (filepath.ends_with(".fbx")) {
+        LoadFBX(filepath);
+    }
+    else {
+        throw std::runtime_error("Unsupported file format: " + filepath);
+    }
+}
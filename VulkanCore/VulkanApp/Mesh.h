@@ -0,0 +1,50 @@
+#pragma once
+
+#include "GeometryBuffer.h"
+
+
+/**
+ * @file Mesh.h
+ * @brief Defines the Mesh class, geometry for a loaded model file stored in the shared GeometryBuffer.
+ */
+
+/**
+ * @class Mesh
+ * @brief Geometry loaded from a file and uploaded into a range of the shared GeometryBuffer.
+ *
+ * A mesh is shared by every scene entity that references it, so identical models can be drawn
+ * together with a single instanced draw call.
+ */
+class Mesh {
+public:
+    explicit Mesh(GeometryBuffer& geometry);
+
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    void LoadFromFile(const std::string& filepath);
+
+    void Bind(VkCommandBuffer commandBuffer) const;
+    void Draw(VkCommandBuffer commandBuffer, uint32_t instanceCount = 1, uint32_t firstInstance = 0) const;
+    VkDrawIndexedIndirectCommand GetDrawCommand(uint32_t instanceCount, uint32_t firstInstance) const;
+
+    uint32_t GetIndexCount() const;
+    const glm::vec4& GetBoundingSphere() const;
+    uint32_t GetSortIndex() const;
+    void SetSortIndex(uint32_t index);
+
+private:
+    GeometryBuffer& geometry; ///< Shared buffers the mesh is uploaded into.
+    MeshRange range;          ///< Location of the mesh inside the shared buffers.
+    glm::vec4 boundingSphere{ 0.0f }; ///< Mesh-space bounding sphere: center (xyz) and radius (w).
+    uint32_t sortIndex = 0;           ///< Mesh field of the render queue sort key.
+
+    // Geometry data
+    std::vector<Vertex> vertices;  ///< Vertex data for the mesh.
+    std::vector<uint32_t> indices; ///< Index data for the mesh.
+
+    // Private methods for internal functionality
+    void LoadOBJ(const std::string& filepath); ///< Loads geometry from an OBJ file.
+    void LoadFBX(const std::string& filepath); ///< Loads geometry from an FBX file.
+    void ComputeBoundingSphere();              ///< Fits boundingSphere around the loaded vertices.
+};
@@ -0,0 +1,128 @@
+#include "ParallelCommandRecorder.h"
+
+#include <algorithm>
+
+
+/**
+ * @param device Logical device the pools are created on.
+ * @param queueFamilyIndex Queue family the primary command buffers are submitted to.
+ * @param allocator Host allocation callbacks (nullptr for the driver default).
+ * @param frameCount Frames in flight (or any other independently recorded slots); each gets its own pools.
+ * @param maxRanges Most ranges a single Record call can split the items into.
+ *
+ * @throws std::runtime_error if a command pool or command buffer cannot be created.
+ */
+ParallelCommandRecorder::ParallelCommandRecorder(VkDevice device, uint32_t queueFamilyIndex, const VkAllocationCallbacks* allocator, uint32_t frameCount, uint32_t maxRanges)
+    : device(device), allocator(allocator), maxRanges(std::max(maxRanges, 1u)) {
+    frames.resize(frameCount);
+    for (FrameContext& frame : frames) {
+        frame.commandPools.resize(this->maxRanges, VK_NULL_HANDLE);
+        frame.commandBuffers.resize(this->maxRanges, VK_NULL_HANDLE);
+
+        for (uint32_t range = 0; range < this->maxRanges; range++) {
+            // Transient: the pool is reset every time its frame is recorded.
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolInfo.queueFamilyIndex = queueFamilyIndex;
+            if (vkCreateCommandPool(device, &poolInfo, allocator, &frame.commandPools[range]) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create recording command pool!");
+            }
+
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = frame.commandPools[range];
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocInfo.commandBufferCount = 1;
+            if (vkAllocateCommandBuffers(device, &allocInfo, &frame.commandBuffers[range]) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to allocate secondary command buffer!");
+            }
+        }
+    }
+}
+ParallelCommandRecorder::~ParallelCommandRecorder() {
+    // Destroying a pool frees its command buffers.
+    for (FrameContext& frame : frames) {
+        for (VkCommandPool pool : frame.commandPools) {
+            if (pool != VK_NULL_HANDLE) {
+                vkDestroyCommandPool(device, pool, allocator);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Records items [0, itemCount) into up to rangeCount secondaries, one range per ThreadPool task.
+ *
+ * Ranges are contiguous and as even as possible, so executing the returned secondaries in order
+ * reproduces the serial draw order. Must be called from the thread that owns the ThreadPool.
+ *
+ * @param threadPool Pool the ranges are recorded on; the calling thread records one as well.
+ * @param frame Frame in flight whose pools are reset and recorded into. Its fence must already be signaled.
+ * @param rangeCount Requested number of ranges, clamped to [1, GetMaxRanges()] and to itemCount.
+ * @param itemCount Number of items to record.
+ * @param inheritanceInfo Render pass, subpass and framebuffer the secondaries continue.
+ * @param record Records one range; called concurrently from several threads.
+ * @return The recorded secondaries. They may be executed any number of times until the next Record
+ *         call for the same frame.
+ *
+ * @throws std::out_of_range if frame is not below the frame count the recorder was created with.
+ * @throws std::runtime_error if a secondary fails to begin or end.
+ */
+const std::vector<VkCommandBuffer>& ParallelCommandRecorder::Record(ThreadPool& threadPool, uint32_t frame, uint32_t rangeCount, uint32_t itemCount,
+    const VkCommandBufferInheritanceInfo& inheritanceInfo, const RecordFunction& record) {
+    if (frame >= frames.size()) {
+        throw std::out_of_range("Recorder frame index out of range!");
+    }
+    FrameContext& context = frames[frame];
+    context.recorded.clear();
+    if (itemCount == 0) {
+        return context.recorded;
+    }
+    rangeCount = std::clamp(rangeCount, 1u, std::min(maxRanges, itemCount));
+
+    // Exceptions must not escape a worker thread, so failures are collected and rethrown here.
+    std::atomic<bool> failed{ false };
+    threadPool.ParallelFor(rangeCount, 1, [&](uint32_t firstRange, uint32_t endRange) {
+        for (uint32_t range = firstRange; range < endRange; range++) {
+            vkResetCommandPool(device, context.commandPools[range], 0);
+
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+            beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+            VkCommandBuffer commandBuffer = context.commandBuffers[range];
+            if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+                failed = true;
+                continue;
+            }
+            uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(itemCount) * range / rangeCount);
+            uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(itemCount) * (range + 1) / rangeCount);
+            record(commandBuffer, begin, end);
+            if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+                failed = true;
+            }
+        }
+    });
+    if (failed) {
+        throw std::runtime_error("Failed to record secondary command buffer!");
+    }
+
+    context.recorded.assign(context.commandBuffers.begin(), context.commandBuffers.begin() + rangeCount);
+    return context.recorded;
+}
+/**
+ * @brief Returns what the last Record call for a frame produced, for executing it again unchanged.
+ *
+ * @throws std::out_of_range if frame is not below the frame count the recorder was created with.
+ */
+const std::vector<VkCommandBuffer>& ParallelCommandRecorder::GetRecorded(uint32_t frame) const {
+    if (frame >= frames.size()) {
+        throw std::out_of_range("Recorder frame index out of range!");
+    }
+    return frames[frame].recorded;
+}
+uint32_t ParallelCommandRecorder::GetMaxRanges() const {
+    return maxRanges;
+}
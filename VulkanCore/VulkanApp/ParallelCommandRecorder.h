@@ -0,0 +1,58 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include "Utilities.h"
+
+
+/**
+ * @file ParallelCommandRecorder.h
+ * @brief Defines the ParallelCommandRecorder class, which records secondary command buffers on a ThreadPool.
+ */
+
+/**
+ * @class ParallelCommandRecorder
+ * @brief Splits a list of draws into ranges and records each range into its own secondary command buffer.
+ *
+ * Command pools are externally synchronized, so every range gets its own pool and no two threads
+ * ever record from the same one. Each frame in flight has its own set of pools, which are reset
+ * wholesale the next time that frame is recorded; the caller guarantees the frame's fence has
+ * signaled by then. The secondaries continue a render pass and are executed by the primary with
+ * vkCmdExecuteCommands in range order. They are not one-time-submit, so a caller may keep executing
+ * what a frame last recorded (see GetRecorded) instead of recording it again.
+ */
+class ParallelCommandRecorder {
+public:
+    /**
+     * @brief Records items [begin, end) into a secondary command buffer that has already been begun.
+     */
+    using RecordFunction = std::function<void(VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end)>;
+
+    ParallelCommandRecorder(VkDevice device, uint32_t queueFamilyIndex, const VkAllocationCallbacks* allocator, uint32_t frameCount, uint32_t maxRanges);
+    ~ParallelCommandRecorder();
+
+    ParallelCommandRecorder(const ParallelCommandRecorder&) = delete;
+    ParallelCommandRecorder& operator=(const ParallelCommandRecorder&) = delete;
+
+    const std::vector<VkCommandBuffer>& Record(ThreadPool& threadPool, uint32_t frame, uint32_t rangeCount, uint32_t itemCount,
+        const VkCommandBufferInheritanceInfo& inheritanceInfo, const RecordFunction& record);
+
+    const std::vector<VkCommandBuffer>& GetRecorded(uint32_t frame) const;
+    uint32_t GetMaxRanges() const;
+
+private:
+    /**
+     * @brief Command pools and secondaries owned by one frame in flight, one of each per range.
+     */
+    struct FrameContext {
+        std::vector<VkCommandPool> commandPools;
+        std::vector<VkCommandBuffer> commandBuffers;
+        std::vector<VkCommandBuffer> recorded; ///< Secondaries recorded this frame, in range order.
+    };
+
+    // Vulkan handles
+    VkDevice device = VK_NULL_HANDLE;                 ///< Vulkan logical device handle.
+    const VkAllocationCallbacks* allocator = nullptr; ///< Host allocation callbacks (nullptr for the driver default).
+
+    std::vector<FrameContext> frames; ///< One context per frame in flight.
+    uint32_t maxRanges = 0;           ///< Pools (and secondaries) per frame.
+};
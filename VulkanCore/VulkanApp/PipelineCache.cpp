@@ -0,0 +1,195 @@
+#include "PipelineCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+
+namespace {
+
+constexpr size_t VULKAN_HEADER_SIZE = 16 + VK_UUID_SIZE; ///< VkPipelineCacheHeaderVersionOne, as laid out in the data.
+
+uint64_t HashData(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * 1099511628211ull;
+    }
+    return hash;
+}
+
+uint32_t ReadUint32(const char* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+/**
+ * @param device Logical device the cache is created on.
+ * @param physicalDevice Physical device whose IDs, driver version and cache UUID key the file.
+ * @param allocator Host allocation callbacks (nullptr for the driver default).
+ *
+ * @throws std::runtime_error if the pipeline cache cannot be created.
+ */
+PipelineCache::PipelineCache(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator)
+    : device(device), allocator(allocator) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    expectedHeader.vendorID = properties.vendorID;
+    expectedHeader.deviceID = properties.deviceID;
+    expectedHeader.driverVersion = properties.driverVersion;
+    std::memcpy(expectedHeader.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+    char fileName[64];
+    std::snprintf(fileName, sizeof(fileName), "pipeline_cache_%04x_%04x.bin", properties.vendorID, properties.deviceID);
+    path = fileName;
+
+    std::vector<char> data = LoadData();
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = data.size();
+    cacheInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    if (vkCreatePipelineCache(device, &cacheInfo, allocator, &cache) != VK_SUCCESS) {
+        // The driver may still refuse data that passed our checks; fall back to an empty cache.
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        loadedSize = 0;
+        loadResult = "rejected by driver";
+        if (vkCreatePipelineCache(device, &cacheInfo, allocator, &cache) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create pipeline cache!");
+        }
+    }
+}
+PipelineCache::~PipelineCache() {
+    if (cache != VK_NULL_HANDLE) {
+        vkDestroyPipelineCache(device, cache, allocator);
+    }
+}
+
+/**
+ * @brief Reads and validates the cache file. Returns an empty vector if it is missing or does not match this device.
+ */
+std::vector<char> PipelineCache::LoadData() {
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    if (!file.is_open()) {
+        return {};
+    }
+
+    const size_t fileSize = static_cast<size_t>(file.tellg());
+    FileHeader header;
+    if (fileSize < sizeof(header)) {
+        loadResult = "truncated";
+        return {};
+    }
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION) {
+        loadResult = "unknown format";
+        return {};
+    }
+    if (header.vendorID != expectedHeader.vendorID || header.deviceID != expectedHeader.deviceID
+        || header.driverVersion != expectedHeader.driverVersion
+        || std::memcmp(header.pipelineCacheUUID, expectedHeader.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        loadResult = "different device or driver";
+        return {};
+    }
+    if (header.dataSize != fileSize - sizeof(header) || header.dataSize < VULKAN_HEADER_SIZE) {
+        loadResult = "truncated";
+        return {};
+    }
+
+    std::vector<char> data(static_cast<size_t>(header.dataSize));
+    file.read(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!file || HashData(data.data(), data.size()) != header.dataHash) {
+        loadResult = "corrupt";
+        return {};
+    }
+
+    // The data starts with Vulkan's own header, which must describe the same device.
+    const uint32_t vulkanHeaderSize = ReadUint32(data.data());
+    const uint32_t vulkanHeaderVersion = ReadUint32(data.data() + 4);
+    if (vulkanHeaderSize < VULKAN_HEADER_SIZE || vulkanHeaderSize > data.size()
+        || vulkanHeaderVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        || ReadUint32(data.data() + 8) != expectedHeader.vendorID || ReadUint32(data.data() + 12) != expectedHeader.deviceID
+        || std::memcmp(data.data() + 16, expectedHeader.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        loadResult = "invalid cache header";
+        return {};
+    }
+
+    loadedSize = data.size();
+    diskSize = header.dataSize;
+    diskHash = header.dataHash;
+    loadResult = "loaded";
+    return data;
+}
+
+/**
+ * @brief Writes the cache to disk if it changed since it was loaded.
+ *
+ * Failures are reported and otherwise ignored; the next run simply starts colder.
+ *
+ * @return True if the file on disk is now up to date.
+ */
+bool PipelineCache::Save() {
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(device, cache, &dataSize, nullptr) != VK_SUCCESS) {
+        std::cerr << "Failed to query pipeline cache size.\n";
+        return false;
+    }
+    std::vector<char> data(dataSize);
+    if (vkGetPipelineCacheData(device, cache, &dataSize, data.data()) != VK_SUCCESS) {
+        std::cerr << "Failed to read pipeline cache data.\n";
+        return false;
+    }
+    data.resize(dataSize);
+
+    FileHeader header = expectedHeader;
+    header.dataSize = data.size();
+    header.dataHash = HashData(data.data(), data.size());
+    if (header.dataSize == diskSize && header.dataHash == diskHash) {
+        return true;
+    }
+
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        file.flush();
+        if (!file) {
+            std::cerr << "Failed to write " << tempPath << ".\n";
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::cerr << "Failed to replace " << path << ": " << error.message() << "\n";
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    diskSize = header.dataSize;
+    diskHash = header.dataHash;
+    return true;
+}
+
+VkPipelineCache PipelineCache::Get() const {
+    return cache;
+}
+bool PipelineCache::WasLoaded() const {
+    return loadedSize != 0;
+}
+size_t PipelineCache::GetLoadedSize() const {
+    return loadedSize;
+}
+const char* PipelineCache::GetLoadResult() const {
+    return loadResult;
+}
+const std::string& PipelineCache::GetPath() const {
+    return path;
+}
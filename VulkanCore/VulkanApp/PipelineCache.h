@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Utilities.h"
+
+
+/**
+ * @file PipelineCache.h
+ * @brief Defines the PipelineCache class, a VkPipelineCache persisted to disk between runs.
+ */
+
+/**
+ * @class PipelineCache
+ * @brief Loads a pipeline cache from disk at startup and writes it back at shutdown.
+ *
+ * The file name is keyed by vendor and device ID. Its header also records the driver version and
+ * the device's pipelineCacheUUID, so a driver update rewrites the same file instead of leaving stale
+ * ones behind. On load both that header and the header Vulkan puts at the start of the cache data
+ * are checked, along with the data's size and hash. A file that fails any check is ignored and the
+ * cache starts empty. Drivers must reject foreign data themselves, but not all of them do.
+ *
+ * Save writes to a temporary file and renames it over the old one, so an interrupted save never
+ * leaves a truncated cache behind.
+ */
+class PipelineCache {
+public:
+    PipelineCache(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator);
+    ~PipelineCache();
+
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+    bool Save();
+
+    VkPipelineCache Get() const;
+    bool WasLoaded() const;
+    size_t GetLoadedSize() const;
+    const char* GetLoadResult() const;
+    const std::string& GetPath() const;
+
+private:
+    static constexpr uint32_t FILE_MAGIC = 0x43504B56;  ///< "VKPC", little endian.
+    static constexpr uint32_t FILE_VERSION = 1;         ///< Bump when FileHeader changes.
+
+    /**
+     * @brief Written in front of the cache data.
+     */
+    struct FileHeader {
+        uint32_t magic = FILE_MAGIC;
+        uint32_t version = FILE_VERSION;
+        uint32_t vendorID = 0;
+        uint32_t deviceID = 0;
+        uint32_t driverVersion = 0;
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE] = {};
+        uint32_t padding = 0;
+        uint64_t dataSize = 0;
+        uint64_t dataHash = 0;   ///< FNV-1a of the cache data.
+    };
+
+    // Vulkan handles
+    VkDevice device = VK_NULL_HANDLE;                 ///< Vulkan logical device handle.
+    const VkAllocationCallbacks* allocator = nullptr; ///< Host allocation callbacks (nullptr for the driver default).
+    VkPipelineCache cache = VK_NULL_HANDLE;
+
+    // Identity of the device the data belongs to
+    FileHeader expectedHeader;
+    std::string path;
+
+    // Load results
+    size_t loadedSize = 0;                  ///< Bytes of cache data accepted at startup; 0 for a cold start.
+    uint64_t diskSize = 0;                  ///< Size and hash of the data last read or written, so an
+    uint64_t diskHash = 0;                  ///< unchanged cache is not rewritten.
+    const char* loadResult = "no file";     ///< Why the file was used or ignored, for the overlay.
+
+    std::vector<char> LoadData();
+};
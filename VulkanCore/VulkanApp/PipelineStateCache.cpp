@@ -0,0 +1,559 @@
+#include "PipelineStateCache.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+void HashBytes(uint64_t& hash, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+}
+
+template <typename T>
+void HashValue(uint64_t& hash, const T& value) {
+    HashBytes(hash, &value, sizeof(value));
+}
+
+} // namespace
+
+/**
+ * @brief Sets a bool constant, replacing any earlier value for constantID.
+ */
+void SpecializationConstants::Set(uint32_t constantID, bool value) {
+    Set(constantID, static_cast<uint32_t>(value ? VK_TRUE : VK_FALSE));
+}
+/**
+ * @brief Sets a constant, replacing its value if it is already set.
+ *
+ * Constants are kept sorted by ID, so the order of the Set calls never makes two equal sets
+ * compare or hash differently.
+ */
+void SpecializationConstants::Set(uint32_t constantID, uint32_t value) {
+    auto it = std::lower_bound(constantIDs.begin(), constantIDs.end(), constantID);
+    const auto index = it - constantIDs.begin();
+    if (it != constantIDs.end() && *it == constantID) {
+        values[index] = value;
+        return;
+    }
+    constantIDs.insert(it, constantID);
+    values.insert(values.begin() + index, value);
+}
+void SpecializationConstants::Set(uint32_t constantID, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    Set(constantID, bits);
+}
+bool SpecializationConstants::Empty() const {
+    return constantIDs.empty();
+}
+/**
+ * @brief Describes the constants to Vulkan. The result points into mapEntries and this object.
+ */
+VkSpecializationInfo SpecializationConstants::GetInfo(std::vector<VkSpecializationMapEntry>& mapEntries) const {
+    mapEntries.resize(constantIDs.size());
+    for (size_t i = 0; i < constantIDs.size(); i++) {
+        mapEntries[i] = { constantIDs[i], static_cast<uint32_t>(i * sizeof(uint32_t)), sizeof(uint32_t) };
+    }
+
+    VkSpecializationInfo info{};
+    info.mapEntryCount = static_cast<uint32_t>(mapEntries.size());
+    info.pMapEntries = mapEntries.data();
+    info.dataSize = values.size() * sizeof(uint32_t);
+    info.pData = values.data();
+    return info;
+}
+
+/**
+ * @brief FNV-1a over every field, hashed one by one so padding never contributes.
+ */
+size_t PipelineDesc::Hash() const {
+    uint64_t hash = FNV_OFFSET;
+    HashBytes(hash, vertexShader.data(), vertexShader.size());
+    HashValue(hash, vertexShader.size());
+    HashBytes(hash, fragmentShader.data(), fragmentShader.size());
+    HashValue(hash, fragmentShader.size());
+    for (const SpecializationConstants* constants : { &vertexConstants, &fragmentConstants }) {
+        HashBytes(hash, constants->constantIDs.data(), constants->constantIDs.size() * sizeof(uint32_t));
+        HashBytes(hash, constants->values.data(), constants->values.size() * sizeof(uint32_t));
+        HashValue(hash, constants->constantIDs.size());
+    }
+    HashValue(hash, layout);
+    HashValue(hash, positionOnly);
+    HashValue(hash, renderPass);
+    HashValue(hash, subpass);
+    HashValue(hash, colorFormat);
+    HashValue(hash, depthFormat);
+    HashValue(hash, samples);
+    HashValue(hash, sampleShading);
+    HashValue(hash, polygonMode);
+    HashValue(hash, dynamicPolygonMode);
+    HashValue(hash, cullMode);
+    HashValue(hash, frontFace);
+    HashValue(hash, depthTest);
+    HashValue(hash, depthWrite);
+    HashValue(hash, depthCompareOp);
+    HashValue(hash, alphaBlend);
+    return static_cast<size_t>(hash);
+}
+
+/**
+ * @param device Logical device pipelines and shader modules are created on.
+ * @param allocator Host allocation callbacks (nullptr for the driver default).
+ * @param pipelineCache Driver pipeline cache used for every compile; may be VK_NULL_HANDLE.
+ * @param shaderCompiler Builds the SPIR-V for each shader path; must outlive the cache.
+ * @param compileThreadCount Threads compiling queued variants.
+ */
+PipelineStateCache::PipelineStateCache(VkDevice device, const VkAllocationCallbacks* allocator, VkPipelineCache pipelineCache, ShaderCompiler* shaderCompiler, uint32_t compileThreadCount)
+    : device(device), allocator(allocator), pipelineCache(pipelineCache), shaderCompiler(shaderCompiler) {
+    compileThreads.reserve(compileThreadCount);
+    for (uint32_t i = 0; i < compileThreadCount; i++) {
+        compileThreads.emplace_back(&PipelineStateCache::CompileLoop, this);
+    }
+}
+PipelineStateCache::~PipelineStateCache() {
+    Clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (auto& thread : compileThreads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Returns the pipeline for desc, compiling it on this thread if it does not exist yet.
+ *
+ * A variant that is already queued is waited for rather than compiled twice. Other queued variants
+ * that fail meanwhile are reported by the next PublishCompleted instead.
+ *
+ * @throws std::runtime_error if a shader cannot be loaded or the pipeline cannot be created.
+ */
+VkPipeline PipelineStateCache::Get(const PipelineDesc& desc) {
+    stats.lookups++;
+    auto it = pipelines.find(desc);
+    if (it != pipelines.end() && it->second != VK_NULL_HANDLE) {
+        return it->second;
+    }
+    if (it != pipelines.end()) {
+        WaitIdle();
+        std::vector<CompiledPipeline> failures;
+        PublishFinished(failures);
+        for (const CompiledPipeline& failure : failures) {
+            if (failure.desc != desc) {
+                deferredError = failure.error;
+            }
+        }
+        if (failedVariants.contains(desc)) {
+            throw std::runtime_error("Failed to create queued graphics pipeline variant!");
+        }
+        return pipelines.at(desc);
+    }
+
+    double compileMs = 0.0;
+    VkPipeline pipeline = CreatePipeline(desc, GetShaderModule(desc.vertexShader), GetShaderModule(desc.fragmentShader), compileMs);
+    pipelines.emplace(desc, pipeline);
+    stats.pipelines++;
+    stats.compileMs += compileMs;
+    stats.longestCompileMs = std::max(stats.longestCompileMs, compileMs);
+    return pipeline;
+}
+/**
+ * @brief Returns the pipeline for desc if it is ready, and fallback otherwise.
+ *
+ * A missing variant is queued for the compile threads and shows up after a later PublishCompleted.
+ *
+ * @param fallback Pipeline to draw with meanwhile; it must be compatible with the same render target.
+ */
+VkPipeline PipelineStateCache::GetAsync(const PipelineDesc& desc, VkPipeline fallback) {
+    stats.lookups++;
+    auto it = pipelines.find(desc);
+    if (it != pipelines.end() && it->second != VK_NULL_HANDLE) {
+        return it->second;
+    }
+    if (it == pipelines.end() && !failedVariants.contains(desc)) {
+        Enqueue(desc);
+    }
+    stats.fallbacks++;
+    return fallback;
+}
+/**
+ * @brief Queues desc for compilation unless it exists or is already queued.
+ */
+void PipelineStateCache::Prefetch(const PipelineDesc& desc) {
+    if (pipelines.find(desc) == pipelines.end() && !failedVariants.contains(desc)) {
+        Enqueue(desc);
+    }
+}
+/**
+ * @brief Makes finished compiles visible to Get and GetAsync.
+ *
+ * Every finished compile is processed before a failure is rethrown, and the failed variants are
+ * not queued again until ReloadShader replaces one of their shaders.
+ *
+ * @return Number of variants that became available.
+ * @throws std::runtime_error if a queued compile failed, here or during an earlier Get.
+ */
+uint32_t PipelineStateCache::PublishCompleted() {
+    std::vector<CompiledPipeline> failures;
+    const uint32_t published = PublishFinished(failures);
+    std::exception_ptr error = std::exchange(deferredError, nullptr);
+    if (!failures.empty()) {
+        error = failures.back().error;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return published;
+}
+/**
+ * @brief Blocks until every queued variant has finished compiling. Does not publish them.
+ */
+void PipelineStateCache::WaitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    jobFinished.wait(lock, [this] { return jobs.empty() && runningJobs == 0; });
+}
+/**
+ * @brief Moves finished compiles into the cache without throwing.
+ *
+ * @param failures Receives the compiles that failed; their variants are erased and marked as failed.
+ * @return Number of variants that became available.
+ */
+uint32_t PipelineStateCache::PublishFinished(std::vector<CompiledPipeline>& failures) {
+    std::vector<CompiledPipeline> finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.swap(completed);
+    }
+
+    uint32_t published = 0;
+    for (CompiledPipeline& result : finished) {
+        stats.pending--;
+        if (result.error) {
+            pipelines.erase(result.desc);
+            failedVariants.insert(result.desc);
+            failures.push_back(std::move(result));
+            continue;
+        }
+        pipelines[result.desc] = result.pipeline;
+        stats.pipelines++;
+        stats.compileMs += result.compileMs;
+        stats.longestCompileMs = std::max(stats.longestCompileMs, result.compileMs);
+        published++;
+    }
+    return published;
+}
+/**
+ * @brief Destroys every pipeline and shader module. None of them may still be in use by the GPU.
+ *
+ * Waits for queued compiles first, since they use the shader modules.
+ */
+void PipelineStateCache::Clear() {
+    WaitIdle();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const CompiledPipeline& result : completed) {
+            if (result.pipeline != VK_NULL_HANDLE) {
+                vkDestroyPipeline(device, result.pipeline, allocator);
+            }
+        }
+        completed.clear();
+    }
+    for (auto& [desc, pipeline] : pipelines) {
+        if (pipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(device, pipeline, allocator);
+        }
+    }
+    pipelines.clear();
+    failedVariants.clear();
+    deferredError = nullptr;
+    stats.pending = 0;
+    for (auto& [path, shaderModule] : shaderModules) {
+        vkDestroyShaderModule(device, shaderModule, allocator);
+    }
+    shaderModules.clear();
+}
+/**
+ * @brief Rebuilds the shader module for path from its current source and destroys every variant that used the old one.
+ *
+ * The new source is compiled, and rebuildFirst created from it if it uses path, before anything
+ * is destroyed. So a shader that fails to compile, or that no longer links into the variant the
+ * caller cannot draw without, leaves the cache untouched. Otherwise none of the affected pipelines
+ * may still be in use by the GPU, and any handle to them the caller holds is dangling afterwards.
+ *
+ * @param path Shader whose source changed.
+ * @param rebuildFirst Variant that must keep working; it is replaced rather than dropped, so Get
+ *        returns it without compiling.
+ * @return Descriptions of the replaced, destroyed and previously failed variants, so the caller can
+ *         request them again.
+ * @throws std::runtime_error if the shader or rebuildFirst fails to compile, or if a queued compile failed.
+ */
+std::vector<PipelineDesc> PipelineStateCache::ReloadShader(const std::string& path, const PipelineDesc& rebuildFirst) {
+    auto moduleIt = shaderModules.find(path);
+    if (moduleIt == shaderModules.end()) {
+        return {};
+    }
+
+    // Queued compiles may use the old module; let them finish and destroy them with the rest.
+    WaitIdle();
+    PublishCompleted();
+    VkShaderModule shaderModule = CreateShaderModule(path);
+
+    VkPipeline rebuilt = VK_NULL_HANDLE;
+    double compileMs = 0.0;
+    const bool rebuildUsesPath = rebuildFirst.vertexShader == path || rebuildFirst.fragmentShader == path;
+    if (rebuildUsesPath) {
+        try {
+            VkShaderModule vertexModule = rebuildFirst.vertexShader == path ? shaderModule : GetShaderModule(rebuildFirst.vertexShader);
+            VkShaderModule fragmentModule = rebuildFirst.fragmentShader == path ? shaderModule : GetShaderModule(rebuildFirst.fragmentShader);
+            rebuilt = CreatePipeline(rebuildFirst, vertexModule, fragmentModule, compileMs);
+        }
+        catch (...) {
+            vkDestroyShaderModule(device, shaderModule, allocator);
+            throw;
+        }
+    }
+
+    std::vector<PipelineDesc> removed;
+    for (auto it = pipelines.begin(); it != pipelines.end();) {
+        if (it->first.vertexShader != path && it->first.fragmentShader != path) {
+            ++it;
+            continue;
+        }
+        vkDestroyPipeline(device, it->second, allocator);
+        removed.push_back(it->first);
+        it = pipelines.erase(it);
+        stats.pipelines--;
+    }
+    for (auto it = failedVariants.begin(); it != failedVariants.end();) {
+        if (it->vertexShader != path && it->fragmentShader != path) {
+            ++it;
+            continue;
+        }
+        removed.push_back(*it);
+        it = failedVariants.erase(it);
+    }
+    vkDestroyShaderModule(device, moduleIt->second, allocator);
+    moduleIt->second = shaderModule;
+
+    if (rebuildUsesPath) {
+        pipelines[rebuildFirst] = rebuilt;
+        stats.pipelines++;
+        stats.compileMs += compileMs;
+        stats.longestCompileMs = std::max(stats.longestCompileMs, compileMs);
+    }
+    return removed;
+}
+const PipelineStateCache::Stats& PipelineStateCache::GetStats() const {
+    return stats;
+}
+
+/**
+ * @brief Marks desc as pending and hands it to the compile threads.
+ */
+void PipelineStateCache::Enqueue(const PipelineDesc& desc) {
+    // Shader modules are created here so the compile threads never touch the module map.
+    CompileJob job{ desc, GetShaderModule(desc.vertexShader), GetShaderModule(desc.fragmentShader) };
+    pipelines.emplace(desc, VK_NULL_HANDLE);
+    stats.pending++;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    jobAvailable.notify_one();
+}
+void PipelineStateCache::CompileLoop() {
+    while (true) {
+        CompileJob job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            runningJobs++;
+        }
+
+        CompiledPipeline result{ job.desc };
+        try {
+            result.pipeline = CreatePipeline(job.desc, job.vertexModule, job.fragmentModule, result.compileMs);
+        }
+        catch (...) {
+            result.error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            completed.push_back(std::move(result));
+            runningJobs--;
+        }
+        jobFinished.notify_all();
+    }
+}
+
+/**
+ * @brief Compiles one variant. Runs on the render thread for Get and on a compile thread otherwise.
+ */
+VkPipeline PipelineStateCache::CreatePipeline(const PipelineDesc& desc, VkShaderModule vertexModule, VkShaderModule fragmentModule, double& compileMs) const {
+    // A depth-only pipeline has no fragment stage; rasterization still writes depth.
+    const uint32_t stageCount = fragmentModule != VK_NULL_HANDLE ? 2 : 1;
+    std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages{};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderStages[0].module = vertexModule;
+    shaderStages[0].pName = "main";
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shaderStages[1].module = fragmentModule;
+    shaderStages[1].pName = "main";
+
+    std::array<std::vector<VkSpecializationMapEntry>, 2> mapEntries;
+    std::array<VkSpecializationInfo, 2> specializationInfos{};
+    const std::array<const SpecializationConstants*, 2> stageConstants{ &desc.vertexConstants, &desc.fragmentConstants };
+    for (size_t i = 0; i < stageCount; i++) {
+        if (!stageConstants[i]->Empty()) {
+            specializationInfos[i] = stageConstants[i]->GetInfo(mapEntries[i]);
+            shaderStages[i].pSpecializationInfo = &specializationInfos[i];
+        }
+    }
+
+    auto bindingDescription = desc.positionOnly ? Vertex::GetPositionBindingDescription() : Vertex::GetBindingDescription();
+    auto attributeDescriptions = desc.positionOnly ? Vertex::GetPositionAttributeDescriptions() : Vertex::GetAttributeDescriptions();
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = 1;
+    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    std::vector<VkDynamicState> dynamicStates{ VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    if (desc.dynamicPolygonMode) {
+        dynamicStates.push_back(VK_DYNAMIC_STATE_POLYGON_MODE_EXT);
+    }
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
+
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = VK_FALSE;
+    rasterizer.rasterizerDiscardEnable = VK_FALSE;
+    rasterizer.polygonMode = desc.dynamicPolygonMode ? VK_POLYGON_MODE_FILL : desc.polygonMode;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = desc.cullMode;
+    rasterizer.frontFace = desc.frontFace;
+    rasterizer.depthBiasEnable = VK_FALSE;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.sampleShadingEnable = desc.sampleShading ? VK_TRUE : VK_FALSE;
+    multisampling.rasterizationSamples = desc.samples;
+    multisampling.minSampleShading = 0.2f;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = desc.depthTest ? VK_TRUE : VK_FALSE;
+    depthStencil.depthWriteEnable = desc.depthWrite ? VK_TRUE : VK_FALSE;
+    depthStencil.depthCompareOp = desc.depthCompareOp;
+
+    // The color attachment is still part of the render target, but a depth-only pipeline leaves it untouched.
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    colorBlendAttachment.colorWriteMask = stageCount == 1 ? 0 : VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = desc.alphaBlend ? VK_TRUE : VK_FALSE;
+    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = stageCount;
+    pipelineInfo.pStages = shaderStages.data();
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = desc.layout;
+    pipelineInfo.renderPass = desc.renderPass;
+    pipelineInfo.subpass = desc.subpass;
+
+    // Without a render pass the pipeline names its attachment formats for dynamic rendering.
+    VkPipelineRenderingCreateInfo renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachmentFormats = &desc.colorFormat;
+    renderingInfo.depthAttachmentFormat = desc.depthFormat;
+    renderingInfo.stencilAttachmentFormat = HasStencilComponent(desc.depthFormat) ? desc.depthFormat : VK_FORMAT_UNDEFINED;
+    if (desc.renderPass == VK_NULL_HANDLE) {
+        pipelineInfo.pNext = &renderingInfo;
+    }
+
+    auto compileStart = std::chrono::high_resolution_clock::now();
+    VkPipeline pipeline;
+    if (vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineInfo, allocator, &pipeline) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create graphics pipeline!");
+    }
+    compileMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - compileStart).count();
+    return pipeline;
+}
+/**
+ * @brief Returns the module for path, building it on first use. An empty path has no module.
+ */
+VkShaderModule PipelineStateCache::GetShaderModule(const std::string& path) {
+    if (path.empty()) {
+        return VK_NULL_HANDLE;
+    }
+    auto it = shaderModules.find(path);
+    if (it != shaderModules.end()) {
+        return it->second;
+    }
+
+    VkShaderModule shaderModule = CreateShaderModule(path);
+    shaderModules.emplace(path, shaderModule);
+    return shaderModule;
+}
+VkShaderModule PipelineStateCache::CreateShaderModule(const std::string& path) const {
+    std::span<const uint32_t> code = shaderCompiler->Compile(path);
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = code.size_bytes();
+    moduleInfo.pCode = code.data();
+
+    VkShaderModule shaderModule;
+    if (vkCreateShaderModule(device, &moduleInfo, allocator, &shaderModule) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create shader module for " + path + "!");
+    }
+    return shaderModule;
+}
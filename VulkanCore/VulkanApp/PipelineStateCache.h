@@ -0,0 +1,186 @@
+#pragma once
+
+#include "ShaderCompiler.h"
+#include "Utilities.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+
+/**
+ * @file PipelineStateCache.h
+ * @brief Defines PipelineDesc and the PipelineStateCache class, which creates each graphics pipeline variant once.
+ */
+
+/**
+ * @brief Values for a shader's specialization constants.
+ *
+ * Every constant is 32 bits wide: booleans are stored as VkBool32 and floats by their bit pattern.
+ * The data block handed to Vulkan is then just the values in order, and two sets compare equal
+ * exactly when they specialize a shader the same way.
+ */
+struct SpecializationConstants {
+    std::vector<uint32_t> constantIDs;   ///< constant_id of each value, in ascending order.
+    std::vector<uint32_t> values;
+
+    void Set(uint32_t constantID, bool value);
+    void Set(uint32_t constantID, uint32_t value);
+    void Set(uint32_t constantID, float value);
+    bool Empty() const;
+    VkSpecializationInfo GetInfo(std::vector<VkSpecializationMapEntry>& mapEntries) const;
+
+    bool operator==(const SpecializationConstants&) const = default;
+};
+
+/**
+ * @brief Everything that distinguishes one mesh pipeline variant from another.
+ *
+ * Vertex input comes from Vertex, or from the geometry buffer's position stream for positionOnly
+ * pipelines, and viewport and scissor are always dynamic. Without a fragment shader the pipeline
+ * writes depth only. A null renderPass means the pipeline is built for dynamic rendering with the
+ * given attachment formats.
+ */
+struct PipelineDesc {
+    // Shaders and interface
+    std::string vertexShader;                       ///< Path of the vertex shader's GLSL source or SPIR-V.
+    std::string fragmentShader;                     ///< Path of the fragment shader's GLSL source or SPIR-V; empty for depth only.
+    SpecializationConstants vertexConstants;
+    SpecializationConstants fragmentConstants;      ///< Feature toggles; each set is a branch-free variant.
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    bool positionOnly = false;                      ///< Vertex input is the position stream alone (Vertex::GetPositionBindingDescription).
+
+    // Render target
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    uint32_t subpass = 0;
+    VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    bool sampleShading = false;                     ///< Shade every sample (at a 0.2 minimum rate) instead of every pixel.
+
+    // Rasterization
+    VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+    bool dynamicPolygonMode = false;                ///< Polygon mode is set with vkCmdSetPolygonModeEXT; polygonMode is ignored.
+    VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+    VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+    // Depth and blending
+    bool depthTest = true;
+    bool depthWrite = true;
+    VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS;
+    bool alphaBlend = false;                        ///< Source-alpha over blending on the color attachment.
+
+    bool operator==(const PipelineDesc&) const = default;
+
+    size_t Hash() const;
+};
+
+/**
+ * @class PipelineStateCache
+ * @brief Hands out the VkPipeline for a PipelineDesc, creating it on first request.
+ *
+ * Pipelines are kept in a hash map keyed by their description, so each variant is compiled once
+ * and asking for it again is a single lookup. Shader modules are built once per path, through the
+ * ShaderCompiler, and shared by every variant that uses them. Compiles go through the persistent VkPipelineCache, so a variant
+ * seen on an earlier run is also cheap the first time it is requested.
+ *
+ * Get compiles a missing variant on the spot. GetAsync and Prefetch instead queue it for the
+ * compile threads and GetAsync returns the caller's fallback until it is ready, so a new variant
+ * never stalls the frame. Finished compiles only become visible in PublishCompleted, which the
+ * render thread calls once per frame, so a pipeline never changes halfway through recording.
+ * A queued variant that fails to compile is remembered and not queued again, so GetAsync keeps
+ * returning the fallback instead of retrying it every frame.
+ *
+ * ReloadShader swaps in a shader's current source and drops the variants built from the old one,
+ * which is how shader edits reach a running app.
+ *
+ * Apart from the compile threads, every method must be called from the render thread.
+ */
+class PipelineStateCache {
+public:
+    /**
+     * @brief Lookup and compile counters for the debug overlay.
+     */
+    struct Stats {
+        uint32_t pipelines = 0;      ///< Variants created.
+        uint32_t pending = 0;        ///< Variants queued or compiling.
+        uint64_t lookups = 0;        ///< Calls to Get and GetAsync.
+        uint64_t fallbacks = 0;      ///< GetAsync calls answered with the fallback.
+        double compileMs = 0.0;      ///< Time spent in vkCreateGraphicsPipelines, on any thread.
+        double longestCompileMs = 0.0;
+    };
+
+    PipelineStateCache(VkDevice device, const VkAllocationCallbacks* allocator, VkPipelineCache pipelineCache, ShaderCompiler* shaderCompiler, uint32_t compileThreadCount = 1);
+    ~PipelineStateCache();
+
+    PipelineStateCache(const PipelineStateCache&) = delete;
+    PipelineStateCache& operator=(const PipelineStateCache&) = delete;
+
+    VkPipeline Get(const PipelineDesc& desc);
+    VkPipeline GetAsync(const PipelineDesc& desc, VkPipeline fallback);
+    void Prefetch(const PipelineDesc& desc);
+    uint32_t PublishCompleted();
+    void WaitIdle();
+    void Clear();
+    std::vector<PipelineDesc> ReloadShader(const std::string& path, const PipelineDesc& rebuildFirst);
+
+    const Stats& GetStats() const;
+
+private:
+    struct DescHash {
+        size_t operator()(const PipelineDesc& desc) const { return desc.Hash(); }
+    };
+
+    /**
+     * @brief A variant waiting for a compile thread. Its shader modules are resolved on the render thread.
+     */
+    struct CompileJob {
+        PipelineDesc desc;
+        VkShaderModule vertexModule = VK_NULL_HANDLE;
+        VkShaderModule fragmentModule = VK_NULL_HANDLE;  ///< VK_NULL_HANDLE for a depth-only pipeline.
+    };
+
+    /**
+     * @brief A finished compile, waiting for PublishCompleted.
+     */
+    struct CompiledPipeline {
+        PipelineDesc desc;
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        double compileMs = 0.0;
+        std::exception_ptr error;   ///< Set instead of pipeline if the compile threw.
+    };
+
+    // Vulkan handles
+    VkDevice device = VK_NULL_HANDLE;                 ///< Vulkan logical device handle.
+    const VkAllocationCallbacks* allocator = nullptr; ///< Host allocation callbacks (nullptr for the driver default).
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;   ///< Driver-level cache every compile goes through; internally synchronized.
+    ShaderCompiler* shaderCompiler = nullptr;         ///< Not owned; turns shader paths into SPIR-V.
+
+    // Render thread state
+    std::unordered_map<PipelineDesc, VkPipeline, DescHash> pipelines; ///< VK_NULL_HANDLE while a variant is pending.
+    std::unordered_map<std::string, VkShaderModule> shaderModules;    ///< Keyed by shader path.
+    std::unordered_set<PipelineDesc, DescHash> failedVariants;        ///< Queued compiles that threw; retried after a reload of their shaders.
+    std::exception_ptr deferredError;                                 ///< Failure of another variant seen by Get, rethrown by the next PublishCompleted.
+    Stats stats;
+
+    // Compile threads, guarded by mutex
+    std::vector<std::thread> compileThreads;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;   ///< Signaled when a job is queued or the cache stops.
+    std::condition_variable jobFinished;    ///< Signaled when a compile thread finishes a job.
+    std::deque<CompileJob> jobs;
+    std::vector<CompiledPipeline> completed;
+    uint32_t runningJobs = 0;
+    bool stopping = false;
+
+    uint32_t PublishFinished(std::vector<CompiledPipeline>& failures);
+    void Enqueue(const PipelineDesc& desc);
+    void CompileLoop();
+    VkPipeline CreatePipeline(const PipelineDesc& desc, VkShaderModule vertexModule, VkShaderModule fragmentModule, double& compileMs) const;
+    VkShaderModule GetShaderModule(const std::string& path);
+    VkShaderModule CreateShaderModule(const std::string& path) const;
+};
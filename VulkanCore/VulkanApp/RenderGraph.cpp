@@ -0,0 +1,274 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+
+
+namespace {
+
+constexpr VkAccessFlags WRITE_ACCESS_MASK =
+    VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+bool Covers(VkFlags available, VkFlags required) {
+    return (available & required) == required;
+}
+
+} // namespace
+
+RenderGraph::PassBuilder::PassBuilder(RenderGraph& graph, uint32_t pass)
+    : graph(graph), pass(pass) {
+}
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::Read(ResourceHandle resource, const Access& access) {
+    graph.passes[pass].uses.push_back({ resource, access, VK_IMAGE_LAYOUT_UNDEFINED, false });
+    return *this;
+}
+/**
+ * @param finalLayout Layout the pass leaves the image in, for passes that transition it themselves
+ *        (a render pass's finalLayout). UNDEFINED keeps access.layout.
+ */
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::Write(ResourceHandle resource, const Access& access, VkImageLayout finalLayout) {
+    graph.passes[pass].uses.push_back({ resource, access, finalLayout, true });
+    return *this;
+}
+/**
+ * @brief Keeps the pass even if nothing reads what it writes.
+ */
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::SetSideEffects() {
+    graph.passes[pass].sideEffects = true;
+    return *this;
+}
+
+/**
+ * @brief Forgets the previous frame's passes and resources.
+ */
+void RenderGraph::Reset() {
+    resources.clear();
+    passes.clear();
+    livePasses.clear();
+    passBarriers.clear();
+    exportBarriers = BarrierBatch{};
+}
+/**
+ * @param lastAccess How the image was last used before the graph, and the layout it is in (UNDEFINED if
+ *                   its contents do not matter). The first pass that touches it waits on those stages,
+ *                   which is also how it chains onto a semaphore wait such as the swap chain acquire.
+ *                   A zero stage mask means nothing is pending.
+ */
+RenderGraph::ResourceHandle RenderGraph::ImportImage(const char* name, VkImage image, VkImageAspectFlags aspectMask, const Access& lastAccess) {
+    Resource resource{ name };
+    resource.image = true;
+    resource.imageHandle = image;
+    resource.aspectMask = aspectMask;
+    resource.importAccess = lastAccess;
+    resources.push_back(resource);
+    return static_cast<ResourceHandle>(resources.size() - 1);
+}
+/**
+ * @brief Imports a buffer. Host writes made before submission need no barrier, so it starts with no pending access.
+ */
+RenderGraph::ResourceHandle RenderGraph::ImportBuffer(const char* name, VkBuffer buffer) {
+    Resource resource{ name };
+    resource.buffer = buffer;
+    resources.push_back(resource);
+    return static_cast<ResourceHandle>(resources.size() - 1);
+}
+/**
+ * @brief Marks a resource as used after the graph, e.g. presented or read back by the host.
+ *
+ * Passes that produce it are kept, and it is left in the given state once the last pass has run.
+ */
+void RenderGraph::Export(ResourceHandle resource, const Access& access) {
+    resources[resource].exported = true;
+    resources[resource].exportAccess = access;
+}
+/**
+ * @brief Adds a pass after every pass added so far. Reads see the latest earlier write of a resource.
+ */
+RenderGraph::PassBuilder RenderGraph::AddPass(const char* name, ExecuteFunction execute) {
+    passes.push_back({ name, std::move(execute) });
+    return PassBuilder(*this, static_cast<uint32_t>(passes.size() - 1));
+}
+
+/**
+ * @brief Culls unused passes and works out the barriers in front of each pass.
+ */
+void RenderGraph::Compile() {
+    stats = Stats{};
+    stats.passes = static_cast<uint32_t>(passes.size());
+
+    CullPasses();
+    BuildBarriers();
+}
+/**
+ * @brief Records the live passes, each preceded by its merged barrier, and the export barrier.
+ */
+void RenderGraph::Execute(VkCommandBuffer commandBuffer) const {
+    auto record = [commandBuffer](const BarrierBatch& batch) {
+        if (batch.srcStageMask == 0) {
+            return;
+        }
+        const bool memory = batch.memoryBarrier.srcAccessMask != 0 || batch.memoryBarrier.dstAccessMask != 0;
+        vkCmdPipelineBarrier(commandBuffer, batch.srcStageMask, batch.dstStageMask, 0,
+            memory ? 1 : 0, memory ? &batch.memoryBarrier : nullptr,
+            0, nullptr,
+            static_cast<uint32_t>(batch.imageBarriers.size()), batch.imageBarriers.data());
+    };
+
+    for (size_t i = 0; i < livePasses.size(); i++) {
+        record(passBarriers[i]);
+        passes[livePasses[i]].execute(commandBuffer);
+    }
+    record(exportBarriers);
+}
+
+const RenderGraph::Stats& RenderGraph::GetStats() const {
+    return stats;
+}
+
+/**
+ * @brief Walks the passes backwards from the exports, keeping a pass if it has side effects or
+ *        writes something a later live pass (or the outside world) reads.
+ *
+ * Writes are not assumed to overwrite the whole resource, so an earlier writer of a needed resource
+ * is always kept.
+ */
+void RenderGraph::CullPasses() {
+    std::vector<bool> needed(resources.size());
+    for (size_t i = 0; i < resources.size(); i++) {
+        needed[i] = resources[i].exported;
+    }
+
+    for (size_t i = passes.size(); i-- > 0;) {
+        Pass& pass = passes[i];
+        pass.live = pass.sideEffects || std::any_of(pass.uses.begin(), pass.uses.end(),
+            [&needed](const ResourceUse& use) { return use.write && needed[use.resource]; });
+        if (!pass.live) {
+            continue;
+        }
+        for (const ResourceUse& use : pass.uses) {
+            if (!use.write || (use.access.accessMask & ~WRITE_ACCESS_MASK) != 0) {
+                needed[use.resource] = true;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < passes.size(); i++) {
+        if (passes[i].live) {
+            livePasses.push_back(i);
+        }
+    }
+    stats.culledPasses = stats.passes - static_cast<uint32_t>(livePasses.size());
+}
+/**
+ * @brief Replays the live passes against each resource's state and records the barriers they need.
+ *
+ * All dependencies in front of a pass share one batch, so a pass waits once no matter how many of its
+ * inputs were produced earlier.
+ */
+void RenderGraph::BuildBarriers() {
+    std::vector<ResourceState> states(resources.size());
+    for (size_t i = 0; i < resources.size(); i++) {
+        states[i].writeStages = resources[i].importAccess.stageMask;
+        states[i].writeAccess = resources[i].importAccess.accessMask & WRITE_ACCESS_MASK;
+        states[i].layout = resources[i].importAccess.layout;
+    }
+
+    passBarriers.resize(livePasses.size());
+    for (size_t order = 0; order < livePasses.size(); order++) {
+        const Pass& pass = passes[livePasses[order]];
+        BarrierBatch& batch = passBarriers[order];
+
+        for (const ResourceUse& use : pass.uses) {
+            const Resource& resource = resources[use.resource];
+            ResourceState& state = states[use.resource];
+            AddDependency(batch, resource, state, use.access, use.write);
+        }
+
+        // Writes take effect after the whole pass, so a pass that reads and writes a resource waits only on earlier passes.
+        for (const ResourceUse& use : pass.uses) {
+            ResourceState& state = states[use.resource];
+            if (use.write) {
+                state.writeStages = use.access.stageMask;
+                state.writeAccess = use.access.accessMask & WRITE_ACCESS_MASK;
+                state.readStages = 0;
+                state.visibleStages = 0;
+                state.visibleAccess = 0;
+            }
+            else {
+                state.readStages |= use.access.stageMask;
+            }
+            if (use.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED) {
+                state.layout = use.finalLayout;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < resources.size(); i++) {
+        if (resources[i].exported) {
+            AddDependency(exportBarriers, resources[i], states[i], resources[i].exportAccess, false);
+        }
+    }
+
+    for (const BarrierBatch& batch : passBarriers) {
+        stats.barrierBatches += batch.srcStageMask != 0 ? 1 : 0;
+    }
+    stats.barrierBatches += exportBarriers.srcStageMask != 0 ? 1 : 0;
+}
+/**
+ * @brief Adds whatever one access needs after the resource's current state to a pass's batch.
+ *
+ * A write waits for the last write and every read since (write-after-write, write-after-read). A read
+ * waits for the last write unless an earlier barrier already made it visible to the same stages and
+ * access types. An image whose layout differs from the one the access asks for is transitioned; a
+ * transition counts as a write that the access's stages have seen.
+ */
+void RenderGraph::AddDependency(BarrierBatch& batch, const Resource& resource, ResourceState& state, const Access& access, bool write) {
+    const bool transition = resource.image && access.layout != VK_IMAGE_LAYOUT_UNDEFINED && access.layout != state.layout;
+
+    VkPipelineStageFlags srcStages = 0;
+    VkAccessFlags srcAccess = 0;
+    if (write || transition) {
+        srcStages = state.writeStages | state.readStages;
+        srcAccess = state.writeAccess;
+    }
+    else if (state.writeStages != 0 && access.accessMask != 0
+        && !(Covers(state.visibleStages, access.stageMask) && Covers(state.visibleAccess, access.accessMask))) {
+        srcStages = state.writeStages;
+        srcAccess = state.writeAccess;
+    }
+    if (srcStages == 0 && !transition) {
+        return;
+    }
+
+    batch.srcStageMask |= srcStages != 0 ? srcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    batch.dstStageMask |= access.stageMask != 0 ? access.stageMask : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    if (transition) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = access.accessMask;
+        barrier.oldLayout = state.layout;
+        barrier.newLayout = access.layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = resource.imageHandle;
+        barrier.subresourceRange = { resource.aspectMask, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+        batch.imageBarriers.push_back(barrier);
+        stats.imageBarriers++;
+
+        state.layout = access.layout;
+        state.writeStages = access.stageMask;
+        state.writeAccess = 0;
+        state.readStages = 0;
+    }
+    else {
+        batch.memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        if (srcAccess != 0) {
+            batch.memoryBarrier.srcAccessMask |= srcAccess;
+            batch.memoryBarrier.dstAccessMask |= access.accessMask;
+        }
+        stats.memoryDependencies++;
+    }
+    state.visibleStages |= access.stageMask;
+    state.visibleAccess |= access.accessMask;
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "Utilities.h"
+
+#include <functional>
+
+
+/**
+ * @file RenderGraph.h
+ * @brief Defines the RenderGraph class, which orders a frame's passes and derives the barriers between them.
+ */
+
+/**
+ * @class RenderGraph
+ * @brief Declares a frame as passes that read and write named resources, then compiles and records it.
+ *
+ * Each frame the caller imports the images and buffers it already owns and adds passes in submission
+ * order with the state each one needs its resources in. Compile then:
+ *  - culls passes whose writes nothing live reads, unless they have side effects. Exported resources
+ *    (presented images, buffers read back by the host) are what keeps a chain of passes alive;
+ *  - walks the surviving passes tracking every resource's last write, the stages that have seen it
+ *    and its layout, and folds every hazard in front of a pass into one vkCmdPipelineBarrier: a single
+ *    global memory barrier for everything that needs no layout change, plus an image barrier per
+ *    layout transition. Reads that were already made visible to a stage are not synchronized again.
+ *
+ * Passes that begin a render pass declare the layout the render pass expects as its initial layout
+ * (UNDEFINED when it discards the contents) and the final layout it leaves behind, so the graph only
+ * adds the transitions the render pass does not do itself.
+ *
+ * One graph is kept per frame in flight, so Compile must only be called once the frame's fence has
+ * signaled.
+ */
+class RenderGraph {
+public:
+    using ResourceHandle = uint32_t;
+    using ExecuteFunction = std::function<void(VkCommandBuffer)>;
+
+    /**
+     * @brief How a pass touches a resource: the stages and access types it uses and, for images, the layout.
+     */
+    struct Access {
+        VkPipelineStageFlags stageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        VkAccessFlags accessMask = 0;
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED; ///< UNDEFINED means the pass does not care (or transitions itself).
+    };
+
+    /**
+     * @brief Declares the resources of the pass it was returned for.
+     */
+    class PassBuilder {
+    public:
+        PassBuilder& Read(ResourceHandle resource, const Access& access);
+        PassBuilder& Write(ResourceHandle resource, const Access& access, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED);
+        PassBuilder& SetSideEffects();
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph& graph, uint32_t pass);
+
+        RenderGraph& graph;
+        uint32_t pass;
+    };
+
+    /**
+     * @brief What the last Compile produced, for the debug overlay.
+     */
+    struct Stats {
+        uint32_t passes = 0;               ///< Passes declared.
+        uint32_t culledPasses = 0;         ///< Passes dropped because nothing live uses their output.
+        uint32_t barrierBatches = 0;       ///< vkCmdPipelineBarrier calls recorded.
+        uint32_t imageBarriers = 0;        ///< Layout transitions folded into those calls.
+        uint32_t memoryDependencies = 0;   ///< Hazards folded into the global memory barriers.
+    };
+
+    RenderGraph() = default;
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    void Reset();
+    ResourceHandle ImportImage(const char* name, VkImage image, VkImageAspectFlags aspectMask, const Access& lastAccess);
+    ResourceHandle ImportBuffer(const char* name, VkBuffer buffer);
+    void Export(ResourceHandle resource, const Access& access);
+    PassBuilder AddPass(const char* name, ExecuteFunction execute);
+
+    void Compile();
+    void Execute(VkCommandBuffer commandBuffer) const;
+
+    const Stats& GetStats() const;
+
+private:
+    /**
+     * @brief One resource a pass declared, with the layout it leaves an image in.
+     */
+    struct ResourceUse {
+        ResourceHandle resource;
+        Access access;
+        VkImageLayout finalLayout; ///< Layout after the pass; UNDEFINED keeps access.layout.
+        bool write;
+    };
+
+    struct Pass {
+        const char* name;
+        ExecuteFunction execute;
+        std::vector<ResourceUse> uses;
+        bool sideEffects = false;
+        bool live = false;
+    };
+
+    struct Resource {
+        const char* name;
+        bool image = false;
+        VkImage imageHandle = VK_NULL_HANDLE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkImageAspectFlags aspectMask = 0;
+        Access importAccess{ 0 }; ///< Last access before the graph; a zero stage mask means nothing is pending.
+        bool exported = false;
+        Access exportAccess{};
+    };
+
+    /**
+     * @brief Everything recorded in front of one pass (or after the last one, for exports).
+     */
+    struct BarrierBatch {
+        VkPipelineStageFlags srcStageMask = 0;
+        VkPipelineStageFlags dstStageMask = 0;
+        VkMemoryBarrier memoryBarrier{};
+        std::vector<VkImageMemoryBarrier> imageBarriers;
+    };
+
+    /**
+     * @brief A resource's synchronization state while the live passes are walked.
+     */
+    struct ResourceState {
+        VkPipelineStageFlags writeStages = 0;   ///< Stages of the last write.
+        VkAccessFlags writeAccess = 0;          ///< Access types of the last write.
+        VkPipelineStageFlags readStages = 0;    ///< Stages that read since the last write (for write-after-read).
+        VkPipelineStageFlags visibleStages = 0; ///< Stages the last write has been made visible to.
+        VkAccessFlags visibleAccess = 0;        ///< Access types the last write has been made visible to.
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    };
+
+    // Declared this frame
+    std::vector<Resource> resources;
+    std::vector<Pass> passes;
+
+    // Compiled
+    std::vector<uint32_t> livePasses;            ///< Indices into passes, in execution order.
+    std::vector<BarrierBatch> passBarriers;      ///< One per live pass.
+    BarrierBatch exportBarriers;                 ///< Recorded after the last pass.
+    Stats stats;
+
+    void CullPasses();
+    void BuildBarriers();
+    void AddDependency(BarrierBatch& batch, const Resource& resource, ResourceState& state, const Access& access, bool write);
+};
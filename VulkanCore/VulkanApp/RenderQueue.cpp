@@ -0,0 +1,176 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <random>
+
+
+namespace {
+
+constexpr uint32_t RADIX_BITS = 8;
+constexpr uint32_t RADIX_BUCKETS = 1u << RADIX_BITS;
+constexpr uint32_t RADIX_PASSES = 64 / RADIX_BITS;
+
+uint64_t FieldMask(uint32_t bits) {
+    return (uint64_t{ 1 } << bits) - 1;
+}
+
+} // namespace
+
+/**
+ * @brief Packs draw state and view depth into a sort key. Values wider than their field are truncated.
+ *
+ * @param pass Render pass the draw belongs to; sorts first.
+ * @param pipeline Pipeline the draw is recorded with.
+ * @param material Material (descriptor state) the draw binds.
+ * @param mesh Mesh the draw reads its vertices and indices from.
+ * @param depth View depth normalized to [0, 1]; out-of-range values (including NaN) are clamped.
+ */
+uint64_t RenderQueue::MakeKey(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth) {
+    depth = depth > 0.0f ? std::min(depth, 1.0f) : 0.0f;
+    uint64_t quantizedDepth = static_cast<uint64_t>(static_cast<double>(depth) * static_cast<double>(FieldMask(DEPTH_BITS)));
+
+    return ((pass & FieldMask(PASS_BITS)) << PASS_SHIFT)
+        | ((pipeline & FieldMask(PIPELINE_BITS)) << PIPELINE_SHIFT)
+        | ((material & FieldMask(MATERIAL_BITS)) << MATERIAL_SHIFT)
+        | ((mesh & FieldMask(MESH_BITS)) << MESH_SHIFT)
+        | (quantizedDepth << DEPTH_SHIFT);
+}
+uint32_t RenderQueue::GetPipeline(uint64_t key) {
+    return static_cast<uint32_t>((key >> PIPELINE_SHIFT) & FieldMask(PIPELINE_BITS));
+}
+uint32_t RenderQueue::GetMaterial(uint64_t key) {
+    return static_cast<uint32_t>((key >> MATERIAL_SHIFT) & FieldMask(MATERIAL_BITS));
+}
+uint32_t RenderQueue::GetMesh(uint64_t key) {
+    return static_cast<uint32_t>((key >> MESH_SHIFT) & FieldMask(MESH_BITS));
+}
+
+void RenderQueue::Clear() {
+    items.clear();
+}
+void RenderQueue::Reserve(size_t count) {
+    items.reserve(count);
+    scratch.reserve(count);
+}
+void RenderQueue::Push(uint64_t key, uint32_t index) {
+    items.push_back({ key, index });
+}
+/**
+ * @brief Sorts the queued items by key, keeping items with equal keys in the order they were pushed.
+ *
+ * Least-significant-digit radix sort over 8-bit digits. All eight digit histograms are built in a
+ * single pass over the keys; a digit that is the same in every key leaves the order unchanged, so its
+ * scatter pass is skipped.
+ */
+void RenderQueue::Sort() {
+    const size_t count = items.size();
+    if (count < 2) {
+        return;
+    }
+
+    std::array<std::array<uint32_t, RADIX_BUCKETS>, RADIX_PASSES> histograms{};
+    for (const Item& item : items) {
+        for (uint32_t pass = 0; pass < RADIX_PASSES; pass++) {
+            histograms[pass][(item.key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+
+    scratch.resize(count);
+    std::vector<Item>* source = &items;
+    std::vector<Item>* destination = &scratch;
+    for (uint32_t pass = 0; pass < RADIX_PASSES; pass++) {
+        const uint32_t shift = pass * RADIX_BITS;
+        std::array<uint32_t, RADIX_BUCKETS>& histogram = histograms[pass];
+        if (histogram[((*source)[0].key >> shift) & (RADIX_BUCKETS - 1)] == count) {
+            continue;
+        }
+
+        // Turn the digit counts into the first output position of each digit.
+        uint32_t offset = 0;
+        for (uint32_t& bucket : histogram) {
+            uint32_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+        for (const Item& item : *source) {
+            (*destination)[histogram[(item.key >> shift) & (RADIX_BUCKETS - 1)]++] = item;
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != &items) {
+        items.swap(scratch);
+    }
+}
+const std::vector<RenderQueue::Item>& RenderQueue::GetItems() const {
+    return items;
+}
+
+/**
+ * @brief Times Sort against std::stable_sort on a queue shaped like the renderer's and prints the results.
+ *
+ * Keys use a handful of meshes and random depths, so only the mesh and depth digits vary.
+ */
+void RenderQueue::RunBenchmark(uint32_t itemCount, std::ostream& out) {
+    constexpr uint32_t WARMUP_RUNS = 3;
+    constexpr uint32_t SAMPLE_RUNS = 20;
+    constexpr uint32_t MESH_COUNT = 8;
+
+    std::mt19937 generator(1234);
+    std::uniform_int_distribution<uint32_t> mesh(0, MESH_COUNT - 1);
+    std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+    std::vector<Item> unsorted(itemCount);
+    for (uint32_t i = 0; i < itemCount; i++) {
+        unsorted[i] = { MakeKey(0, 0, 0, mesh(generator), depth(generator)), i };
+    }
+
+    auto stableSort = [](std::vector<Item>& sorted) {
+        std::stable_sort(sorted.begin(), sorted.end(), [](const Item& a, const Item& b) { return a.key < b.key; });
+    };
+    std::vector<Item> reference = unsorted;
+    stableSort(reference);
+
+    out << "Sort benchmark (" << itemCount << " draws, " << MESH_COUNT << " meshes):\n"
+        << std::setw(14) << "Sort" << std::setw(12) << "ms" << std::setw(14) << "Mdraws/s" << "\n";
+
+    double stableSortMs = 0.0;
+    for (bool radix : { false, true }) {
+        RenderQueue queue;
+        queue.Reserve(itemCount);
+        double totalMs = 0.0;
+        for (uint32_t run = 0; run < WARMUP_RUNS + SAMPLE_RUNS; run++) {
+            queue.items = unsorted;
+            auto start = std::chrono::high_resolution_clock::now();
+            if (radix) {
+                queue.Sort();
+            }
+            else {
+                stableSort(queue.items);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            if (run >= WARMUP_RUNS) {
+                totalMs += std::chrono::duration<double, std::milli>(end - start).count();
+            }
+        }
+        double ms = totalMs / SAMPLE_RUNS;
+        if (!radix) {
+            stableSortMs = ms;
+        }
+
+        out << std::setw(14) << (radix ? "Radix" : "std::stable")
+            << std::setw(12) << std::fixed << std::setprecision(3) << ms
+            << std::setw(14) << std::setprecision(1) << itemCount / (ms * 1000.0);
+        if (radix && ms > 0.0) {
+            out << "  (" << std::setprecision(2) << stableSortMs / ms << "x)";
+        }
+        bool matches = std::equal(queue.items.begin(), queue.items.end(), reference.begin(), reference.end(),
+            [](const Item& a, const Item& b) { return a.key == b.key && a.index == b.index; });
+        if (!matches) {
+            out << "  MISMATCH";
+        }
+        out << "\n";
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Utilities.h"
+
+
+/**
+ * @file RenderQueue.h
+ * @brief Defines the RenderQueue class, which orders draws by a packed 64-bit sort key.
+ */
+
+/**
+ * @class RenderQueue
+ * @brief Collects draw items under 64-bit sort keys and orders them with an LSD radix sort.
+ *
+ * A key packs, from the most significant bits down: pass, pipeline, material, mesh and quantized
+ * view depth. Sorting by it groups draws that share state, so consecutive draws rarely need anything
+ * rebound, and orders draws that share all of it front to back so early depth testing rejects
+ * hidden fragments. The sort is stable and linear in the item count; byte columns that are equal in
+ * every key are detected up front and skipped, so fields that never vary across the queue cost no
+ * scatter pass.
+ */
+class RenderQueue {
+public:
+    /**
+     * @brief One queued draw: its sort key and the caller's index for it.
+     */
+    struct Item {
+        uint64_t key;   ///< Packed sort key (see MakeKey).
+        uint32_t index; ///< Caller-defined payload, e.g. the scene index of the model.
+    };
+
+    static constexpr uint32_t PASS_BITS = 4;
+    static constexpr uint32_t PIPELINE_BITS = 8;
+    static constexpr uint32_t MATERIAL_BITS = 12;
+    static constexpr uint32_t MESH_BITS = 16;
+    static constexpr uint32_t DEPTH_BITS = 24;
+
+    static uint64_t MakeKey(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+    static uint32_t GetPipeline(uint64_t key);
+    static uint32_t GetMaterial(uint64_t key);
+    static uint32_t GetMesh(uint64_t key);
+
+    void Clear();
+    void Reserve(size_t count);
+    void Push(uint64_t key, uint32_t index);
+    void Sort();
+
+    const std::vector<Item>& GetItems() const;
+
+    static void RunBenchmark(uint32_t itemCount, std::ostream& out);
+
+private:
+    static constexpr uint32_t DEPTH_SHIFT = 0;
+    static constexpr uint32_t MESH_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+    static constexpr uint32_t MATERIAL_SHIFT = MESH_SHIFT + MESH_BITS;
+    static constexpr uint32_t PIPELINE_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+    static constexpr uint32_t PASS_SHIFT = PIPELINE_SHIFT + PIPELINE_BITS;
+    static_assert(PASS_SHIFT + PASS_BITS == 64, "Sort key fields must fill 64 bits.");
+
+    std::vector<Item> items;   ///< Queued draws, in key order after Sort.
+    std::vector<Item> scratch; ///< Ping-pong buffer for the radix passes.
+};
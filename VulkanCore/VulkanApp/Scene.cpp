@@ -0,0 +1,582 @@
+#include "Scene.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <random>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+// SSE2 is part of every x86-64 target, so the kernels need no runtime dispatch.
+#define SCENE_SIMD
+#include <immintrin.h>
+#endif
+
+
+namespace {
+
+/**
+ * @brief Builds a matrix the way Model::GetModelMatrix did, from Euler angles in degrees.
+ *
+ * Only the benchmark's pointer baseline uses this; the scene itself composes from quaternions.
+ */
+glm::mat4 ComposeEulerTransform(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale) {
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+    model = glm::rotate(model, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+    model = glm::rotate(model, glm::radians(rotation.y), glm::vec3(0.0f, -1.0f, 0.0f));
+    model = glm::rotate(model, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+    return glm::scale(model, scale);
+}
+
+#if defined(SCENE_SIMD)
+/**
+ * @brief Returns (v[X], v[Y], v[Z], v[W]).
+ */
+template <int X, int Y, int Z, int W>
+__m128 Swizzle(__m128 v) {
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X));
+}
+
+/**
+ * @brief Writes translation * rotation * scale into out with SSE.
+ *
+ * Each rotation column is 1-or-0 plus two products of quaternion components, e.g. column 0 is
+ * (1 - 2yy - 2zz, 2xy + 2wz, 2xz - 2wy). The products are formed with shuffles and combined with
+ * per-lane signs, so no lane needs a scalar special case.
+ */
+void ComposeTransform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale, glm::mat4& out) {
+    const __m128 q = _mm_set_ps(rotation.w, rotation.z, rotation.y, rotation.x);
+    const __m128 q2 = _mm_add_ps(q, q);
+
+    __m128 column0 = _mm_add_ps(_mm_set_ps(0.0f, 0.0f, 0.0f, 1.0f), _mm_add_ps(
+        _mm_mul_ps(_mm_mul_ps(Swizzle<1, 0, 0, 3>(q), Swizzle<1, 1, 2, 3>(q2)), _mm_set_ps(0.0f, 1.0f, 1.0f, -1.0f)),
+        _mm_mul_ps(_mm_mul_ps(Swizzle<2, 3, 3, 3>(q), Swizzle<2, 2, 1, 3>(q2)), _mm_set_ps(0.0f, -1.0f, 1.0f, -1.0f))));
+    __m128 column1 = _mm_add_ps(_mm_set_ps(0.0f, 0.0f, 1.0f, 0.0f), _mm_add_ps(
+        _mm_mul_ps(_mm_mul_ps(Swizzle<0, 0, 1, 3>(q), Swizzle<1, 0, 2, 3>(q2)), _mm_set_ps(0.0f, 1.0f, -1.0f, 1.0f)),
+        _mm_mul_ps(_mm_mul_ps(Swizzle<3, 2, 3, 3>(q), Swizzle<2, 2, 0, 3>(q2)), _mm_set_ps(0.0f, 1.0f, -1.0f, -1.0f))));
+    __m128 column2 = _mm_add_ps(_mm_set_ps(0.0f, 1.0f, 0.0f, 0.0f), _mm_add_ps(
+        _mm_mul_ps(_mm_mul_ps(Swizzle<0, 1, 0, 3>(q), Swizzle<2, 2, 0, 3>(q2)), _mm_set_ps(0.0f, -1.0f, 1.0f, 1.0f)),
+        _mm_mul_ps(_mm_mul_ps(Swizzle<3, 3, 1, 3>(q), Swizzle<1, 0, 1, 3>(q2)), _mm_set_ps(0.0f, -1.0f, -1.0f, 1.0f))));
+
+    _mm_storeu_ps(&out[0][0], _mm_mul_ps(column0, _mm_set1_ps(scale.x)));
+    _mm_storeu_ps(&out[1][0], _mm_mul_ps(column1, _mm_set1_ps(scale.y)));
+    _mm_storeu_ps(&out[2][0], _mm_mul_ps(column2, _mm_set1_ps(scale.z)));
+    _mm_storeu_ps(&out[3][0], _mm_set_ps(1.0f, position.z, position.y, position.x));
+}
+
+/**
+ * @brief Writes lhs * rhs into out with SSE. out may alias either operand.
+ */
+void Multiply(const glm::mat4& lhs, const glm::mat4& rhs, glm::mat4& out) {
+    const __m128 lhs0 = _mm_loadu_ps(&lhs[0][0]);
+    const __m128 lhs1 = _mm_loadu_ps(&lhs[1][0]);
+    const __m128 lhs2 = _mm_loadu_ps(&lhs[2][0]);
+    const __m128 lhs3 = _mm_loadu_ps(&lhs[3][0]);
+    __m128 rhsColumns[4] = {
+        _mm_loadu_ps(&rhs[0][0]), _mm_loadu_ps(&rhs[1][0]), _mm_loadu_ps(&rhs[2][0]), _mm_loadu_ps(&rhs[3][0])
+    };
+
+    // Column j of the product is lhs weighted by the components of rhs column j.
+    for (int column = 0; column < 4; column++) {
+        __m128 r = rhsColumns[column];
+        __m128 result = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(lhs0, Swizzle<0, 0, 0, 0>(r)), _mm_mul_ps(lhs1, Swizzle<1, 1, 1, 1>(r))),
+            _mm_add_ps(_mm_mul_ps(lhs2, Swizzle<2, 2, 2, 2>(r)), _mm_mul_ps(lhs3, Swizzle<3, 3, 3, 3>(r))));
+        _mm_storeu_ps(&out[column][0], result);
+    }
+}
+#else
+void ComposeTransform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale, glm::mat4& out) {
+    glm::mat3 rotationMatrix = glm::mat3_cast(rotation);
+    out = glm::mat4(
+        glm::vec4(rotationMatrix[0] * scale.x, 0.0f),
+        glm::vec4(rotationMatrix[1] * scale.y, 0.0f),
+        glm::vec4(rotationMatrix[2] * scale.z, 0.0f),
+        glm::vec4(position, 1.0f));
+}
+void Multiply(const glm::mat4& lhs, const glm::mat4& rhs, glm::mat4& out) {
+    out = lhs * rhs;
+}
+#endif
+
+/**
+ * @brief Moves a mesh-space bounding sphere into world space.
+ *
+ * The radius is scaled by the longest basis vector of the world matrix, so the sphere still
+ * encloses the mesh under non-uniform scaling anywhere in the hierarchy.
+ */
+glm::vec4 TransformBounds(const glm::mat4& world, const glm::vec4& localSphere) {
+    float maxScaleSquared = std::max({
+        glm::dot(glm::vec3(world[0]), glm::vec3(world[0])),
+        glm::dot(glm::vec3(world[1]), glm::vec3(world[1])),
+        glm::dot(glm::vec3(world[2]), glm::vec3(world[2]))
+    });
+    return glm::vec4(glm::vec3(world * glm::vec4(glm::vec3(localSphere), 1.0f)), localSphere.w * std::sqrt(maxScaleSquared));
+}
+
+} // namespace
+
+
+/**
+ * @brief Creates a root entity with an identity rotation and unit scale.
+ *
+ * @param mesh Mesh to draw, or nullptr for an entity with a zero-radius bound that is never drawn.
+ * @param texture Texture the mesh is drawn with.
+ * @param position Initial world-space position.
+ * @return Handle to the new entity.
+ */
+Entity Scene::CreateEntity(Mesh* mesh, Texture* texture, const glm::vec3& position) {
+    Entity entity{};
+    if (!freeSlots.empty()) {
+        entity.index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        entity.index = static_cast<uint32_t>(slotGenerations.size());
+        slotGenerations.push_back(0);
+        slotDenseIndices.push_back(0);
+    }
+    entity.generation = slotGenerations[entity.index];
+
+    uint32_t denseIndex = GetEntityCount();
+    slotDenseIndices[entity.index] = denseIndex;
+
+    denseSlots.push_back(entity.index);
+    positions.push_back(position);
+    rotations.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    scales.push_back(glm::vec3(1.0f));
+    parentSlots.push_back(Entity::INVALID_INDEX);
+    childCounts.push_back(0);
+    worldMatrices.push_back(glm::mat4(1.0f));
+    localBounds.push_back(mesh ? mesh->GetBoundingSphere() : glm::vec4(0.0f));
+    worldBounds.Add(glm::vec4(0.0f));
+    meshes.push_back(mesh);
+    textures.push_back(texture);
+    transformDirty.push_back(0);
+    MarkDirty(denseIndex);
+    hierarchyChanged = true;
+    return entity;
+}
+/**
+ * @brief Destroys an entity, moving the last entity into its dense index.
+ *
+ * Children of the entity become roots and keep their local transform.
+ *
+ * @throws std::runtime_error if the entity has already been destroyed.
+ */
+void Scene::DestroyEntity(Entity entity) {
+    uint32_t denseIndex = GetDenseIndex(entity);
+    uint32_t lastIndex = GetEntityCount() - 1;
+
+    if (childCounts[denseIndex] > 0) {
+        for (uint32_t i = 0; i <= lastIndex; i++) {
+            if (parentSlots[i] == entity.index) {
+                parentSlots[i] = Entity::INVALID_INDEX;
+                MarkDirty(i);
+            }
+        }
+    }
+    if (parentSlots[denseIndex] != Entity::INVALID_INDEX) {
+        childCounts[slotDenseIndices[parentSlots[denseIndex]]]--;
+    }
+
+    if (denseIndex != lastIndex) {
+        uint32_t movedSlot = denseSlots[lastIndex];
+        denseSlots[denseIndex] = movedSlot;
+        positions[denseIndex] = positions[lastIndex];
+        rotations[denseIndex] = rotations[lastIndex];
+        scales[denseIndex] = scales[lastIndex];
+        parentSlots[denseIndex] = parentSlots[lastIndex];
+        childCounts[denseIndex] = childCounts[lastIndex];
+        worldMatrices[denseIndex] = worldMatrices[lastIndex];
+        localBounds[denseIndex] = localBounds[lastIndex];
+        meshes[denseIndex] = meshes[lastIndex];
+        textures[denseIndex] = textures[lastIndex];
+        transformDirty[denseIndex] = transformDirty[lastIndex];
+        slotDenseIndices[movedSlot] = denseIndex;
+    }
+    // FrustumCuller performs the same swap-and-pop on its own arrays.
+    worldBounds.Remove(denseIndex);
+
+    denseSlots.pop_back();
+    positions.pop_back();
+    rotations.pop_back();
+    scales.pop_back();
+    parentSlots.pop_back();
+    childCounts.pop_back();
+    worldMatrices.pop_back();
+    localBounds.pop_back();
+    meshes.pop_back();
+    textures.pop_back();
+    transformDirty.pop_back();
+
+    slotGenerations[entity.index]++;
+    freeSlots.push_back(entity.index);
+    hierarchyChanged = true;
+    version++;
+}
+bool Scene::IsAlive(Entity entity) const {
+    // Destroying an entity bumps its slot's generation, so a free slot never matches a handle.
+    return entity.index < slotGenerations.size() && slotGenerations[entity.index] == entity.generation;
+}
+/**
+ * @brief Destroys every entity. Existing handles become stale.
+ */
+void Scene::Clear() {
+    for (uint32_t slot : denseSlots) {
+        slotGenerations[slot]++;
+        freeSlots.push_back(slot);
+    }
+    denseSlots.clear();
+    positions.clear();
+    rotations.clear();
+    scales.clear();
+    parentSlots.clear();
+    childCounts.clear();
+    worldMatrices.clear();
+    localBounds.clear();
+    worldBounds.Clear();
+    meshes.clear();
+    textures.clear();
+    transformDirty.clear();
+    anyTransformDirty = false;
+    hierarchyChanged = true;
+    version++;
+}
+
+void Scene::SetPosition(Entity entity, const glm::vec3& position) {
+    uint32_t denseIndex = GetDenseIndex(entity);
+    positions[denseIndex] = position;
+    MarkDirty(denseIndex);
+}
+const glm::vec3& Scene::GetPosition(Entity entity) const {
+    return positions[GetDenseIndex(entity)];
+}
+/**
+ * @brief Sets the rotation from Euler angles in degrees, applied X, then Y, then Z as Model did.
+ */
+void Scene::SetRotation(Entity entity, const glm::vec3& eulerDegrees) {
+    SetRotation(entity,
+        glm::angleAxis(glm::radians(eulerDegrees.x), glm::vec3(1.0f, 0.0f, 0.0f)) *
+        glm::angleAxis(glm::radians(eulerDegrees.y), glm::vec3(0.0f, -1.0f, 0.0f)) *
+        glm::angleAxis(glm::radians(eulerDegrees.z), glm::vec3(0.0f, 0.0f, 1.0f)));
+}
+void Scene::SetRotation(Entity entity, const glm::quat& rotation) {
+    uint32_t denseIndex = GetDenseIndex(entity);
+    rotations[denseIndex] = glm::normalize(rotation);
+    MarkDirty(denseIndex);
+}
+void Scene::SetScale(Entity entity, const glm::vec3& scale) {
+    uint32_t denseIndex = GetDenseIndex(entity);
+    scales[denseIndex] = scale;
+    MarkDirty(denseIndex);
+}
+/**
+ * @brief Recomputes the world matrix and world bounds of every dirty entity and its descendants.
+ *
+ * Levels run in order so a parent's world matrix is final before its children read it. Entities
+ * within a level do not depend on each other, so levels larger than PARALLEL_BATCH_SIZE are split
+ * across the thread pool. Call once per frame before reading GetWorldMatrices or GetBounds.
+ *
+ * @param threadPool Pool to split large levels across, or nullptr to run on the calling thread.
+ */
+void Scene::UpdateTransforms(ThreadPool* threadPool) {
+    if (!anyTransformDirty) {
+        return;
+    }
+    if (hierarchyChanged) {
+        RebuildUpdateOrder();
+    }
+
+    for (size_t level = 0; level + 1 < levelOffsets.size(); level++) {
+        uint32_t begin = levelOffsets[level];
+        uint32_t end = levelOffsets[level + 1];
+        if (threadPool != nullptr && end - begin > PARALLEL_BATCH_SIZE) {
+            threadPool->ParallelFor(end - begin, PARALLEL_BATCH_SIZE, [this, begin](uint32_t first, uint32_t last) {
+                UpdateRange(begin + first, begin + last);
+            });
+        }
+        else {
+            UpdateRange(begin, end);
+        }
+    }
+
+    std::fill(transformDirty.begin(), transformDirty.end(), uint8_t(0));
+    anyTransformDirty = false;
+}
+
+/**
+ * @brief Parents an entity to another, or makes it a root when parent is a default Entity.
+ *
+ * The child's transform becomes relative to the parent; it is not adjusted to keep its world position.
+ *
+ * @throws std::runtime_error if either handle is stale or the parent is the child or one of its descendants.
+ */
+void Scene::SetParent(Entity child, Entity parent) {
+    uint32_t childIndex = GetDenseIndex(child);
+    uint32_t parentSlot = Entity::INVALID_INDEX;
+
+    if (parent.index != Entity::INVALID_INDEX) {
+        GetDenseIndex(parent);
+        for (uint32_t slot = parent.index; slot != Entity::INVALID_INDEX; slot = parentSlots[slotDenseIndices[slot]]) {
+            if (slot == child.index) {
+                throw std::runtime_error("SetParent would create a cycle in the transform hierarchy.");
+            }
+        }
+        parentSlot = parent.index;
+    }
+
+    if (parentSlots[childIndex] != Entity::INVALID_INDEX) {
+        childCounts[slotDenseIndices[parentSlots[childIndex]]]--;
+    }
+    if (parentSlot != Entity::INVALID_INDEX) {
+        childCounts[slotDenseIndices[parentSlot]]++;
+    }
+    parentSlots[childIndex] = parentSlot;
+    MarkDirty(childIndex);
+    hierarchyChanged = true;
+}
+Entity Scene::GetParent(Entity entity) const {
+    uint32_t parentSlot = parentSlots[GetDenseIndex(entity)];
+    if (parentSlot == Entity::INVALID_INDEX) {
+        return Entity{};
+    }
+    return Entity{ parentSlot, slotGenerations[parentSlot] };
+}
+
+uint32_t Scene::GetEntityCount() const {
+    return static_cast<uint32_t>(denseSlots.size());
+}
+Entity Scene::GetEntity(uint32_t denseIndex) const {
+    uint32_t slot = denseSlots[denseIndex];
+    return Entity{ slot, slotGenerations[slot] };
+}
+const std::vector<glm::mat4>& Scene::GetWorldMatrices() const {
+    return worldMatrices;
+}
+const std::vector<Mesh*>& Scene::GetMeshes() const {
+    return meshes;
+}
+const std::vector<Texture*>& Scene::GetTextures() const {
+    return textures;
+}
+const FrustumCuller& Scene::GetBounds() const {
+    return worldBounds;
+}
+uint64_t Scene::GetVersion() const {
+    return version;
+}
+
+/**
+ * @throws std::runtime_error if the handle is stale or was never created by this scene.
+ */
+uint32_t Scene::GetDenseIndex(Entity entity) const {
+    if (!IsAlive(entity)) {
+        throw std::runtime_error("Entity handle is stale or invalid.");
+    }
+    return slotDenseIndices[entity.index];
+}
+void Scene::MarkDirty(uint32_t denseIndex) {
+    transformDirty[denseIndex] = 1;
+    anyTransformDirty = true;
+    version++;
+}
+/**
+ * @brief Sorts the dense indices by hierarchy depth (a counting sort), recording where each level starts.
+ *
+ * Roots come first in dense order, so a scene without parenting updates in plain array order.
+ */
+void Scene::RebuildUpdateOrder() {
+    const uint32_t count = GetEntityCount();
+    constexpr uint32_t UNKNOWN_DEPTH = UINT32_MAX;
+
+    // Depth of every entity, memoized so each parent chain is walked once.
+    std::vector<uint32_t> depths(count, UNKNOWN_DEPTH);
+    std::vector<uint32_t> chain;
+    uint32_t maxDepth = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t current = i;
+        chain.clear();
+        while (depths[current] == UNKNOWN_DEPTH && parentSlots[current] != Entity::INVALID_INDEX) {
+            chain.push_back(current);
+            current = slotDenseIndices[parentSlots[current]];
+        }
+        if (depths[current] == UNKNOWN_DEPTH) {
+            depths[current] = 0;
+        }
+        uint32_t depth = depths[current];
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            depths[*it] = ++depth;
+        }
+        maxDepth = std::max(maxDepth, depth);
+    }
+
+    levelOffsets.assign(count > 0 ? maxDepth + 2 : 1, 0);
+    for (uint32_t depth : depths) {
+        levelOffsets[depth + 1]++;
+    }
+    for (size_t level = 1; level < levelOffsets.size(); level++) {
+        levelOffsets[level] += levelOffsets[level - 1];
+    }
+
+    updateOrder.resize(count);
+    std::vector<uint32_t> cursors(levelOffsets.begin(), levelOffsets.end() - 1);
+    for (uint32_t i = 0; i < count; i++) {
+        updateOrder[cursors[depths[i]]++] = i;
+    }
+    hierarchyChanged = false;
+}
+/**
+ * @brief Updates the entities in updateOrder[begin, end), which must all be on one level.
+ *
+ * A child is rebuilt when its parent was, and is marked dirty so its own children follow. Only
+ * the entity's own dirty flag is written, so ranges of the same level can run concurrently.
+ */
+void Scene::UpdateRange(uint32_t begin, uint32_t end) {
+    glm::mat4 local;
+    for (uint32_t k = begin; k < end; k++) {
+        uint32_t i = updateOrder[k];
+        uint32_t parentSlot = parentSlots[i];
+
+        if (parentSlot == Entity::INVALID_INDEX) {
+            if (!transformDirty[i]) {
+                continue;
+            }
+            ComposeTransform(positions[i], rotations[i], scales[i], worldMatrices[i]);
+        }
+        else {
+            uint32_t parentIndex = slotDenseIndices[parentSlot];
+            if (!transformDirty[i] && !transformDirty[parentIndex]) {
+                continue;
+            }
+            transformDirty[i] = 1;
+            ComposeTransform(positions[i], rotations[i], scales[i], local);
+            Multiply(worldMatrices[parentIndex], local, worldMatrices[i]);
+        }
+        worldBounds.Set(i, TransformBounds(worldMatrices[i], localBounds[i]));
+    }
+}
+
+/**
+ * @brief Compares per-frame scene loops against the previous vector<unique_ptr<Model>> layout.
+ *
+ * Runs entirely on the CPU with entities that have no mesh or texture. The pointer baseline holds
+ * the same fields the old Model did, one heap object each, visited in shuffled order to mimic a
+ * list whose allocations no longer follow its order after models come and go. Each pass moves every
+ * entity and rebuilds its matrix and bounds, then gathers the matrices as UpdateInstanceBuffer does.
+ * The scene update is timed on the calling thread and again split across a ThreadPool.
+ *
+ * @param entityCount Number of entities to create.
+ * @param out Stream the results are written to.
+ */
+void Scene::RunBenchmark(uint32_t entityCount, std::ostream& out) {
+    constexpr uint32_t SAMPLE_PASSES = 20;
+
+    struct PointerModel {
+        std::shared_ptr<Mesh> mesh;
+        std::shared_ptr<Texture> texture;
+        glm::vec3 position{ 0.0f };
+        glm::vec3 rotation{ 0.0f };
+        glm::vec3 scale{ 1.0f };
+        glm::mat4 modelMatrix{ 1.0f };
+        glm::vec4 worldBoundingSphere{ 0.0f };
+        bool boundsChanged = true;
+    };
+
+    using Clock = std::chrono::high_resolution_clock;
+    auto elapsedMs = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+    std::vector<InstanceData> instances(entityCount);
+    const glm::vec3 step(0.01f, 0.0f, 0.0f);
+
+    // Pointer baseline.
+    std::vector<std::unique_ptr<PointerModel>> pointerModels;
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < entityCount; i++) {
+        pointerModels.push_back(std::make_unique<PointerModel>());
+        pointerModels.back()->position = glm::vec3(position(generator), 0.0f, position(generator));
+    }
+    double pointerCreateMs = elapsedMs(start);
+    std::shuffle(pointerModels.begin(), pointerModels.end(), generator);
+
+    start = Clock::now();
+    for (uint32_t pass = 0; pass < SAMPLE_PASSES; pass++) {
+        for (auto& model : pointerModels) {
+            model->position += step;
+            model->modelMatrix = ComposeEulerTransform(model->position, model->rotation, model->scale);
+            model->worldBoundingSphere = TransformBounds(model->modelMatrix, glm::vec4(0.0f));
+            model->boundsChanged = true;
+        }
+    }
+    double pointerUpdateMs = elapsedMs(start) / SAMPLE_PASSES;
+
+    start = Clock::now();
+    for (uint32_t pass = 0; pass < SAMPLE_PASSES; pass++) {
+        for (size_t i = 0; i < pointerModels.size(); i++) {
+            instances[i].model = pointerModels[i]->modelMatrix;
+        }
+    }
+    double pointerGatherMs = elapsedMs(start) / SAMPLE_PASSES;
+
+    // Scene.
+    Scene scene;
+    std::vector<Entity> entities;
+    start = Clock::now();
+    for (uint32_t i = 0; i < entityCount; i++) {
+        entities.push_back(scene.CreateEntity(nullptr, nullptr, glm::vec3(position(generator), 0.0f, position(generator))));
+    }
+    scene.UpdateTransforms();
+    double sceneCreateMs = elapsedMs(start);
+
+    start = Clock::now();
+    for (uint32_t pass = 0; pass < SAMPLE_PASSES; pass++) {
+        for (uint32_t i = 0; i < scene.GetEntityCount(); i++) {
+            scene.positions[i] += step;
+            scene.MarkDirty(i);
+        }
+        scene.UpdateTransforms();
+    }
+    double sceneUpdateMs = elapsedMs(start) / SAMPLE_PASSES;
+
+    ThreadPool threadPool;
+    start = Clock::now();
+    for (uint32_t pass = 0; pass < SAMPLE_PASSES; pass++) {
+        for (uint32_t i = 0; i < scene.GetEntityCount(); i++) {
+            scene.positions[i] += step;
+            scene.MarkDirty(i);
+        }
+        scene.UpdateTransforms(&threadPool);
+    }
+    double sceneParallelUpdateMs = elapsedMs(start) / SAMPLE_PASSES;
+
+    start = Clock::now();
+    for (uint32_t pass = 0; pass < SAMPLE_PASSES; pass++) {
+        const std::vector<glm::mat4>& matrices = scene.GetWorldMatrices();
+        for (size_t i = 0; i < matrices.size(); i++) {
+            instances[i].model = matrices[i];
+        }
+    }
+    double sceneGatherMs = elapsedMs(start) / SAMPLE_PASSES;
+
+    // Destroy half the entities in random order through their handles.
+    std::shuffle(entities.begin(), entities.end(), generator);
+    start = Clock::now();
+    for (uint32_t i = 0; i < entityCount / 2; i++) {
+        scene.DestroyEntity(entities[i]);
+    }
+    double sceneDestroyMs = elapsedMs(start);
+
+    out << "Scene benchmark (" << entityCount << " entities, ms):\n"
+        << std::setw(10) << "Pass" << std::setw(12) << "Pointers" << std::setw(12) << "Scene" << "\n"
+        << std::fixed << std::setprecision(3)
+        << std::setw(10) << "Create" << std::setw(12) << pointerCreateMs << std::setw(12) << sceneCreateMs << "\n"
+        << std::setw(10) << "Update" << std::setw(12) << pointerUpdateMs << std::setw(12) << sceneUpdateMs << "\n"
+        << std::setw(10) << "Update MT" << std::setw(12) << "-" << std::setw(12) << sceneParallelUpdateMs
+        << "  (" << threadPool.GetWorkerCount() + 1 << " threads)\n"
+        << std::setw(10) << "Gather" << std::setw(12) << pointerGatherMs << std::setw(12) << sceneGatherMs << "\n"
+        << "Destroying " << entityCount / 2 << " random entities: " << sceneDestroyMs << " ms ("
+        << scene.GetEntityCount() << " left)\n";
+}
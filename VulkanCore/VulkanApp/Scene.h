@@ -0,0 +1,123 @@
+#pragma once
+
+#include "FrustumCuller.h"
+#include "Mesh.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+
+
+/**
+ * @file Scene.h
+ * @brief Defines the Scene class, a data-oriented store of every placed model and its components.
+ */
+
+/**
+ * @brief Per-instance data written to the per-frame instance storage buffer.
+ *
+ * The vertex shaders read one entry per drawn instance, at the index the culling pass stored in
+ * the visible-instance list for it (visible.indices[gl_InstanceIndex]).
+ */
+struct InstanceData {
+    glm::mat4 model;       ///< Model transformation matrix (position, rotation, and scale).
+    uint32_t textureIndex; ///< Element of the bindless texture array the fragment shader samples.
+    uint32_t padding[3];   ///< Pads the entry to the std430 array stride of 80 bytes.
+};
+
+/**
+ * @brief Generational handle to an entity in a Scene.
+ *
+ * The index names a slot in the scene's sparse table. Destroying an entity bumps the slot's
+ * generation, so stale handles are detected instead of silently addressing the slot's next owner.
+ */
+struct Entity {
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    uint32_t index = INVALID_INDEX; ///< Slot in the sparse table.
+    uint32_t generation = 0;        ///< Generation the slot had when the entity was created.
+
+    bool operator==(const Entity& other) const = default;
+};
+
+/**
+ * @class Scene
+ * @brief Stores each entity's components in dense, parallel arrays.
+ *
+ * Transforms, world matrices, bounds, meshes and textures each live in their own contiguous array,
+ * all indexed by the same dense index, so per-frame loops stream through memory instead of chasing
+ * one heap allocation per model. Removal moves the last entity into the freed dense index, keeping
+ * the arrays packed; entity handles stay valid because they resolve through the sparse table.
+ *
+ * Entities may be parented to other entities. Setters only mark the local transform dirty; once per
+ * frame UpdateTransforms walks the hierarchy level by level, parents before children, and rebuilds
+ * the world matrix of every dirty entity and of everything below it. Each level is independent, so
+ * large levels are split across a ThreadPool.
+ *
+ * Every mutation bumps a version counter, so callers can keep data derived from the scene (instance
+ * buffers, recorded draws) until GetVersion reports a change.
+ *
+ * Meshes and textures are not owned; the renderer's caches keep them alive for the scene's lifetime.
+ */
+class Scene {
+public:
+    Entity CreateEntity(Mesh* mesh, Texture* texture, const glm::vec3& position = glm::vec3(0.0f));
+    void DestroyEntity(Entity entity);
+    bool IsAlive(Entity entity) const;
+    void Clear();
+
+    // === Transform Components (local to the parent) ===
+    void SetPosition(Entity entity, const glm::vec3& position);
+    const glm::vec3& GetPosition(Entity entity) const;
+    void SetRotation(Entity entity, const glm::vec3& eulerDegrees);
+    void SetRotation(Entity entity, const glm::quat& rotation);
+    void SetScale(Entity entity, const glm::vec3& scale);
+    void UpdateTransforms(ThreadPool* threadPool = nullptr);
+
+    // === Hierarchy ===
+    void SetParent(Entity child, Entity parent);
+    Entity GetParent(Entity entity) const;
+
+    // === Dense Access (indexed 0 .. GetEntityCount() - 1) ===
+    uint32_t GetEntityCount() const;
+    Entity GetEntity(uint32_t denseIndex) const;
+    const std::vector<glm::mat4>& GetWorldMatrices() const;
+    const std::vector<Mesh*>& GetMeshes() const;
+    const std::vector<Texture*>& GetTextures() const;
+    const FrustumCuller& GetBounds() const;
+    uint64_t GetVersion() const;
+
+    static void RunBenchmark(uint32_t entityCount, std::ostream& out);
+
+private:
+    static constexpr uint32_t PARALLEL_BATCH_SIZE = 1024; ///< Entities per thread pool batch; smaller levels run inline.
+
+    // Sparse table: entity slot -> dense index
+    std::vector<uint32_t> slotDenseIndices; ///< Dense index of the entity in each slot.
+    std::vector<uint32_t> slotGenerations;  ///< Current generation of each slot.
+    std::vector<uint32_t> freeSlots;        ///< Slots released by DestroyEntity, reused first.
+
+    // Dense components
+    std::vector<uint32_t> denseSlots;       ///< Slot of the entity at each dense index.
+    std::vector<glm::vec3> positions;       ///< Position relative to the parent.
+    std::vector<glm::quat> rotations;       ///< Rotation relative to the parent.
+    std::vector<glm::vec3> scales;          ///< Scale along each local axis.
+    std::vector<uint32_t> parentSlots;      ///< Slot of the parent entity, or Entity::INVALID_INDEX for roots.
+    std::vector<uint32_t> childCounts;      ///< Number of entities parented to this one.
+    std::vector<glm::mat4> worldMatrices;   ///< Combined transform, refreshed by UpdateTransforms.
+    std::vector<glm::vec4> localBounds;     ///< Mesh-space bounding sphere.
+    FrustumCuller worldBounds;              ///< World-space bounding spheres, refreshed by UpdateTransforms.
+    std::vector<Mesh*> meshes;              ///< Mesh drawn for the entity.
+    std::vector<Texture*> textures;         ///< Texture the mesh is drawn with.
+    std::vector<uint8_t> transformDirty;    ///< Non-zero when the world matrix and bounds are stale.
+    bool anyTransformDirty = false;
+
+    // Update order
+    std::vector<uint32_t> updateOrder;      ///< Dense indices sorted by hierarchy depth.
+    std::vector<uint32_t> levelOffsets;     ///< Start of each depth level in updateOrder, plus the end.
+    bool hierarchyChanged = false;          ///< Set when entities are added, removed or reparented.
+    uint64_t version = 0;                   ///< Bumped by every change to the entities or their transforms.
+
+    uint32_t GetDenseIndex(Entity entity) const;
+    void MarkDirty(uint32_t denseIndex);
+    void RebuildUpdateOrder();
+    void UpdateRange(uint32_t begin, uint32_t end);
+};
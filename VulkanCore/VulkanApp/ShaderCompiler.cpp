@@ -0,0 +1,337 @@
+#include "ShaderCompiler.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+
+#include <shaderc/shaderc.hpp>
+
+
+namespace {
+
+constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+constexpr size_t SPIRV_HEADER_WORDS = 5;
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+
+#ifdef NDEBUG
+constexpr bool OPTIMIZE_SHADERS = true;
+#else
+constexpr bool OPTIMIZE_SHADERS = false;
+#endif
+
+uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+std::vector<uint32_t> ToWords(const std::vector<char>& bytes, const std::string& path) {
+    if (bytes.size() % sizeof(uint32_t) != 0) {
+        throw std::runtime_error("SPIR-V file " + path + " is not a whole number of words!");
+    }
+    std::vector<uint32_t> words(bytes.size() / sizeof(uint32_t));
+    std::memcpy(words.data(), bytes.data(), bytes.size());
+    return words;
+}
+
+bool StageFromExtension(const std::string& extension, shaderc_shader_kind& kind) {
+    if (extension == ".vert") {
+        kind = shaderc_vertex_shader;
+    }
+    else if (extension == ".frag") {
+        kind = shaderc_fragment_shader;
+    }
+    else if (extension == ".comp") {
+        kind = shaderc_compute_shader;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+uint64_t SourceKey(const std::vector<char>& source, shaderc_shader_kind kind, uint32_t version) {
+    uint64_t key = HashBytes(FNV_OFFSET, source.data(), source.size());
+    key = HashBytes(key, &kind, sizeof(kind));
+    key = HashBytes(key, &OPTIMIZE_SHADERS, sizeof(OPTIMIZE_SHADERS));
+    return HashBytes(key, &version, sizeof(version));
+}
+
+/**
+ * @brief Runs shaderc on one source. With optimize set, spirv-opt's performance passes run and no debug info is emitted.
+ */
+std::vector<uint32_t> CompileSource(const std::vector<char>& source, shaderc_shader_kind kind, const std::string& path, bool optimize, double& compileMs) {
+    // Vulkan 1.0 SPIR-V, the same target glslc uses by default.
+    shaderc::Compiler compiler;
+    shaderc::CompileOptions options;
+    options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_0);
+    if (optimize) {
+        options.SetOptimizationLevel(shaderc_optimization_level_performance);
+    }
+    else {
+        options.SetOptimizationLevel(shaderc_optimization_level_zero);
+        options.SetGenerateDebugInfo();
+    }
+
+    auto compileStart = std::chrono::high_resolution_clock::now();
+    shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(source.data(), source.size(), kind, path.c_str(), "main", options);
+    compileMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - compileStart).count();
+    if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
+        throw std::runtime_error("Failed to compile " + path + ":\n" + result.GetErrorMessage());
+    }
+    return std::vector<uint32_t>(result.cbegin(), result.cend());
+}
+
+} // namespace
+
+/**
+ * @param cacheDirectory Directory compiled SPIR-V is stored in; created on first store.
+ */
+ShaderCompiler::ShaderCompiler(std::string cacheDirectory)
+    : cacheDirectory(std::move(cacheDirectory)) {
+}
+
+/**
+ * @brief Returns the SPIR-V for the shader at path, compiling it unless an identical source was compiled before.
+ *
+ * The returned words stay valid until the compiler is destroyed or LoadBundle is called again.
+ *
+ * @throws std::runtime_error if the file cannot be read, has an unknown extension, or fails to
+ *         compile. The message carries shaderc's diagnostics.
+ */
+std::span<const uint32_t> ShaderCompiler::Compile(const std::string& path) {
+    const std::string extension = std::filesystem::path(path).extension().string();
+    if (extension == ".spv") {
+        std::vector<uint32_t> spirv = ToWords(readFile(path), path);
+        const uint64_t key = HashBytes(FNV_OFFSET, spirv.data(), spirv.size() * sizeof(uint32_t));
+        return compiled.try_emplace(key, std::move(spirv)).first->second;
+    }
+
+    shaderc_shader_kind kind;
+    if (!StageFromExtension(extension, kind)) {
+        throw std::runtime_error("Unknown shader stage for " + path + "!");
+    }
+
+    // Without its source, a bundled shader is used as it is.
+    auto bundled = bundleEntries.find(path);
+    std::error_code error;
+    if (bundled != bundleEntries.end() && !std::filesystem::exists(path, error)) {
+        stats.bundleHits++;
+        return { bundle.data() + bundled->second.codeOffset, bundled->second.codeWords };
+    }
+
+    const std::vector<char> source = readFile(path);
+    const uint64_t key = SourceKey(source, kind, CACHE_VERSION);
+    if (bundled != bundleEntries.end() && bundled->second.key == key) {
+        stats.bundleHits++;
+        return { bundle.data() + bundled->second.codeOffset, bundled->second.codeWords };
+    }
+
+    auto it = compiled.find(key);
+    if (it != compiled.end()) {
+        stats.cacheHits++;
+        return it->second;
+    }
+
+    char fileName[32];
+    std::snprintf(fileName, sizeof(fileName), "%016llx.spv", static_cast<unsigned long long>(key));
+    const std::string cachePath = (std::filesystem::path(cacheDirectory) / fileName).string();
+    std::vector<uint32_t> spirv = LoadCached(cachePath);
+    if (!spirv.empty()) {
+        stats.cacheHits++;
+        return compiled.emplace(key, std::move(spirv)).first->second;
+    }
+
+    double compileMs = 0.0;
+    spirv = CompileSource(source, kind, path, OPTIMIZE_SHADERS, compileMs);
+    stats.compiles++;
+    stats.compileMs += compileMs;
+    StoreCached(cachePath, spirv);
+    return compiled.emplace(key, std::move(spirv)).first->second;
+}
+/**
+ * @brief Reads a bundle written by WriteBundle. Its shaders are then served by Compile without compiling.
+ *
+ * @return False if the file is missing or malformed; the compiler then works from the sources alone.
+ */
+bool ShaderCompiler::LoadBundle(const std::string& bundlePath) {
+    std::ifstream file(bundlePath, std::ios::ate | std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    const size_t fileSize = static_cast<size_t>(file.tellg());
+    if (fileSize < sizeof(BundleHeader) || fileSize % sizeof(uint32_t) != 0) {
+        std::cerr << "Ignoring malformed shader bundle " << bundlePath << ".\n";
+        return false;
+    }
+
+    // One read; the SPIR-V is used in place from here on.
+    std::vector<uint32_t> data(fileSize / sizeof(uint32_t));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(fileSize));
+
+    BundleHeader header;
+    std::memcpy(&header, reinterpret_cast<const char*>(data.data()), sizeof(header));
+    const size_t entryWords = sizeof(BundleEntry) / sizeof(uint32_t);
+    if (!file || header.magic != BUNDLE_MAGIC || header.version != BUNDLE_VERSION || header.wordCount != data.size()
+        || sizeof(BundleHeader) / sizeof(uint32_t) + static_cast<size_t>(header.entryCount) * entryWords > data.size()) {
+        std::cerr << "Ignoring malformed shader bundle " << bundlePath << ".\n";
+        return false;
+    }
+
+    std::unordered_map<std::string, BundleEntry> entries;
+    const char* bytes = reinterpret_cast<const char*>(data.data());
+    for (uint32_t i = 0; i < header.entryCount; i++) {
+        BundleEntry entry;
+        std::memcpy(&entry, bytes + sizeof(BundleHeader) + i * sizeof(BundleEntry), sizeof(entry));
+        const size_t pathEnd = static_cast<size_t>(entry.pathOffset) * sizeof(uint32_t) + entry.pathLength;
+        const size_t codeEnd = static_cast<size_t>(entry.codeOffset) + entry.codeWords;
+        if (pathEnd > fileSize || codeEnd > data.size() || entry.codeWords <= SPIRV_HEADER_WORDS || data[entry.codeOffset] != SPIRV_MAGIC) {
+            std::cerr << "Ignoring malformed shader bundle " << bundlePath << ".\n";
+            return false;
+        }
+        entries.emplace(std::string(bytes + static_cast<size_t>(entry.pathOffset) * sizeof(uint32_t), entry.pathLength), entry);
+    }
+
+    bundle = std::move(data);
+    bundleEntries = std::move(entries);
+    return true;
+}
+/**
+ * @brief Compiles each shader and packs the results into one bundle file, reporting instruction counts.
+ *
+ * Each shader is also compiled without optimization, so the report shows what the optimizer removed.
+ *
+ * @param report Receives one row per shader.
+ * @throws std::runtime_error if a shader fails to compile or the bundle cannot be written.
+ */
+void ShaderCompiler::WriteBundle(const std::string& bundlePath, const std::vector<std::string>& shaderPaths, std::ostream& report) {
+    report << "Shader bundle (" << (OPTIMIZE_SHADERS ? "optimized, no debug info" : "unoptimized, with debug info") << "):\n"
+        << std::left << std::setw(28) << "Shader" << std::right << std::setw(14) << "Unoptimized"
+        << std::setw(12) << "Bundled" << std::setw(10) << "KiB" << "\n";
+
+    const uint32_t entryCount = static_cast<uint32_t>(shaderPaths.size());
+    std::vector<uint32_t> data((sizeof(BundleHeader) + entryCount * sizeof(BundleEntry)) / sizeof(uint32_t));
+    std::vector<BundleEntry> entries(entryCount);
+    for (uint32_t i = 0; i < entryCount; i++) {
+        const std::string& path = shaderPaths[i];
+        shaderc_shader_kind kind;
+        if (!StageFromExtension(std::filesystem::path(path).extension().string(), kind)) {
+            throw std::runtime_error("Unknown shader stage for " + path + "!");
+        }
+        const std::vector<char> source = readFile(path);
+        std::span<const uint32_t> code = Compile(path);
+        double compileMs = 0.0;
+        const std::vector<uint32_t> unoptimized = CompileSource(source, kind, path, false, compileMs);
+
+        BundleEntry& entry = entries[i];
+        entry.key = SourceKey(source, kind, CACHE_VERSION);
+        entry.pathOffset = static_cast<uint32_t>(data.size());
+        entry.pathLength = static_cast<uint32_t>(path.size());
+        data.resize(data.size() + (path.size() + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+        std::memcpy(data.data() + entry.pathOffset, path.data(), path.size());
+        entry.codeOffset = static_cast<uint32_t>(data.size());
+        entry.codeWords = static_cast<uint32_t>(code.size());
+        data.insert(data.end(), code.begin(), code.end());
+
+        report << std::left << std::setw(28) << path << std::right
+            << std::setw(14) << CountInstructions(unoptimized)
+            << std::setw(12) << CountInstructions(code)
+            << std::setw(10) << std::fixed << std::setprecision(1) << code.size_bytes() / 1024.0 << "\n" << std::defaultfloat;
+    }
+
+    BundleHeader header;
+    header.entryCount = entryCount;
+    header.wordCount = static_cast<uint32_t>(data.size());
+    std::memcpy(data.data(), &header, sizeof(header));
+    std::memcpy(reinterpret_cast<char*>(data.data()) + sizeof(header), entries.data(), entries.size() * sizeof(BundleEntry));
+
+    const std::string tempPath = bundlePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(uint32_t)));
+        file.flush();
+        if (!file) {
+            throw std::runtime_error("Failed to write " + tempPath + "!");
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tempPath, bundlePath, error);
+    if (error) {
+        const std::string message = "Failed to replace " + bundlePath + ": " + error.message() + "!";
+        std::filesystem::remove(tempPath, error);
+        throw std::runtime_error(message);
+    }
+    report << "Wrote " << bundlePath << " (" << std::fixed << std::setprecision(1)
+        << data.size() * sizeof(uint32_t) / 1024.0 << " KiB)\n" << std::defaultfloat;
+}
+const ShaderCompiler::Stats& ShaderCompiler::GetStats() const {
+    return stats;
+}
+
+/**
+ * @brief Counts the instructions in a SPIR-V module, declarations included.
+ */
+uint32_t ShaderCompiler::CountInstructions(std::span<const uint32_t> spirv) {
+    uint32_t count = 0;
+    for (size_t i = SPIRV_HEADER_WORDS; i < spirv.size();) {
+        const uint32_t wordCount = spirv[i] >> 16;  // The high half of an instruction's first word.
+        if (wordCount == 0) {
+            break;
+        }
+        count++;
+        i += wordCount;
+    }
+    return count;
+}
+
+/**
+ * @brief Reads a cached SPIR-V file. Returns an empty vector if it is missing or not SPIR-V.
+ */
+std::vector<uint32_t> ShaderCompiler::LoadCached(const std::string& cachePath) const {
+    std::ifstream file(cachePath, std::ios::ate | std::ios::binary);
+    if (!file.is_open()) {
+        return {};
+    }
+    const size_t fileSize = static_cast<size_t>(file.tellg());
+    if (fileSize == 0 || fileSize % sizeof(uint32_t) != 0) {
+        return {};
+    }
+
+    std::vector<uint32_t> spirv(fileSize / sizeof(uint32_t));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(spirv.data()), static_cast<std::streamsize>(fileSize));
+    if (!file || spirv[0] != SPIRV_MAGIC) {
+        return {};
+    }
+    return spirv;
+}
+/**
+ * @brief Writes SPIR-V to the disk cache. Failures are reported and otherwise ignored.
+ *
+ * The file is written under a temporary name and renamed into place, so a reader never sees a partial file.
+ */
+void ShaderCompiler::StoreCached(const std::string& cachePath, const std::vector<uint32_t>& spirv) const {
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory, error);
+
+    const std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(spirv.data()), static_cast<std::streamsize>(spirv.size() * sizeof(uint32_t)));
+        file.flush();
+        if (!file) {
+            std::cerr << "Failed to write " << tempPath << ".\n";
+            return;
+        }
+    }
+
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        std::cerr << "Failed to replace " << cachePath << ": " << error.message() << "\n";
+        std::filesystem::remove(tempPath, error);
+    }
+}
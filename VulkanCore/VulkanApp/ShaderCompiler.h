@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Utilities.h"
+
+#include <ostream>
+#include <span>
+#include <unordered_map>
+
+
+/**
+ * @file ShaderCompiler.h
+ * @brief Defines the ShaderCompiler class, which turns GLSL sources into SPIR-V at runtime.
+ */
+
+/**
+ * @class ShaderCompiler
+ * @brief Compiles GLSL shaders with shaderc and caches the SPIR-V by source hash.
+ *
+ * The stage comes from the file extension (.vert, .frag or .comp). A path ending in .spv is
+ * loaded as prebuilt SPIR-V instead. Results are cached in memory and under the cache directory,
+ * keyed by a hash of the source text, the stage, the optimization setting and CACHE_VERSION. The
+ * shaders use no #include, so the source text alone determines the output, and an unchanged
+ * shader costs one file read and a hash rather than a compile, on this run or the next.
+ *
+ * Release builds run spirv-opt's performance passes (inlining, constant folding, dead code
+ * elimination and the like) and emit no debug info. Debug builds skip optimization and keep the
+ * source in the SPIR-V, so captures show the GLSL.
+ *
+ * WriteBundle packs several shaders into one file that LoadBundle reads back in a single read.
+ * Bundled SPIR-V is handed out in place. An entry is only used while the source it was built from
+ * is unchanged, or when the source is not there at all, so a shipped bundle needs no sources.
+ *
+ * Not thread-safe; PipelineStateCache only calls it from the render thread.
+ */
+class ShaderCompiler {
+public:
+    /**
+     * @brief Compile and cache counters for the debug overlay.
+     */
+    struct Stats {
+        uint32_t compiles = 0;       ///< Sources compiled by shaderc.
+        uint32_t cacheHits = 0;      ///< Sources answered from the memory or disk cache.
+        uint32_t bundleHits = 0;     ///< Sources answered from the loaded bundle.
+        double compileMs = 0.0;      ///< Time spent in shaderc.
+    };
+
+    explicit ShaderCompiler(std::string cacheDirectory);
+
+    ShaderCompiler(const ShaderCompiler&) = delete;
+    ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+
+    std::span<const uint32_t> Compile(const std::string& path);
+    bool LoadBundle(const std::string& bundlePath);
+    void WriteBundle(const std::string& bundlePath, const std::vector<std::string>& shaderPaths, std::ostream& report);
+
+    const Stats& GetStats() const;
+
+    static uint32_t CountInstructions(std::span<const uint32_t> spirv);
+
+private:
+    static constexpr uint32_t CACHE_VERSION = 2;         ///< Bump when the compile options change.
+    static constexpr uint32_t BUNDLE_MAGIC = 0x42534B56; ///< "VKSB", little endian.
+    static constexpr uint32_t BUNDLE_VERSION = 1;        ///< Bump when BundleHeader or BundleEntry change.
+
+    /**
+     * @brief Start of a bundle file, followed by entryCount BundleEntry records, the paths and the SPIR-V.
+     */
+    struct BundleHeader {
+        uint32_t magic = BUNDLE_MAGIC;
+        uint32_t version = BUNDLE_VERSION;
+        uint32_t entryCount = 0;
+        uint32_t wordCount = 0;   ///< Size of the whole file in 32-bit words.
+    };
+
+    /**
+     * @brief One shader in a bundle. Offsets are in words from the start of the file.
+     */
+    struct BundleEntry {
+        uint64_t key = 0;         ///< Cache key of the source the SPIR-V was built from.
+        uint32_t pathOffset = 0;
+        uint32_t pathLength = 0;  ///< In bytes; the path is padded to a whole word.
+        uint32_t codeOffset = 0;
+        uint32_t codeWords = 0;
+    };
+
+    std::string cacheDirectory;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> compiled;  ///< SPIR-V by cache key, for this run.
+    std::vector<uint32_t> bundle;                                  ///< The loaded bundle file.
+    std::unordered_map<std::string, BundleEntry> bundleEntries;    ///< Entries of bundle, by shader path.
+    Stats stats;
+
+    std::vector<uint32_t> LoadCached(const std::string& cachePath) const;
+    void StoreCached(const std::string& cachePath, const std::vector<uint32_t>& spirv) const;
+};
@@ -0,0 +1,482 @@
+#include "ShaderReflection.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+
+namespace {
+
+constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+constexpr size_t SPIRV_HEADER_WORDS = 5;
+constexpr uint32_t UNSET = UINT32_MAX;
+
+// Opcodes, decorations and storage classes from the SPIR-V specification.
+constexpr uint32_t OP_NAME = 5;
+constexpr uint32_t OP_ENTRY_POINT = 15;
+constexpr uint32_t OP_TYPE_BOOL = 20;
+constexpr uint32_t OP_TYPE_INT = 21;
+constexpr uint32_t OP_TYPE_FLOAT = 22;
+constexpr uint32_t OP_TYPE_VECTOR = 23;
+constexpr uint32_t OP_TYPE_MATRIX = 24;
+constexpr uint32_t OP_TYPE_IMAGE = 25;
+constexpr uint32_t OP_TYPE_SAMPLER = 26;
+constexpr uint32_t OP_TYPE_SAMPLED_IMAGE = 27;
+constexpr uint32_t OP_TYPE_ARRAY = 28;
+constexpr uint32_t OP_TYPE_RUNTIME_ARRAY = 29;
+constexpr uint32_t OP_TYPE_STRUCT = 30;
+constexpr uint32_t OP_TYPE_POINTER = 32;
+constexpr uint32_t OP_CONSTANT = 43;
+constexpr uint32_t OP_VARIABLE = 59;
+constexpr uint32_t OP_DECORATE = 71;
+constexpr uint32_t OP_MEMBER_DECORATE = 72;
+
+constexpr uint32_t DECORATION_BUFFER_BLOCK = 3;
+constexpr uint32_t DECORATION_ARRAY_STRIDE = 6;
+constexpr uint32_t DECORATION_MATRIX_STRIDE = 7;
+constexpr uint32_t DECORATION_BUILT_IN = 11;
+constexpr uint32_t DECORATION_LOCATION = 30;
+constexpr uint32_t DECORATION_BINDING = 33;
+constexpr uint32_t DECORATION_DESCRIPTOR_SET = 34;
+constexpr uint32_t DECORATION_OFFSET = 35;
+
+constexpr uint32_t STORAGE_UNIFORM_CONSTANT = 0;
+constexpr uint32_t STORAGE_INPUT = 1;
+constexpr uint32_t STORAGE_UNIFORM = 2;
+constexpr uint32_t STORAGE_PUSH_CONSTANT = 9;
+constexpr uint32_t STORAGE_STORAGE_BUFFER = 12;
+
+constexpr uint32_t DIM_BUFFER = 5;
+constexpr uint32_t DIM_SUBPASS_DATA = 6;
+
+/**
+ * @brief A type declaration: its opcode and the operands after its result id.
+ */
+struct Type {
+    uint32_t opcode = 0;
+    std::vector<uint32_t> operands;
+};
+
+struct Decorations {
+    uint32_t set = UNSET;
+    uint32_t binding = UNSET;
+    uint32_t location = UNSET;
+    uint32_t arrayStride = 0;
+    bool bufferBlock = false;
+    bool builtIn = false;
+};
+
+struct Variable {
+    uint32_t id = 0;
+    uint32_t pointerType = 0;
+    uint32_t storageClass = 0;
+};
+
+/**
+ * @brief The parts of a SPIR-V module that describe its resource interface.
+ */
+struct Module {
+    VkShaderStageFlags stage = 0;
+    std::unordered_map<uint32_t, Type> types;
+    std::unordered_map<uint32_t, uint32_t> constants;       ///< 32-bit scalar constants; array lengths refer to them.
+    std::unordered_map<uint32_t, Decorations> decorations;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> memberOffsets;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> memberMatrixStrides;
+    std::unordered_map<uint32_t, std::string> names;
+    std::vector<Variable> variables;
+
+    const Type& GetType(uint32_t id) const {
+        auto it = types.find(id);
+        if (it == types.end()) {
+            throw std::runtime_error("SPIR-V references an undeclared type!");
+        }
+        return it->second;
+    }
+    Decorations GetDecorations(uint32_t id) const {
+        auto it = decorations.find(id);
+        return it != decorations.end() ? it->second : Decorations{};
+    }
+    uint32_t GetMemberDecoration(const std::unordered_map<uint32_t, std::vector<uint32_t>>& members, uint32_t structId, size_t member) const {
+        auto it = members.find(structId);
+        return it != members.end() && member < it->second.size() ? it->second[member] : 0;
+    }
+    uint32_t GetArrayLength(const Type& arrayType) const {
+        auto it = constants.find(arrayType.operands[1]);
+        if (it == constants.end()) {
+            throw std::runtime_error("SPIR-V array length is not a constant!");
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief Bytes the type occupies in a buffer block, per its layout decorations. Runtime arrays count as 0.
+     */
+    uint32_t SizeOf(uint32_t typeId, uint32_t matrixStride = 0) const {
+        const Type& type = GetType(typeId);
+        switch (type.opcode) {
+        case OP_TYPE_BOOL:
+            return 4;
+        case OP_TYPE_INT:
+        case OP_TYPE_FLOAT:
+            return type.operands[0] / 8;
+        case OP_TYPE_VECTOR:
+            return type.operands[1] * SizeOf(type.operands[0]);
+        case OP_TYPE_MATRIX:
+            return type.operands[1] * (matrixStride != 0 ? matrixStride : SizeOf(type.operands[0]));
+        case OP_TYPE_ARRAY: {
+            const uint32_t stride = GetDecorations(typeId).arrayStride;
+            return GetArrayLength(type) * (stride != 0 ? stride : SizeOf(type.operands[0]));
+        }
+        case OP_TYPE_STRUCT: {
+            uint32_t size = 0;
+            for (size_t i = 0; i < type.operands.size(); i++) {
+                const uint32_t offset = GetMemberDecoration(memberOffsets, typeId, i);
+                const uint32_t memberStride = GetMemberDecoration(memberMatrixStrides, typeId, i);
+                size = std::max(size, offset + SizeOf(type.operands[i], memberStride));
+            }
+            return size;
+        }
+        default:
+            return 0;
+        }
+    }
+
+    /**
+     * @brief Element stride of the runtime array that ends a block, or 0 if it has none.
+     */
+    uint32_t TrailingArrayStride(uint32_t structId) const {
+        const Type& type = GetType(structId);
+        if (type.operands.empty()) {
+            return 0;
+        }
+        const uint32_t last = type.operands.back();
+        return GetType(last).opcode == OP_TYPE_RUNTIME_ARRAY ? GetDecorations(last).arrayStride : 0;
+    }
+
+    VkDescriptorType DescriptorTypeOf(uint32_t storageClass, uint32_t typeId) const {
+        const Type& type = GetType(typeId);
+        if (storageClass == STORAGE_STORAGE_BUFFER) {
+            return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        }
+        if (storageClass == STORAGE_UNIFORM) {
+            // Before SPIR-V 1.3, storage buffers are Uniform blocks decorated BufferBlock.
+            return GetDecorations(typeId).bufferBlock ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        }
+        if (type.opcode == OP_TYPE_SAMPLER) {
+            return VK_DESCRIPTOR_TYPE_SAMPLER;
+        }
+        if (type.opcode == OP_TYPE_SAMPLED_IMAGE) {
+            const Type& image = GetType(type.operands[0]);
+            return image.operands[1] == DIM_BUFFER ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        }
+        if (type.opcode == OP_TYPE_IMAGE) {
+            const uint32_t dim = type.operands[1];
+            const bool storage = type.operands[5] == 2;
+            if (dim == DIM_SUBPASS_DATA) {
+                return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            }
+            if (dim == DIM_BUFFER) {
+                return storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+            }
+            return storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        }
+        throw std::runtime_error("Unsupported descriptor type in SPIR-V!");
+    }
+
+    /**
+     * @brief Vertex attribute format matching a 32-bit scalar or vector input.
+     */
+    VkFormat FormatOf(uint32_t typeId) const {
+        const Type& type = GetType(typeId);
+        uint32_t components = 1;
+        const Type* component = &type;
+        if (type.opcode == OP_TYPE_VECTOR) {
+            components = type.operands[1];
+            component = &GetType(type.operands[0]);
+        }
+        if (components < 1 || components > 4 || component->operands.empty() || component->operands[0] != 32) {
+            return VK_FORMAT_UNDEFINED;
+        }
+
+        static constexpr VkFormat FLOAT_FORMATS[] = { VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT };
+        static constexpr VkFormat SINT_FORMATS[] = { VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT };
+        static constexpr VkFormat UINT_FORMATS[] = { VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT };
+        if (component->opcode == OP_TYPE_FLOAT) {
+            return FLOAT_FORMATS[components - 1];
+        }
+        if (component->opcode == OP_TYPE_INT) {
+            return component->operands[1] != 0 ? SINT_FORMATS[components - 1] : UINT_FORMATS[components - 1];
+        }
+        return VK_FORMAT_UNDEFINED;
+    }
+};
+
+std::string ReadString(const uint32_t* words, size_t wordCount) {
+    const char* chars = reinterpret_cast<const char*>(words);
+    return std::string(chars, std::find(chars, chars + wordCount * sizeof(uint32_t), '\0'));
+}
+
+bool BindingLess(const ShaderReflection::Binding& a, const ShaderReflection::Binding& b) {
+    return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+}
+
+VkShaderStageFlags StageOf(uint32_t executionModel) {
+    switch (executionModel) {
+    case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+    case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+    case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+    case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+    case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+    case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+    default: return 0;
+    }
+}
+
+void SetMemberDecoration(std::vector<uint32_t>& members, uint32_t member, uint32_t value) {
+    if (members.size() <= member) {
+        members.resize(member + 1, 0);
+    }
+    members[member] = value;
+}
+
+Module ParseModule(std::span<const uint32_t> spirv) {
+    if (spirv.size() < SPIRV_HEADER_WORDS || spirv[0] != SPIRV_MAGIC) {
+        throw std::runtime_error("Not a SPIR-V module!");
+    }
+
+    Module module;
+    for (size_t i = SPIRV_HEADER_WORDS; i < spirv.size();) {
+        const uint32_t wordCount = spirv[i] >> 16;
+        const uint32_t opcode = spirv[i] & 0xFFFF;
+        if (wordCount == 0 || i + wordCount > spirv.size()) {
+            throw std::runtime_error("Truncated SPIR-V instruction!");
+        }
+        const uint32_t* operands = spirv.data() + i + 1;
+        const size_t operandCount = wordCount - 1;
+        i += wordCount;
+
+        switch (opcode) {
+        case OP_NAME:
+            if (operandCount >= 2) {
+                module.names[operands[0]] = ReadString(operands + 1, operandCount - 1);
+            }
+            break;
+        case OP_ENTRY_POINT:
+            if (module.stage == 0 && operandCount >= 1) {
+                module.stage = StageOf(operands[0]);
+            }
+            break;
+        case OP_TYPE_BOOL:
+        case OP_TYPE_INT:
+        case OP_TYPE_FLOAT:
+        case OP_TYPE_VECTOR:
+        case OP_TYPE_MATRIX:
+        case OP_TYPE_IMAGE:
+        case OP_TYPE_SAMPLER:
+        case OP_TYPE_SAMPLED_IMAGE:
+        case OP_TYPE_ARRAY:
+        case OP_TYPE_RUNTIME_ARRAY:
+        case OP_TYPE_STRUCT:
+        case OP_TYPE_POINTER:
+            if (operandCount >= 1) {
+                module.types[operands[0]] = { opcode, std::vector<uint32_t>(operands + 1, operands + operandCount) };
+            }
+            break;
+        case OP_CONSTANT:
+            if (operandCount >= 3) {
+                module.constants[operands[1]] = operands[2];
+            }
+            break;
+        case OP_VARIABLE:
+            if (operandCount >= 3) {
+                module.variables.push_back({ operands[1], operands[0], operands[2] });
+            }
+            break;
+        case OP_DECORATE: {
+            if (operandCount < 2) {
+                break;
+            }
+            Decorations& decorations = module.decorations[operands[0]];
+            const uint32_t literal = operandCount >= 3 ? operands[2] : 0;
+            switch (operands[1]) {
+            case DECORATION_BUFFER_BLOCK: decorations.bufferBlock = true; break;
+            case DECORATION_ARRAY_STRIDE: decorations.arrayStride = literal; break;
+            case DECORATION_BUILT_IN: decorations.builtIn = true; break;
+            case DECORATION_LOCATION: decorations.location = literal; break;
+            case DECORATION_BINDING: decorations.binding = literal; break;
+            case DECORATION_DESCRIPTOR_SET: decorations.set = literal; break;
+            default: break;
+            }
+            break;
+        }
+        case OP_MEMBER_DECORATE:
+            if (operandCount >= 4 && operands[2] == DECORATION_OFFSET) {
+                SetMemberDecoration(module.memberOffsets[operands[0]], operands[1], operands[3]);
+            }
+            else if (operandCount >= 4 && operands[2] == DECORATION_MATRIX_STRIDE) {
+                SetMemberDecoration(module.memberMatrixStrides[operands[0]], operands[1], operands[3]);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return module;
+}
+
+} // namespace
+
+/**
+ * @brief Reads the resource interface of one shader stage.
+ *
+ * @throws std::runtime_error if the SPIR-V is malformed or declares a descriptor type this does not know.
+ */
+ShaderReflection ShaderReflection::Reflect(std::span<const uint32_t> spirv) {
+    const Module module = ParseModule(spirv);
+
+    ShaderReflection reflection;
+    reflection.stages = module.stage;
+    for (const Variable& variable : module.variables) {
+        const uint32_t pointee = module.GetType(variable.pointerType).operands[1];
+        const Decorations decorations = module.GetDecorations(variable.id);
+        auto name = module.names.find(variable.id);
+
+        if (variable.storageClass == STORAGE_INPUT) {
+            if (module.stage == VK_SHADER_STAGE_VERTEX_BIT && !decorations.builtIn && decorations.location != UNSET) {
+                reflection.vertexInputs.push_back({ decorations.location, module.FormatOf(pointee), name != module.names.end() ? name->second : "" });
+            }
+            continue;
+        }
+        if (variable.storageClass == STORAGE_PUSH_CONSTANT) {
+            const Type& block = module.GetType(pointee);
+            uint32_t offset = UNSET;
+            for (size_t i = 0; i < block.operands.size(); i++) {
+                offset = std::min(offset, module.GetMemberDecoration(module.memberOffsets, pointee, i));
+            }
+            offset = offset == UNSET ? 0 : offset;
+            reflection.pushConstants = { module.stage, offset, module.SizeOf(pointee) - offset };
+            continue;
+        }
+        if ((variable.storageClass != STORAGE_UNIFORM_CONSTANT && variable.storageClass != STORAGE_UNIFORM
+            && variable.storageClass != STORAGE_STORAGE_BUFFER) || decorations.binding == UNSET) {
+            continue;
+        }
+
+        Binding binding;
+        binding.set = decorations.set == UNSET ? 0 : decorations.set;
+        binding.binding = decorations.binding;
+        binding.stages = module.stage;
+        binding.name = name != module.names.end() ? name->second : "";
+
+        // An array of descriptors is one binding with a count.
+        uint32_t typeId = pointee;
+        const Type& type = module.GetType(typeId);
+        if (type.opcode == OP_TYPE_ARRAY) {
+            binding.count = module.GetArrayLength(type);
+            typeId = type.operands[0];
+        }
+        else if (type.opcode == OP_TYPE_RUNTIME_ARRAY) {
+            binding.count = 0;
+            typeId = type.operands[0];
+        }
+        binding.type = module.DescriptorTypeOf(variable.storageClass, typeId);
+        if (module.GetType(typeId).opcode == OP_TYPE_STRUCT) {
+            binding.blockSize = module.SizeOf(typeId);
+            binding.arrayStride = module.TrailingArrayStride(typeId);
+        }
+        reflection.bindings.push_back(std::move(binding));
+    }
+
+    std::sort(reflection.bindings.begin(), reflection.bindings.end(), BindingLess);
+    std::sort(reflection.vertexInputs.begin(), reflection.vertexInputs.end(), [](const VertexInput& a, const VertexInput& b) {
+        return a.location < b.location;
+    });
+    return reflection;
+}
+/**
+ * @brief Adds another stage of the same pipeline. Bindings both stages use are visible to both.
+ *
+ * @throws std::runtime_error if the stages declare the same binding with different types or counts.
+ */
+void ShaderReflection::Merge(const ShaderReflection& other) {
+    stages |= other.stages;
+    for (const Binding& binding : other.bindings) {
+        auto it = std::find_if(bindings.begin(), bindings.end(), [&](const Binding& existing) {
+            return existing.set == binding.set && existing.binding == binding.binding;
+        });
+        if (it == bindings.end()) {
+            bindings.push_back(binding);
+            continue;
+        }
+        if (it->type != binding.type || it->count != binding.count) {
+            throw std::runtime_error("Shader stages disagree on set " + std::to_string(binding.set) + ", binding "
+                + std::to_string(binding.binding) + "!");
+        }
+        it->stages |= binding.stages;
+        it->blockSize = std::max(it->blockSize, binding.blockSize);
+    }
+    std::sort(bindings.begin(), bindings.end(), BindingLess);
+
+    vertexInputs.insert(vertexInputs.end(), other.vertexInputs.begin(), other.vertexInputs.end());
+
+    // Vulkan allows several ranges, but one range covering every stage's block is always valid.
+    if (other.pushConstants.size != 0) {
+        if (pushConstants.size == 0) {
+            pushConstants = other.pushConstants;
+        }
+        else {
+            const uint32_t begin = std::min(pushConstants.offset, other.pushConstants.offset);
+            const uint32_t end = std::max(pushConstants.offset + pushConstants.size, other.pushConstants.offset + other.pushConstants.size);
+            pushConstants = { pushConstants.stageFlags | other.pushConstants.stageFlags, begin, end - begin };
+        }
+    }
+}
+
+const ShaderReflection::Binding* ShaderReflection::FindBinding(uint32_t set, uint32_t binding) const {
+    for (const Binding& candidate : bindings) {
+        if (candidate.set == set && candidate.binding == binding) {
+            return &candidate;
+        }
+    }
+    return nullptr;
+}
+/**
+ * @brief Number of descriptor sets a pipeline layout needs: one past the highest set used.
+ */
+uint32_t ShaderReflection::GetSetCount() const {
+    return bindings.empty() ? 0 : bindings.back().set + 1;
+}
+/**
+ * @brief Checks that a buffer block matches the CPU struct written into it.
+ *
+ * @param blockSize sizeof the struct, or of the part before a trailing array.
+ * @param arrayStride sizeof one element of a trailing runtime array, or 0 if the block has none.
+ * @throws std::runtime_error if the binding is missing or its layout differs.
+ */
+void ShaderReflection::CheckBufferLayout(uint32_t set, uint32_t binding, size_t blockSize, size_t arrayStride) const {
+    const std::string location = "set " + std::to_string(set) + ", binding " + std::to_string(binding);
+    const Binding* reflected = FindBinding(set, binding);
+    if (reflected == nullptr) {
+        throw std::runtime_error("No shader declares " + location + "!");
+    }
+    if (reflected->blockSize != blockSize || reflected->arrayStride != arrayStride) {
+        throw std::runtime_error("Shader block " + reflected->name + " (" + location + ") is "
+            + std::to_string(reflected->blockSize) + " bytes with element stride " + std::to_string(reflected->arrayStride)
+            + ", but the CPU struct is " + std::to_string(blockSize) + " bytes with element stride " + std::to_string(arrayStride) + "!");
+    }
+}
+/**
+ * @brief Checks that every vertex input is fed by an attribute of the same format.
+ *
+ * @throws std::runtime_error naming the first input without a matching attribute.
+ */
+void ShaderReflection::CheckVertexInputs(const std::vector<VkVertexInputAttributeDescription>& attributes) const {
+    for (const VertexInput& input : vertexInputs) {
+        auto attribute = std::find_if(attributes.begin(), attributes.end(), [&](const VkVertexInputAttributeDescription& candidate) {
+            return candidate.location == input.location;
+        });
+        if (attribute == attributes.end() || attribute->format != input.format) {
+            throw std::runtime_error("Vertex input " + input.name + " (location " + std::to_string(input.location)
+                + ") has no vertex attribute of its format!");
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Utilities.h"
+
+#include <span>
+
+
+/**
+ * @file ShaderReflection.h
+ * @brief Defines ShaderReflection, the resource interface of a shader read back from its SPIR-V.
+ */
+
+/**
+ * @brief Descriptor bindings, push constants and vertex inputs declared by one or more shader stages.
+ *
+ * Reflect parses the SPIR-V directly: its decorations give each variable's set, binding and
+ * location, and its types give descriptor types, array sizes and, using the Offset, ArrayStride
+ * and MatrixStride decorations, the byte layout of buffer blocks. Merge combines the stages of a
+ * pipeline into one interface.
+ *
+ * Reflection only knows what the shader declares. Whether a buffer is bound with a dynamic offset,
+ * or how large a runtime-sized array is, is up to whoever builds the layout from it.
+ */
+struct ShaderReflection {
+    /**
+     * @brief One descriptor binding.
+     */
+    struct Binding {
+        uint32_t set = 0;
+        uint32_t binding = 0;
+        VkDescriptorType type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+        uint32_t count = 1;             ///< Array size; 0 for a runtime-sized array.
+        VkShaderStageFlags stages = 0;
+        uint32_t blockSize = 0;         ///< Bytes in a buffer block, not counting a trailing runtime array.
+        uint32_t arrayStride = 0;       ///< Element stride of a buffer block's trailing runtime array, if any.
+        std::string name;
+    };
+
+    /**
+     * @brief One vertex shader input, built-ins excluded.
+     */
+    struct VertexInput {
+        uint32_t location = 0;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        std::string name;
+    };
+
+    VkShaderStageFlags stages = 0;
+    std::vector<Binding> bindings;          ///< Sorted by set, then binding.
+    std::vector<VertexInput> vertexInputs;  ///< Sorted by location.
+    VkPushConstantRange pushConstants{};    ///< Size 0 if no stage uses push constants.
+
+    static ShaderReflection Reflect(std::span<const uint32_t> spirv);
+    void Merge(const ShaderReflection& other);
+
+    const Binding* FindBinding(uint32_t set, uint32_t binding) const;
+    uint32_t GetSetCount() const;
+    void CheckBufferLayout(uint32_t set, uint32_t binding, size_t blockSize, size_t arrayStride) const;
+    void CheckVertexInputs(const std::vector<VkVertexInputAttributeDescription>& attributes) const;
+};
@@ -1,263 +1,57 @@
-#include "Model.h"
-
-// Model Loader
-#define TINYOBJLOADER_IMPLEMENTATION
-#include <tiny_obj_loader.h>
+#include "Texture.h"
 
 // Image Loader
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
 
-Model::Model(VkDevice device, VkPhysicalDevice physicalDevice, VkQueue graphicsQueue, VkCommandPool commandPool)
-    : device(device), physicalDevice(physicalDevice), graphicsQueue(graphicsQueue), commandPool(commandPool) {}
-Model::~Model() {
+Texture::Texture(VkDevice device, VkPhysicalDevice physicalDevice, VkQueue graphicsQueue, VkCommandPool commandPool, const VkAllocationCallbacks* allocator)
+    : device(device), physicalDevice(physicalDevice), graphicsQueue(graphicsQueue), commandPool(commandPool), allocator(allocator) {}
+Texture::~Texture() {
     // Destroy texture resources
     if (textureImageView != VK_NULL_HANDLE) {
-        vkDestroyImageView(device, textureImageView, nullptr);
+        vkDestroyImageView(device, textureImageView, allocator);
         textureImageView = VK_NULL_HANDLE;
     }
 
     if (textureSampler != VK_NULL_HANDLE) {
-        vkDestroySampler(device, textureSampler, nullptr);
+        vkDestroySampler(device, textureSampler, allocator);
         textureSampler = VK_NULL_HANDLE;
     }
     if (textureImage != VK_NULL_HANDLE) {
-        vkDestroyImage(device, textureImage, nullptr);
+        vkDestroyImage(device, textureImage, allocator);
         textureImage = VK_NULL_HANDLE;
     }
     if (textureImageMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(device, textureImageMemory, nullptr);
+        vkFreeMemory(device, textureImageMemory, allocator);
         textureImageMemory = VK_NULL_HANDLE;
     }
-
-    // Destroy vertex and index buffers
-    if (vertexBuffer != VK_NULL_HANDLE) {
-        vkDestroyBuffer(device, vertexBuffer, nullptr);
-        vertexBuffer = VK_NULL_HANDLE;
-    }
-    if (vertexBufferMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(device, vertexBufferMemory, nullptr);
-        vertexBufferMemory = VK_NULL_HANDLE;
-    }
-    if (indexBuffer != VK_NULL_HANDLE) {
-        vkDestroyBuffer(device, indexBuffer, nullptr);
-        indexBuffer = VK_NULL_HANDLE;
-    }
-    if (indexBufferMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(device, indexBufferMemory, nullptr);
-        indexBufferMemory = VK_NULL_HANDLE;
-    }
-}   
-
-void Model::Bind(VkCommandBuffer commandBuffer) {
-    VkBuffer buffers[] = { vertexBuffer };
-    VkDeviceSize offsets[] = { 0 };
-    vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
-    vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
 }
-void Model::Draw(VkCommandBuffer commandBuffer) {
-    vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
-}
-
-void Model::LoadOBJ(const std::string& filepath) {
-    // Initialize TinyOBJ structures to load OBJ file data
-    tinyobj::attrib_t attrib; // Holds vertex attributes such as positions, normals, and texture coordinates
-    std::vector<tinyobj::shape_t> shapes; // Holds the geometric shapes in the OBJ file
-    std::vector<tinyobj::material_t> materials; // Holds material information (not used in this example)
-    std::string warn, err; // Strings to capture warnings and errors during file loading
-
-    // Load the OBJ file and populate the TinyOBJ structures
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filepath.c_str())) {
-        // If loading fails, throw an exception with the combined warning and error messages
-        throw std::runtime_error(warn + err);
-    }
-
-    // Iterate through each shape in the OBJ file
-    for (const auto& shape : shapes) {
-        // Iterate through each index in the shape's mesh
-        for (const auto& index : shape.mesh.indices) {
-            Vertex vertex{}; // Initialize a new vertex
-
-            // Set the vertex position using the indexed position data from the attrib array
-            vertex.pos = {
-                attrib.vertices[3 * index.vertex_index + 0], // X coordinate
-                attrib.vertices[3 * index.vertex_index + 1], // Y coordinate
-                attrib.vertices[3 * index.vertex_index + 2]  // Z coordinate
-            };
-
-            // Set the vertex texture coordinates using the indexed texcoord data from the attrib array
-            // Flip the Y coordinate by subtracting it from 1.0f (to match Vulkan's coordinate system)
-            vertex.textCoor = {
-                attrib.texcoords[2 * index.texcoord_index + 0], // U coordinate
-                1.0f - attrib.texcoords[2 * index.texcoord_index + 1] // V coordinate (flipped)
-            };
-
-            // Set the vertex color (default to white as the OBJ file doesn't specify colors)
-            vertex.color = { 1.0f, 1.0f, 1.0f };
-
-            // Add the vertex to the vertices vector
-            vertices.push_back(vertex);
-
-            // Add an index to the indices vector for indexed drawing
-            indices.push_back(static_cast<uint32_t>(indices.size()));
-        }
-    }
-
-    // Store the total number of vertices and indices
-    vertexCount = static_cast<uint32_t>(vertices.size());
-    indexCount = static_cast<uint32_t>(indices.size());
-
-    // Create GPU buffers for the vertices and indices
-    CreateVertexBuffer(); // Create a Vulkan vertex buffer and upload vertex data to the GPU
-    CreateIndexBuffer();  // Create a Vulkan index buffer and upload index data to the GPU
 
-}
-void Model::LoadFBX(const std::string& filepath) {
-    // Example using Assimp for FBX loading
-    // Include Assimp headers and link its library in your build system
-    // Assimp::Importer importer;
-    // const aiScene* scene = importer.ReadFile(filepath, aiProcess_Triangulate | aiProcess_FlipUVs);
-    // if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-    //     throw std::runtime_error("Failed to load FBX file: " + filepath);
-    // }
-
-    // Parse the FBX file and fill `vertices` and `indices` with data
-    // You can recursively process the scene graph to extract meshes and transform data
-    std::cerr << "FBX loading not yet implemented: " << filepath << "\n";
-
-    // For now, throw an error if unimplemented
-    throw std::runtime_error("FBX loading not implemented yet.");
-}
-void Model::LoadFromFile(const std::string& filepath) {
-    if (filepath.ends_with(".obj")) {
-        LoadOBJ(filepath);
-    }
-    else if (filepath.ends_with(".fbx")) {
-        LoadFBX(filepath);
-    }
-    else {
-        throw std::runtime_error("Unsupported file format: " + filepath);
-    }
-}
-void Model::LoadTexture(const std::string& texturePath) {
+void Texture::LoadFromFile(const std::string& texturePath) {
     CreateTextureImage(texturePath);
     CreateTextureImageView();
     CreateTextureSampler();
 
     // Log texture creation details
-    /*std::cout << "Model Texture Created: TexturePath[" << texturePath
+    /*std::cout << "Texture Created: TexturePath[" << texturePath
         << "], TextureImage: " << textureImage
         << ", TextureImageView: " << textureImageView
         << ", TextureSampler: " << textureSampler
         << std::endl;*/
 }
 
-VkImageView Model::GetTextureImageView() {
+VkImageView Texture::GetImageView() const {
     return textureImageView;
 }
-VkSampler Model::GetTextureSampler() {
+VkSampler Texture::GetSampler() const {
     return textureSampler;
 }
-
-void Model::CreateVertexBuffer() {
-    if (vertices.empty()) {
-        throw std::runtime_error("Vertex buffer is empty. Cannot create buffer.");
-    }
-
-    // Calculate the size of the vertex buffer in bytes
-    VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size(); // Size = size of one vertex * number of vertices
-
-    // Declare a staging buffer and its associated memory
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-
-    // Create a staging buffer to temporarily hold vertex data
-    // The buffer is created with VK_BUFFER_USAGE_TRANSFER_SRC_BIT, allowing it to act as a source for data transfer
-    createBuffer(
-        device, physicalDevice, bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        stagingBuffer, stagingBufferMemory
-    );
-
-    // Map the staging buffer's memory and copy vertex data into it
-    void* data;
-    vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &data); // Map buffer memory into CPU-accessible memory
-    memcpy(data, vertices.data(), (size_t)bufferSize);  // Copy vertex data into the staging buffer
-    vkUnmapMemory(device, stagingBufferMemory);         // Unmap the buffer memory
-
-    // Create the vertex buffer on the GPU
-    // The buffer is created with VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, allowing it to be used for vertex input
-    createBuffer(
-        device, physicalDevice, bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        vertexBuffer, vertexBufferMemory
-    );
-
-    SetObjectName(device, (uint64_t)vertexBuffer, VK_OBJECT_TYPE_BUFFER, "MC : Vertex Buffer");
-
-    // Copy the data from the staging buffer to the GPU vertex buffer
-    // The staging buffer acts as the source, and the vertex buffer is the destination
-    copyBuffer(
-        device, commandPool, graphicsQueue,
-        stagingBuffer, vertexBuffer, bufferSize
-    );
-
-    // Clean up the staging buffer and its associated memory
-    vkDestroyBuffer(device, stagingBuffer, nullptr);    // Destroy the staging buffer
-    vkFreeMemory(device, stagingBufferMemory, nullptr); // Free the memory allocated for the staging buffer
+uint32_t Texture::GetDescriptorIndex() const {
+    return descriptorIndex;
 }
-void Model::CreateIndexBuffer() {
-    if (indices.empty()) {
-        throw std::runtime_error("Index buffer is empty. Cannot create buffer.");
-    }
-
-    // Calculate the size of the index buffer in bytes
-    VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size(); // Size = size of one index * number of indices
-
-    // Declare a staging buffer and its associated memory
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-
-    // Create a staging buffer to temporarily hold index data
-    // The buffer is created with VK_BUFFER_USAGE_TRANSFER_SRC_BIT, allowing it to act as a source for data transfer
-    createBuffer(
-        device, physicalDevice, bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        stagingBuffer, stagingBufferMemory
-    );
-
-    // Map the staging buffer's memory and copy index data into it
-    void* data;
-    vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &data); // Map buffer memory into CPU-accessible memory
-    memcpy(data, indices.data(), (size_t)bufferSize); // Copy index data into the staging buffer
-    vkUnmapMemory(device, stagingBufferMemory); // Unmap the buffer memory
-
-    // Create the index buffer on the GPU
-    // The buffer is created with VK_BUFFER_USAGE_INDEX_BUFFER_BIT, allowing it to be used for indexed drawing
-    createBuffer(
-        device, physicalDevice, bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        indexBuffer, indexBufferMemory
-    );
-
-    SetObjectName(device, (uint64_t)indexBuffer, VK_OBJECT_TYPE_BUFFER, "MC : Index Buffer");
-
-    // Copy the data from the staging buffer to the GPU index buffer
-    // The staging buffer acts as the source, and the index buffer is the destination
-    copyBuffer(
-        device, commandPool, graphicsQueue,
-        stagingBuffer, indexBuffer, bufferSize
-    );
-
-    // Clean up the staging buffer and its associated memory
-    vkDestroyBuffer(device, stagingBuffer, nullptr); // Destroy the staging buffer
-    vkFreeMemory(device, stagingBufferMemory, nullptr); // Free the memory allocated for the staging buffer
-
+void Texture::SetDescriptorIndex(uint32_t index) {
+    descriptorIndex = index;
 }
 
 /**
@@ -275,7 +69,7 @@ void Model::CreateIndexBuffer() {
  *
  * @throws std::runtime_error if the format does not support linear blitting.
  */
-void Model::GenerateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels)
+void Texture::GenerateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels)
 {
     VkFormatProperties formatProperties;
     vkGetPhysicalDeviceFormatProperties(physicalDevice, imageFormat, &formatProperties);
@@ -391,7 +185,7 @@ void Model::GenerateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidt
  *
  * @throws std::runtime_error if the image view creation fails.
  */
-void Model::CreateTextureImageView() {
+void Texture::CreateTextureImageView() {
     // Use a helper function to create an image view for the texture.
     // Parameters:
     // - device: Vulkan logical device.
@@ -399,7 +193,8 @@ void Model::CreateTextureImageView() {
     // - VK_FORMAT_R8G8B8A8_SRGB: Format of the image (sRGB color space).
     // - VK_IMAGE_ASPECT_COLOR_BIT: Specify that this is a color image view.
     // - mipLevels: Number of mip levels in the image.
-    textureImageView = createImageView(device, textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels);
+    // - allocator: Host allocation callbacks shared with the renderer.
+    textureImageView = createImageView(device, textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, allocator);
 }
 /**
  * @brief Creates a Vulkan texture sampler for the model's texture.
@@ -410,7 +205,7 @@ void Model::CreateTextureImageView() {
  *
  * @throws std::runtime_error if the texture sampler creation fails.
  */
-void Model::CreateTextureSampler() {
+void Texture::CreateTextureSampler() {
     // Configure sampler settings.
     VkSamplerCreateInfo samplerInfo{};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO; // Specify the structure type.
@@ -433,7 +228,7 @@ void Model::CreateTextureSampler() {
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;     // Use linear filtering for mipmaps.
 
     // Create the Vulkan texture sampler.
-    if (vkCreateSampler(device, &samplerInfo, nullptr, &textureSampler) != VK_SUCCESS) {
+    if (vkCreateSampler(device, &samplerInfo, allocator, &textureSampler) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create texture sampler!"); // Handle creation failure.
     }
 }
@@ -447,7 +242,7 @@ void Model::CreateTextureSampler() {
  *
  * @throws std::runtime_error if the image file fails to load or Vulkan operations fail.
  */
-void Model::CreateTextureImage(const std::string& texturePath) {
+void Texture::CreateTextureImage(const std::string& texturePath) {
     // Load the texture image using stb_image
     int texWidth, texHeight, texChannels;
     stbi_uc* pixels = stbi_load(texturePath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
@@ -466,7 +261,7 @@ void Model::CreateTextureImage(const std::string& texturePath) {
         device, physicalDevice, imageSize,
         VK_BUFFER_USAGE_TRANSFER_SRC_BIT, // Buffer will be used as a source for transfers.
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, // Host-visible memory for easy data upload.
-        stagingBuffer, stagingBufferMemory
+        stagingBuffer, stagingBufferMemory, allocator
     );
 
     // Map the staging buffer memory and copy the pixel data into it.
@@ -486,7 +281,7 @@ void Model::CreateTextureImage(const std::string& texturePath) {
         VK_IMAGE_TILING_OPTIMAL, // Optimal tiling for GPU access.
         VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, // Usage flags for transfer and sampling.
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, // Device-local memory for optimal performance.
-        textureImage, textureImageMemory
+        textureImage, textureImageMemory, allocator
     );
 
     // Transition the image layout to be ready for data transfer.
@@ -509,45 +304,6 @@ void Model::CreateTextureImage(const std::string& texturePath) {
     GenerateMipmaps(textureImage, VK_FORMAT_R8G8B8A8_SRGB, texWidth, texHeight, mipLevels);
 
     // Clean up the staging buffer and its memory.
-    vkDestroyBuffer(device, stagingBuffer, nullptr);
-    vkFreeMemory(device, stagingBufferMemory, nullptr);
-}
-
-
-glm::vec3 Model::GetPosition()
-{
-    return position;
-}
-glm::mat4 Model::GetModelMatrix() const {
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, position); // Assuming `Position` is a glm::vec3
-    model = glm::rotate(model, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-    model = glm::rotate(model, glm::radians(rotation.y), glm::vec3(0.0f,-1.0f, 0.0f));
-    model = glm::rotate(model, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-    model = glm::scale(model, scale); // Assuming `Scale` is a glm::vec3
-    return model;
+    vkDestroyBuffer(device, stagingBuffer, allocator);
+    vkFreeMemory(device, stagingBufferMemory, allocator);
 }
-
-void Model::SetPosition(const glm::vec3& position)
-{
-    this->position = position;
-    UpdateModelMatrix();
-}
-void Model::SetRotation(const glm::vec3& rotation)
-{
-    this->rotation = rotation;
-    UpdateModelMatrix();
-}
-void Model::SetScale(const glm::vec3& scale)
-{
-    this->scale = scale;
-    UpdateModelMatrix();
-}
-void Model::UpdateModelMatrix() {
-    modelMatrix = glm::translate(glm::mat4(1.0f), position) *
-        glm::rotate(glm::mat4(1.0f), glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f)) *
-        glm::rotate(glm::mat4(1.0f), glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f)) *
-        glm::rotate(glm::mat4(1.0f), glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f)) *
-        glm::scale(glm::mat4(1.0f), scale);;
-}
-
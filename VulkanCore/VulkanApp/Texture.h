@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Utilities.h"
+
+
+/**
+ * @file Texture.h
+ * @brief Defines the Texture class, which owns a sampled, mipmapped Vulkan image loaded from disk.
+ */
+
+/**
+ * @class Texture
+ * @brief A 2D texture with its image, image view and sampler.
+ *
+ * Textures are shared between models that use the same image file. Each one occupies a single
+ * element of the renderer's bindless texture array, and instances select it by that index.
+ */
+class Texture {
+public:
+    Texture(VkDevice device, VkPhysicalDevice physicalDevice, VkQueue graphicsQueue, VkCommandPool commandPool, const VkAllocationCallbacks* allocator);
+    ~Texture();
+
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
+    void LoadFromFile(const std::string& texturePath);
+
+    VkImageView GetImageView() const;
+    VkSampler GetSampler() const;
+    uint32_t GetDescriptorIndex() const;
+    void SetDescriptorIndex(uint32_t index);
+
+private:
+    // Vulkan handles
+    VkDevice device = VK_NULL_HANDLE;                 ///< Vulkan logical device handle.
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE; ///< Vulkan physical device handle.
+    VkQueue graphicsQueue = VK_NULL_HANDLE;           ///< Vulkan queue for graphics commands.
+    VkCommandPool commandPool = VK_NULL_HANDLE;       ///< Vulkan command pool for command buffers.
+    const VkAllocationCallbacks* allocator = nullptr; ///< Host allocation callbacks (nullptr for the driver default).
+
+    // Texture-related resources
+    VkImage textureImage = VK_NULL_HANDLE;              ///< Vulkan image for the texture.
+    VkDeviceMemory textureImageMemory = VK_NULL_HANDLE; ///< Memory for the texture image.
+    VkImageView textureImageView = VK_NULL_HANDLE;      ///< Vulkan image view for the texture.
+    VkSampler textureSampler = VK_NULL_HANDLE;          ///< Vulkan sampler for the texture.
+    uint32_t mipLevels = 0;                             ///< Number of mipmap levels for the texture.
+    uint32_t descriptorIndex = UINT32_MAX;              ///< Element in the bindless texture array, UINT32_MAX until written.
+
+    // Private methods for internal functionality
+    void CreateTextureImage(const std::string& texturePath); ///< Loads the image file and uploads it to the GPU.
+    void CreateTextureImageView(); ///< Creates the image view for the texture.
+    void CreateTextureSampler();   ///< Creates the sampler for the texture.
+    void GenerateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels); ///< Generates mipmaps for the texture.
+};
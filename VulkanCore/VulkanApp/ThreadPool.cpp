@@ -0,0 +1,122 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+
+ThreadPool::ThreadPool(uint32_t workerCount) {
+    workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; i++) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Runs body over [0, count) in batches of batchSize iterations and waits for all of them.
+ *
+ * Small loops that fit in one batch, and pools without workers, run inline on the calling thread.
+ * Must not be called from inside a loop body.
+ *
+ * @param count Number of iterations.
+ * @param batchSize Iterations per batch; large enough that a batch outweighs claiming it.
+ * @param body Called once per batch with its iteration range, possibly on several threads at once.
+ */
+void ThreadPool::ParallelFor(uint32_t count, uint32_t batchSize, const RangeFunction& body) {
+    if (count == 0) {
+        return;
+    }
+    batchSize = std::max(batchSize, 1u);
+    if (workers.empty() || count <= batchSize) {
+        body(0, count);
+        return;
+    }
+
+    const uint32_t jobBatchCount = (count + batchSize - 1) / batchSize;
+    {
+        // A worker that joined the previous job late may still be claiming batches; let it leave first.
+        std::unique_lock<std::mutex> lock(mutex);
+        jobFinished.wait(lock, [this] { return busyWorkers == 0; });
+
+        this->body = &body;
+        this->count = count;
+        this->batchSize = batchSize;
+        batchCount = jobBatchCount;
+        nextBatch = 0;
+        completedBatches = 0;
+        jobId++;
+    }
+    jobAvailable.notify_all();
+
+    // The calling thread works too instead of sleeping.
+    RunBatches(body, count, batchSize, jobBatchCount);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    jobFinished.wait(lock, [this, jobBatchCount] { return completedBatches == jobBatchCount; });
+}
+uint32_t ThreadPool::GetWorkerCount() const {
+    return static_cast<uint32_t>(workers.size());
+}
+/**
+ * @brief Returns one worker per hardware thread, leaving one for the calling thread.
+ */
+uint32_t ThreadPool::GetDefaultWorkerCount() {
+    uint32_t hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+void ThreadPool::WorkerLoop() {
+    uint64_t lastJobId = 0;
+    while (true) {
+        const RangeFunction* function;
+        uint32_t jobCount, jobBatchSize, jobBatchCount;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this, lastJobId] { return stopping || jobId != lastJobId; });
+            if (stopping) {
+                return;
+            }
+            lastJobId = jobId;
+            function = body;
+            jobCount = count;
+            jobBatchSize = batchSize;
+            jobBatchCount = batchCount;
+            busyWorkers++;
+        }
+
+        RunBatches(*function, jobCount, jobBatchSize, jobBatchCount);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        jobFinished.notify_all();
+    }
+}
+/**
+ * @brief Claims and runs batches of the current job until none are left.
+ */
+void ThreadPool::RunBatches(const RangeFunction& function, uint32_t jobCount, uint32_t jobBatchSize, uint32_t jobBatchCount) {
+    while (true) {
+        uint32_t batch = nextBatch.fetch_add(1);
+        if (batch >= jobBatchCount) {
+            return;
+        }
+        uint32_t begin = batch * jobBatchSize;
+        function(begin, std::min(begin + jobBatchSize, jobCount));
+
+        if (completedBatches.fetch_add(1) + 1 == jobBatchCount) {
+            // Take the lock so the waiting thread cannot miss the notification.
+            std::lock_guard<std::mutex> lock(mutex);
+            jobFinished.notify_all();
+        }
+    }
+}
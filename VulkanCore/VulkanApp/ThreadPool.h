@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @file ThreadPool.h
+ * @brief Defines the ThreadPool class, a fixed set of worker threads for data-parallel loops.
+ */
+
+/**
+ * @class ThreadPool
+ * @brief Splits a loop into batches and runs them on worker threads and the calling thread.
+ *
+ * Only one loop runs at a time and ParallelFor blocks until every batch has finished, so the loop
+ * body may capture locals by reference. Batches are claimed from an atomic counter, which balances
+ * uneven work without a task queue.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Loop body called with a half-open range [begin, end) of iterations.
+     */
+    using RangeFunction = std::function<void(uint32_t begin, uint32_t end)>;
+
+    explicit ThreadPool(uint32_t workerCount = GetDefaultWorkerCount());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void ParallelFor(uint32_t count, uint32_t batchSize, const RangeFunction& body);
+    uint32_t GetWorkerCount() const;
+
+    static uint32_t GetDefaultWorkerCount();
+
+private:
+    std::vector<std::thread> workers;
+
+    // Job state, guarded by mutex except for the atomics.
+    std::mutex mutex;
+    std::condition_variable jobAvailable;  ///< Signaled when a job is posted or the pool stops.
+    std::condition_variable jobFinished;   ///< Signaled when a worker leaves a job.
+    const RangeFunction* body = nullptr;   ///< Loop body of the current job.
+    uint32_t count = 0;                    ///< Iterations in the current job.
+    uint32_t batchSize = 1;                ///< Iterations per batch.
+    uint32_t batchCount = 0;               ///< Batches in the current job.
+    uint64_t jobId = 0;                    ///< Incremented for every job so workers join each one once.
+    uint32_t busyWorkers = 0;              ///< Workers that joined the current job and have not left.
+    bool stopping = false;
+    std::atomic<uint32_t> nextBatch{ 0 };       ///< Next batch to claim.
+    std::atomic<uint32_t> completedBatches{ 0 };
+
+    void WorkerLoop();
+    void RunBatches(const RangeFunction& function, uint32_t jobCount, uint32_t jobBatchSize, uint32_t jobBatchCount);
+};
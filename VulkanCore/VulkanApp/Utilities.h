@@ -68,6 +68,25 @@ struct Vertex {
         return attributeDescriptions;
     }
 
+    // Binding of the position-only stream, for passes that only need depth
+    static VkVertexInputBindingDescription GetPositionBindingDescription() {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 0;
+        bindingDescription.stride = sizeof(glm::vec3);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        return bindingDescription;
+    }
+
+    // The position attribute alone, read from the position-only stream
+    static std::vector<VkVertexInputAttributeDescription> GetPositionAttributeDescriptions() {
+        std::vector<VkVertexInputAttributeDescription> attributeDescriptions(1);
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[0].offset = 0;
+        return attributeDescriptions;
+    }
+
     bool operator==(const Vertex& other) const {
         return pos == other.pos && color == other.color && textCoor == other.textCoor;
     }
@@ -171,7 +190,8 @@ inline void createBuffer(
     VkBufferUsageFlags usage,          // Intended usage of the buffer (e.g., vertex, index).
     VkMemoryPropertyFlags properties,  // Memory properties (e.g., host-visible, device-local).
     VkBuffer& buffer,                  // Output buffer handle.
-    VkDeviceMemory& bufferMemory       // Output memory handle for the buffer.
+    VkDeviceMemory& bufferMemory,      // Output memory handle for the buffer.
+    const VkAllocationCallbacks* allocator // Host allocation callbacks (nullptr for the driver default).
 ) {
     // Define the buffer creation information structure.
     VkBufferCreateInfo bufferInfo{};
@@ -181,7 +201,7 @@ inline void createBuffer(
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;      // Only accessed by a single queue family.
 
     // Create the buffer and check for errors.
-    if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
+    if (vkCreateBuffer(device, &bufferInfo, allocator, &buffer) != VK_SUCCESS) {
         throw std::runtime_error("failed to create buffer!");
     }
 
@@ -197,7 +217,7 @@ inline void createBuffer(
     allocInfo.memoryTypeIndex = findMemoryType(physicalDevice, memRequirements.memoryTypeBits, properties);
 
     // Allocate memory for the buffer and check for errors.
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
+    if (vkAllocateMemory(device, &allocInfo, allocator, &bufferMemory) != VK_SUCCESS) {
         throw std::runtime_error("failed to allocate buffer memory!");
     }
 
@@ -280,16 +300,17 @@ inline void copyBuffer(
     VkQueue graphicsQueue,      // Graphics queue to which the copy command will be submitted.
     VkBuffer srcBuffer,         // Source buffer containing the data to be copied.
     VkBuffer dstBuffer,         // Destination buffer where the data will be copied to.
-    VkDeviceSize size           // Size of the data to copy, in bytes.
+    VkDeviceSize size,          // Size of the data to copy, in bytes.
+    VkDeviceSize dstOffset = 0  // Byte offset in the destination buffer to write to.
 ) {
     // Begin recording a single-use command buffer.
     VkCommandBuffer commandBuffer = beginSingleTimeCommands(device, commandPool);
 
     // Define the region of data to copy between the buffers.
     VkBufferCopy copyRegion{};
-    copyRegion.srcOffset = 0;  // Start copying from the beginning of the source buffer.
-    copyRegion.dstOffset = 0;  // Start writing at the beginning of the destination buffer.
-    copyRegion.size = size;    // The size of the data to copy.
+    copyRegion.srcOffset = 0;          // Start copying from the beginning of the source buffer.
+    copyRegion.dstOffset = dstOffset;  // Start writing at the requested destination offset.
+    copyRegion.size = size;            // The size of the data to copy.
 
     // Record the copy command into the command buffer.
     vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
@@ -330,7 +351,8 @@ inline void createImage(
     VkImageUsageFlags usage,           // Intended usage of the image (e.g., color attachment, sampled image).
     VkMemoryPropertyFlags properties,  // Required memory properties (e.g., device-local, host-visible).
     VkImage& image,                    // Output Vulkan image handle.
-    VkDeviceMemory& imageMemory        // Output memory handle bound to the image.
+    VkDeviceMemory& imageMemory,       // Output memory handle bound to the image.
+    const VkAllocationCallbacks* allocator // Host allocation callbacks (nullptr for the driver default).
 ) {
     // Configure the VkImageCreateInfo structure with image properties.
     VkImageCreateInfo imageInfo{};
@@ -349,7 +371,7 @@ inline void createImage(
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;    // Exclusive queue family access.
 
     // Create the Vulkan image and check for success.
-    if (vkCreateImage(device, &imageInfo, nullptr, &image) != VK_SUCCESS) {
+    if (vkCreateImage(device, &imageInfo, allocator, &image) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create image!");
     }
 
@@ -365,13 +387,90 @@ inline void createImage(
         physicalDevice, memRequirements.memoryTypeBits, properties);
 
     // Allocate memory for the image and check for success.
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
+    if (vkAllocateMemory(device, &allocInfo, allocator, &imageMemory) != VK_SUCCESS) {
         throw std::runtime_error("Failed to allocate image memory!");
     }
 
     // Bind the allocated memory to the Vulkan image.
     vkBindImageMemory(device, image, imageMemory, 0);
 }
+
+/*
+    Utility function to create an attachment image that only lives inside a render pass.
+    The image is created with VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT and, when the device exposes one,
+    bound to a LAZILY_ALLOCATED memory type so tile-based GPUs can keep it in on-chip memory and never
+    commit physical pages. Falls back to regular device-local memory otherwise.
+    Returns true if the image was bound to lazily allocated memory.
+*/
+inline bool createTransientAttachmentImage(
+    VkDevice device,                   // Logical device handle.
+    VkPhysicalDevice physicalDevice,   // Physical device handle to query memory properties.
+    uint32_t width,                    // Width of the image in pixels.
+    uint32_t height,                   // Height of the image in pixels.
+    VkSampleCountFlagBits numSamples,  // Number of samples for multisampling.
+    VkFormat format,                   // Format of the attachment.
+    VkImageUsageFlags usage,           // Attachment usage (color or depth-stencil); TRANSIENT is added.
+    VkImage& image,                    // Output Vulkan image handle.
+    VkDeviceMemory& imageMemory,       // Output memory handle bound to the image.
+    VkDeviceSize& allocationSize,      // Output size of the memory allocation in bytes.
+    const VkAllocationCallbacks* allocator // Host allocation callbacks (nullptr for the driver default).
+) {
+    // Transient attachments are single-mip, optimally tiled 2D images.
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = width;
+    imageInfo.extent.height = height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = format;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = usage | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT; // Contents never leave the render pass.
+    imageInfo.samples = numSamples;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateImage(device, &imageInfo, allocator, &image) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create transient attachment image!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(device, image, &memRequirements);
+
+    // Prefer a lazily allocated memory type; only fall back to plain device-local memory if none matches.
+    VkPhysicalDeviceMemoryProperties memProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+
+    const VkMemoryPropertyFlags lazyProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+    bool lazilyAllocated = false;
+    uint32_t memoryTypeIndex = 0;
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+        if ((memRequirements.memoryTypeBits & (1 << i)) &&
+            (memProperties.memoryTypes[i].propertyFlags & lazyProperties) == lazyProperties) {
+            memoryTypeIndex = i;
+            lazilyAllocated = true;
+            break;
+        }
+    }
+    if (!lazilyAllocated) {
+        memoryTypeIndex = findMemoryType(physicalDevice, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    if (vkAllocateMemory(device, &allocInfo, allocator, &imageMemory) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate transient attachment memory!");
+    }
+
+    vkBindImageMemory(device, image, imageMemory, 0);
+
+    allocationSize = memRequirements.size;
+    return lazilyAllocated;
+}
 /*
     Utility function to transition the layout of a Vulkan image.
     This function performs a layout transition for an image using a pipeline barrier.
@@ -513,7 +612,8 @@ inline VkImageView createImageView(
     VkImage image,                   // Vulkan image for which the view is created.
     VkFormat format,                 // Format of the image (e.g., VK_FORMAT_R8G8B8A8_SRGB).
     VkImageAspectFlags aspectFlags,  // Aspect of the image to view (e.g., color, depth, stencil).
-    uint32_t mipLevels               // Number of mip levels in the image.
+    uint32_t mipLevels,              // Number of mip levels in the image.
+    const VkAllocationCallbacks* allocator // Host allocation callbacks (nullptr for the driver default).
 ) {
     // Configure the image view creation information.
     VkImageViewCreateInfo viewInfo{};
@@ -531,7 +631,7 @@ inline VkImageView createImageView(
 
     // Create the image view.
     VkImageView imageView;
-    if (vkCreateImageView(device, &viewInfo, nullptr, &imageView) != VK_SUCCESS) {
+    if (vkCreateImageView(device, &viewInfo, allocator, &imageView) != VK_SUCCESS) {
         // Throw an error if image view creation fails.
         throw std::runtime_error("Failed to create texture image view!");
     }
@@ -12,7 +12,11 @@
 #include <gtx/string_cast.hpp>          	 
 #include <set>                     
 #include <algorithm>    
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
 #include <iostream>  
+#include <numeric>
 
 
 
@@ -39,6 +43,7 @@ void VulkanRenderer::Run() {
 <<<<<<< HEAD
 =======
 	// Initialize window, Vulkan, and ImGui
+	auto startupStart = std::chrono::high_resolution_clock::now();
 >>>>>>> Testing
 	InitWindow();
 	InitVulkan();
@@ -51,6 +56,14 @@ void VulkanRenderer::Run() {
 }
 
 =======
+	// Pipeline creation dominates startup when the cache is cold.
+	startupTimeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startupStart).count();
+	if (statsReportRequested) {
+		std::cout << "Startup: " << std::fixed << std::setprecision(1) << startupTimeMs << " ms, pipeline cache "
+			<< (pipelineCache->WasLoaded() ? "warm" : "cold") << " (" << pipelineCache->GetPath() << ": " << pipelineCache->GetLoadResult()
+			<< ", " << pipelineCache->GetLoadedSize() / 1024.0 << " KiB)\n" << std::defaultfloat;
+	}
+
 	// Set up the camera.
 	camera = std::make_unique<Camera>(glm::vec3(0.0f, 0.0f, 3.0f));
 
@@ -150,27 +163,71 @@ void VulkanRenderer::Update(float deltaTime) {
 		camera->ProcessKeyboard(DOWN, deltaTime);
 }
 
-void VulkanRenderer::AddModel(const std::string& modelPath, const std::string& texturePath) {
+/**
+ * @brief Adds a model that references the given mesh and texture files.
+ *
+ * Meshes and textures are loaded once and shared through the renderer's caches, so adding a copy of
+ * an existing model only creates a new transform. A new texture writes one element of the bindless texture
+ * array and nothing else. Must not be called while a command buffer is being recorded; use RequestModelSpawn from UI code.
+ *
+ * @param modelPath Path to the mesh file.
+ * @param texturePath Path to the texture file.
+ * @param position Initial world-space position of the model.
+ */
+void VulkanRenderer::AddModel(const std::string& modelPath, const std::string& texturePath, const glm::vec3& position) {
 	try {
-		// Create a new model instance
-		auto newModel = std::make_unique<Model>(device, physicalDevice, graphicsQueue, commandPool);
-		newModel->LoadFromFile(modelPath);
-		newModel->LoadTexture(texturePath);
-
-		// Optionally set initial transformation values here
-		newModel->SetPosition(glm::vec3(0.0f));  // Example position
-
-		// Add the new model to your list
-		modelList.push_back(std::move(newModel));
-
-		// Update the descriptor sets to account for the new model.
-		// Depending on your current implementation, you may need to reallocate your descriptor sets.
-		CreateDescriptorSets();
+		// Create a new entity that shares the cached mesh and texture.
+		scene.CreateEntity(GetOrLoadMesh(modelPath).get(), GetOrLoadTexture(texturePath).get(), position);
 	}
 	catch (const std::exception& e) {
 		std::cerr << "Failed to add model: " << e.what() << "\n";
 	}
 }
+/**
+ * @brief Queues copies of the default model to be added before the next frame is recorded.
+ *
+ * UI callbacks run while the frame's command buffer is being recorded, so they cannot touch
+ * buffers or descriptor sets directly.
+ *
+ * @param count Number of models to add.
+ */
+void VulkanRenderer::RequestModelSpawn(uint32_t count) {
+	pendingModelSpawns += count;
+}
+/**
+ * @brief Chooses between dynamic rendering and the render pass path. Must be called before Run.
+ *
+ * Dynamic rendering is only used if the device supports it; otherwise the render pass and
+ * framebuffers are created as before.
+ *
+ * @param enabled Whether dynamic rendering should be used when available.
+ */
+void VulkanRenderer::SetDynamicRenderingEnabled(bool enabled) {
+	dynamicRenderingRequested = enabled;
+}
+/**
+ * @brief Prints the startup timing and, at exit, the host allocation report to stdout. Must be called before Run.
+ *
+ * Both are on the stats overlay while the app runs; the printed report adds what the overlay
+ * cannot show, such as allocations still live after every Vulkan object has been destroyed.
+ *
+ * @param enabled Whether the reports should be printed.
+ */
+void VulkanRenderer::SetStatsReportEnabled(bool enabled) {
+	statsReportRequested = enabled;
+}
+/**
+ * @brief Compiles every shader the renderer uses into the bundle it loads at startup.
+ *
+ * Needs no window or device. The bundle is built with this build's optimization settings, and
+ * the instruction count of each shader before and after optimization is written to out.
+ *
+ * @throws std::runtime_error if a shader fails to compile or the bundle cannot be written.
+ */
+void VulkanRenderer::BuildShaderBundle(std::ostream& out) {
+	ShaderCompiler compiler("VulkanShaders/cache");
+	compiler.WriteBundle(SHADER_BUNDLE_PATH, { VERTEX_SHADER_PATH, FRAGMENT_SHADER_PATH, DEPTH_SHADER_PATH, CULL_SHADER_PATH }, out);
+}
 
 
 
@@ -254,7 +311,7 @@ void VulkanRenderer::InitImGui() {
 	init_info.Device = device;
 	init_info.QueueFamily = FindQueueFamilies(physicalDevice).graphicsFamily.value();
 	init_info.Queue = graphicsQueue;
-	init_info.PipelineCache = VK_NULL_HANDLE;
+	init_info.PipelineCache = pipelineCache->Get();
 	init_info.DescriptorPool = descriptorPool;
 	init_info.Subpass = 0;
 	init_info.MinImageCount = 3;
@@ -265,10 +322,21 @@ void VulkanRenderer::InitImGui() {
 	init_info.CheckVkResultFn = check_vk_result;
 	init_info.RenderPass = renderPass;
 =======
-	init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;	// Force a single sample for IMGUI
-	init_info.Allocator = nullptr;
+	init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;	// The overlay draws onto the resolved, single-sample image
+	init_info.Allocator = allocator;
 	init_info.CheckVkResultFn = check_vk_result;
-	init_info.RenderPass = imguiRenderPass;			// Use the dedicated ImGui render pass
+	if (useDynamicRendering) {
+		// The overlay is drawn in its own rendering scope on the swap chain image.
+		init_info.UseDynamicRendering = true;
+		init_info.PipelineRenderingCreateInfo = {};
+		init_info.PipelineRenderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+		init_info.PipelineRenderingCreateInfo.colorAttachmentCount = 1;
+		init_info.PipelineRenderingCreateInfo.pColorAttachmentFormats = &swapChainImageFormat;
+	}
+	else {
+		init_info.RenderPass = renderPass;
+		init_info.Subpass = 1;						// The main render pass's overlay subpass
+	}
 >>>>>>> Testing
 
 	ImGui_ImplVulkan_Init(&init_info);
@@ -309,10 +377,13 @@ void VulkanRenderer::InitVulkan() {
 	// Memory and Resources
 =======
 	// Swap Chain and Pipeline Setup
+	pipelineCache = std::make_unique<PipelineCache>(device, physicalDevice, allocator);
+	shaderCompiler = std::make_unique<ShaderCompiler>("VulkanShaders/cache");
+	shaderCompiler->LoadBundle(SHADER_BUNDLE_PATH);
+	layoutCache = std::make_unique<LayoutCache>(device, allocator);
 	CreateSwapChain();
 	CreateImageViews();
 	CreateRenderPass();
-	CreateImGuiRenderPass();
 	CreateDescriptorSetLayout();
 	CreateGraphicsPipeline();
 
@@ -328,10 +399,24 @@ void VulkanRenderer::InitVulkan() {
 	// Model and Descriptor Setup
 	LoadModels();
 =======
-	CreateImGuiFramebuffers();
-	CreateUniformBuffers();
+	CreateFrameRingBuffer(INITIAL_INSTANCE_CAPACITY);
+	CreateIndirectBuffers(INITIAL_INDIRECT_CAPACITY);
+	gpuCuller = std::make_unique<GpuCuller>(device, physicalDevice, allocator, pipelineCache->Get(), shaderCompiler->Compile(CULL_SHADER_PATH), MAX_FRAMES_IN_FLIGHT, MAX_DRAW_RUNS);
+	gpuCuller->Resize(instanceCapacity, indirectCapacity);
+	gpuTimer = std::make_unique<GpuTimer>(device, physicalDevice, allocator, FindQueueFamilies(physicalDevice).graphicsFamily.value(),
+		MAX_FRAMES_IN_FLIGHT, TIMESTAMP_COUNT);
+	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+		renderGraphs.push_back(std::make_unique<RenderGraph>());
+	}
+	geometryBuffer = std::make_unique<GeometryBuffer>(device, physicalDevice, graphicsQueue, commandPool, allocator);
+	// One recorder slot per frame in flight and polygon mode, so toggling wireframe keeps both cached.
+	commandRecorder = std::make_unique<ParallelCommandRecorder>(device, FindQueueFamilies(physicalDevice).graphicsFamily.value(), allocator,
+		MAX_FRAMES_IN_FLIGHT * POLYGON_MODE_COUNT, threadPool.GetWorkerCount() + 1);
+	sceneCommandKeys.resize(MAX_FRAMES_IN_FLIGHT * POLYGON_MODE_COUNT);
+	recordingThreadCount = commandRecorder->GetMaxRanges();
 
 	// Model and Descriptor Setup
+	CreateTextureDescriptorSet();
 	LoadDefualtModels();
 >>>>>>> Testing
 	CreateDescriptorPool();
@@ -379,6 +464,17 @@ void VulkanRenderer::MainLoop() {
 		// Update frame count.
 		frameCount++;
 
+		// Keep a short frame-time history; a frame over twice the history's average is a hitch.
+		const float frameTimeMs = deltaTime * 1000.0f;
+		const float averageFrameTimeMs = frameTimeHistorySumMs / static_cast<float>(FRAME_TIME_HISTORY_SIZE);
+		if (frameCount > FRAME_TIME_HISTORY_SIZE && frameTimeMs > 2.0f * averageFrameTimeMs) {
+			hitchCount++;
+			lastHitchMs = frameTimeMs;
+		}
+		frameTimeHistorySumMs += frameTimeMs - frameTimeHistory[frameTimeHistoryIndex];
+		frameTimeHistory[frameTimeHistoryIndex] = frameTimeMs;
+		frameTimeHistoryIndex = (frameTimeHistoryIndex + 1) % FRAME_TIME_HISTORY_SIZE;
+
 		// Update FPS once per second.
 >>>>>>> Testing
 		static float fpsAccumulator = 0.0f;
@@ -430,10 +526,6 @@ void VulkanRenderer::CleanUp() {
 	// Clean up GUI 
 =======
 	// --- Clean up IMGUI resources ---
-	// Destroy the IMGUI render pass.
-	if (imguiRenderPass != VK_NULL_HANDLE) {
-		vkDestroyRenderPass(device, imguiRenderPass, nullptr);
-	}
 	// Shut down the ImGui Vulkan and GLFW implementations and destroy the context.
 >>>>>>> Testing
 	ImGui_ImplVulkan_Shutdown();
@@ -452,23 +544,20 @@ void VulkanRenderer::CleanUp() {
 	// Destroy pipeline and rendering resources.
 =======
 	// --- Clean up model resources ---
-	for (auto& model : modelList) {
-		model.reset(); // Releases each model.
-	}
+	scene.Clear();
+	// Release the shared meshes and textures once no entity references them.
+	meshCache.clear();
+	textureCache.clear();
+	geometryBuffer.reset();
 
 	// --- Clean up swapchain-specific resources ---
 	CleanupSwapChain();
 
 	// --- Destroy pipeline and render resources ---
 >>>>>>> Testing
-	if (graphicsPipeline != VK_NULL_HANDLE) {
-		vkDestroyPipeline(device, graphicsPipeline, nullptr);
-	}
-	if (pipelineLayout != VK_NULL_HANDLE) {
-		vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
-	}
+	pipelineStates.reset();  // Owns graphicsPipeline and every other variant.
 	if (renderPass != VK_NULL_HANDLE) {
-		vkDestroyRenderPass(device, renderPass, nullptr);
+		vkDestroyRenderPass(device, renderPass, allocator);
 	}
 
 <<<<<<< HEAD
@@ -476,23 +565,26 @@ void VulkanRenderer::CleanUp() {
 =======
 	// --- Clean up per-frame resources (semaphores, fences, uniform buffers) ---
 >>>>>>> Testing
-	for (size_t i = 0; i < swapChainImages.size(); i++) {
+	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
 		if (renderFinishedSemaphores[i] != VK_NULL_HANDLE) {
-			vkDestroySemaphore(device, renderFinishedSemaphores[i], nullptr);
+			vkDestroySemaphore(device, renderFinishedSemaphores[i], allocator);
 		}
 		if (imageAvailableSemaphores[i] != VK_NULL_HANDLE) {
-			vkDestroySemaphore(device, imageAvailableSemaphores[i], nullptr);
+			vkDestroySemaphore(device, imageAvailableSemaphores[i], allocator);
 		}
 		if (inFlightFences[i] != VK_NULL_HANDLE) {
-			vkDestroyFence(device, inFlightFences[i], nullptr);
-		}
-		if (uniformBuffers[i] != VK_NULL_HANDLE) {
-			vkDestroyBuffer(device, uniformBuffers[i], nullptr);
-		}
-		if (uniformBuffersMemory[i] != VK_NULL_HANDLE) {
-			vkFreeMemory(device, uniformBuffersMemory[i], nullptr);
+			vkDestroyFence(device, inFlightFences[i], allocator);
 		}
 	}
+	frameRing.reset();
+	DestroyIndirectBuffers();
+	gpuCuller.reset();
+	gpuTimer.reset();
+	// Every pipeline has been created by now, so the cache holds everything the next run needs.
+	pipelineCache->Save();
+	pipelineCache.reset();
+	renderGraphs.clear();
+	commandRecorder.reset();
 
 <<<<<<< HEAD
 	// Destroy descriptor resources (pool and layout).
@@ -500,11 +592,13 @@ void VulkanRenderer::CleanUp() {
 	// --- Destroy descriptor resources ---
 >>>>>>> Testing
 	if (descriptorPool != VK_NULL_HANDLE) {
-		vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+		vkDestroyDescriptorPool(device, descriptorPool, allocator);
 	}
-	if (descriptorSetLayout != VK_NULL_HANDLE) {
-		vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+	frameDescriptorAllocators.clear();
+	if (textureDescriptorPool != VK_NULL_HANDLE) {
+		vkDestroyDescriptorPool(device, textureDescriptorPool, allocator);
 	}
+	layoutCache.reset();  // Owns the descriptor set layouts and pipelineLayout.
 
 <<<<<<< HEAD
 	// Destroy the command pool.
@@ -512,7 +606,7 @@ void VulkanRenderer::CleanUp() {
 	// --- Destroy the command pool ---
 >>>>>>> Testing
 	if (commandPool != VK_NULL_HANDLE) {
-		vkDestroyCommandPool(device, commandPool, nullptr);
+		vkDestroyCommandPool(device, commandPool, allocator);
 	}
 
 <<<<<<< HEAD
@@ -521,7 +615,7 @@ void VulkanRenderer::CleanUp() {
 	// --- Destroy the Vulkan logical device ---
 >>>>>>> Testing
 	if (device != VK_NULL_HANDLE) {
-		vkDestroyDevice(device, nullptr);
+		vkDestroyDevice(device, allocator);
 	}
 
 <<<<<<< HEAD
@@ -530,7 +624,7 @@ void VulkanRenderer::CleanUp() {
 	// --- Destroy the debug messenger (if enabled) ---
 >>>>>>> Testing
 	if (enableValidationLayer && debugMessenger != VK_NULL_HANDLE) {
-		DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
+		DestroyDebugUtilsMessengerEXT(instance, debugMessenger, allocator);
 	}
 
 <<<<<<< HEAD
@@ -539,7 +633,7 @@ void VulkanRenderer::CleanUp() {
 	// --- Destroy the Vulkan surface ---
 >>>>>>> Testing
 	if (surface != VK_NULL_HANDLE) {
-		vkDestroySurfaceKHR(instance, surface, nullptr);
+		vkDestroySurfaceKHR(instance, surface, allocator);
 	}
 
 <<<<<<< HEAD
@@ -548,7 +642,12 @@ void VulkanRenderer::CleanUp() {
 	// --- Destroy the Vulkan instance ---
 >>>>>>> Testing
 	if (instance != VK_NULL_HANDLE) {
-		vkDestroyInstance(instance, nullptr);
+		vkDestroyInstance(instance, allocator);
+	}
+
+	// Report host allocation usage now that every Vulkan object has been released.
+	if (enableHostAllocator && statsReportRequested) {
+		hostAllocator.PrintStats(std::cout);
 	}
 
 <<<<<<< HEAD
@@ -632,7 +731,7 @@ void VulkanRenderer::CreateInstance() {
 	}
 
 	// Create the Vulkan instance and check for errors.
-	if (vkCreateInstance(&createInfo, nullptr, &instance) != VK_SUCCESS) {
+	if (vkCreateInstance(&createInfo, allocator, &instance) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create Vulkan instance!\n");
 	}
 }
@@ -654,7 +753,7 @@ void VulkanRenderer::SetupDebugMessenger() {
 	PopulateDebugMessengerCreateInfo(createInfo);
 
 	// Create the debug messenger and check for errors.
-	if (CreateDebugUtilsMessengerEXT(instance, &createInfo, nullptr, &debugMessenger) != VK_SUCCESS) {
+	if (CreateDebugUtilsMessengerEXT(instance, &createInfo, allocator, &debugMessenger) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to set up Debug Messenger!\n");
 	}
 }
@@ -668,7 +767,7 @@ void VulkanRenderer::SetupDebugMessenger() {
  */
 void VulkanRenderer::CreateSurface() {
 	// Create a window surface using GLFW, associating it with the Vulkan instance.
-	if (glfwCreateWindowSurface(instance, window, nullptr, &surface) != VK_SUCCESS) {
+	if (glfwCreateWindowSurface(instance, window, allocator, &surface) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create window surface!");
 	}
 }
@@ -747,19 +846,111 @@ void VulkanRenderer::CreateLogicalDevice() {
 	deviceFeatures.sampleRateShading = VK_TRUE;  // Enable sample shading for smoother rendering.
 	deviceFeatures.fillModeNonSolid = VK_TRUE;   // Enable non-solid fill modes
 
+	// Indirect draws need firstInstance to address the instance buffer; multi-draw is optional.
+	VkPhysicalDeviceFeatures supportedFeatures;
+	vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+	indirectDrawSupported = supportedFeatures.drawIndirectFirstInstance == VK_TRUE;
+	multiDrawIndirectSupported = supportedFeatures.multiDrawIndirect == VK_TRUE;
+	deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+	deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+	useIndirectDraw = indirectDrawSupported;
+
+	uint32_t extensionCount = 0;
+	vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+	vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+	auto hasExtension = [&](const char* name) {
+		return std::any_of(availableExtensions.begin(), availableExtensions.end(),
+			[name](const VkExtensionProperties& extension) { return std::strcmp(extension.extensionName, name) == 0; });
+	};
+
+	// DrawIndexedIndirectCount lets the GPU culling pass decide how many draws are issued.
+	VkPhysicalDeviceVulkan12Features supportedVulkan12Features{};
+	supportedVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	VkPhysicalDeviceFeatures2 supportedFeatures2{};
+	supportedFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	supportedFeatures2.pNext = &supportedVulkan12Features;
+
+	// Wireframe is a dynamic polygon mode where VK_EXT_extended_dynamic_state3 allows it, and a
+	// separate pipeline variant otherwise.
+	const bool extendedDynamicState3Extension = hasExtension(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+	VkPhysicalDeviceExtendedDynamicState3FeaturesEXT supportedExtendedDynamicState3Features{};
+	supportedExtendedDynamicState3Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+	if (extendedDynamicState3Extension) {
+		supportedExtendedDynamicState3Features.pNext = supportedFeatures2.pNext;
+		supportedFeatures2.pNext = &supportedExtendedDynamicState3Features;
+	}
+
+	// Dynamic rendering (core in 1.3) replaces the render pass and framebuffers. ImGui looks its entry
+	// points up by the extension's names, so the extension is enabled along with the feature.
+	VkPhysicalDeviceProperties deviceProperties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+	const bool vulkan13Device = deviceProperties.apiVersion >= VK_API_VERSION_1_3;
+	VkPhysicalDeviceVulkan13Features supportedVulkan13Features{};
+	supportedVulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+	if (vulkan13Device) {
+		supportedVulkan12Features.pNext = &supportedVulkan13Features;
+	}
+	vkGetPhysicalDeviceFeatures2(physicalDevice, &supportedFeatures2);
+	drawIndirectCountSupported = supportedVulkan12Features.drawIndirectCount == VK_TRUE;
+	dynamicPolygonModeSupported = extendedDynamicState3Extension
+		&& supportedExtendedDynamicState3Features.extendedDynamicState3PolygonMode == VK_TRUE;
+	useDynamicRendering = dynamicRenderingRequested && vulkan13Device
+		&& supportedVulkan13Features.dynamicRendering == VK_TRUE && hasExtension(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+
+	VkPhysicalDeviceVulkan12Features vulkan12Features{};
+	vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	vulkan12Features.drawIndirectCount = supportedVulkan12Features.drawIndirectCount;
+
+	// Bindless textures: one partially bound, update-after-bind sampler array indexed per instance.
+	// IsDeviceSuitable has already rejected devices without these features.
+	vulkan12Features.descriptorIndexing = VK_TRUE;
+	vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+	vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+	vulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+	vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+	vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+
+	VkPhysicalDeviceVulkan13Features vulkan13Features{};
+	vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+	vulkan13Features.dynamicRendering = VK_TRUE;
+	std::vector<const char*> enabledExtensions = deviceExtensions;
+	if (useDynamicRendering) {
+		vulkan12Features.pNext = &vulkan13Features;
+		enabledExtensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+	}
+
 	VkPhysicalDeviceExtendedDynamicState3FeaturesEXT extendedDynamicState3Features{};
 	extendedDynamicState3Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
 	extendedDynamicState3Features.extendedDynamicState3PolygonMode = VK_TRUE;
+	extendedDynamicState3Features.pNext = &vulkan12Features;
+	if (dynamicPolygonModeSupported) {
+		enabledExtensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+	}
+
+	VkPhysicalDeviceDescriptorIndexingProperties descriptorIndexingProperties{};
+	descriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+	VkPhysicalDeviceProperties2 properties2{};
+	properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	properties2.pNext = &descriptorIndexingProperties;
+	vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+	textureDescriptorCapacity = std::min({
+		MAX_TEXTURES,
+		descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers,
+		descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+		descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+		descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSampledImages });
 
 	// Configure the logical device creation information.
 	VkDeviceCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;       // Specify the structure type.
 	createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()); // Number of queues.
 	createInfo.pQueueCreateInfos = queueCreateInfos.data();        // Pointer to queue creation info.
-	createInfo.pNext = &extendedDynamicState3Features;			   // Link the feature struct to the chain
+	createInfo.pNext = dynamicPolygonModeSupported                 // Link the feature structs to the chain
+		? static_cast<const void*>(&extendedDynamicState3Features) : &vulkan12Features;
 	createInfo.pEnabledFeatures = &deviceFeatures;                 // Pointer to enabled device features.
-	createInfo.ppEnabledExtensionNames = deviceExtensions.data();  // Extensions to enable.
-	createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size()); // Number of extensions.
+	createInfo.ppEnabledExtensionNames = enabledExtensions.data();  // Extensions to enable.
+	createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size()); // Number of extensions.
 
 	// Include validation layers if they are enabled.
 	if (enableValidationLayer) {
@@ -771,13 +962,22 @@ void VulkanRenderer::CreateLogicalDevice() {
 	}
 
 	// Create the logical device and check for errors.
-	if (vkCreateDevice(physicalDevice, &createInfo, nullptr, &device) != VK_SUCCESS) {
+	if (vkCreateDevice(physicalDevice, &createInfo, allocator, &device) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create logical device!");
 	}
 
 	// Retrieve handles for the graphics and presentation queues.
 	vkGetDeviceQueue(device, indices.graphicsFamily.value(), 0, &graphicsQueue);
 	vkGetDeviceQueue(device, indices.presentFamily.value(), 0, &presentQueue);
+
+	// Device-level entry point for the dynamic polygon mode, used every frame by every recording thread.
+	if (dynamicPolygonModeSupported) {
+		cmdSetPolygonMode = reinterpret_cast<PFN_vkCmdSetPolygonModeEXT>(
+			vkGetDeviceProcAddr(device, "vkCmdSetPolygonModeEXT"));
+		if (!cmdSetPolygonMode) {
+			throw std::runtime_error("Failed to load vkCmdSetPolygonModeEXT!");
+		}
+	}
 }
 /**
  * @brief Creates the Vulkan swap chain.
@@ -841,7 +1041,7 @@ void VulkanRenderer::CreateSwapChain() {
 	createInfo.oldSwapchain = VK_NULL_HANDLE;                                  // No existing swap chain to replace.
 
 	// Create the swap chain and check for errors.
-	if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &swapChain) != VK_SUCCESS) {
+	if (vkCreateSwapchainKHR(device, &createInfo, allocator, &swapChain) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create swap chain!");
 	}
 
@@ -872,7 +1072,8 @@ void VulkanRenderer::CreateImageViews() {
 			swapChainImages[i],         // Swap chain image to create a view for.
 			swapChainImageFormat,       // Image format (matches swap chain format).
 			VK_IMAGE_ASPECT_COLOR_BIT,  // Aspect mask specifying the color aspect.
-			1                           // Number of mip levels (no mipmaps for swap chain images).
+			1,                          // Number of mip levels (no mipmaps for swap chain images).
+			allocator                   // Host allocation callbacks.
 		);
 	}
 }
@@ -880,18 +1081,26 @@ void VulkanRenderer::CreateImageViews() {
  * @brief Creates the Vulkan render pass.
  *
  * A render pass defines how rendering operations interact with attachments (color, depth, resolve).
- * This method sets up color, depth, and resolve attachments, a subpass for rendering, and dependencies
- * to ensure proper synchronization.
+ * This method sets up color, depth, and resolve attachments, and dependencies to ensure proper
+ * synchronization. Subpass 0 draws the scene into the multisampled attachments and resolves it into
+ * the swap chain image; subpass 1 draws the ImGui overlay straight onto the resolved image, so the
+ * overlay costs no extra load and store of the full-screen target.
+ *
+ * Not created when dynamic rendering is used; the attachments are then given at record time.
  *
  * @throws std::runtime_error if the render pass creation fails.
  */
 void VulkanRenderer::CreateRenderPass() {
+	if (useDynamicRendering) {
+		return;
+	}
+
 	// Configure the color attachment.
 	VkAttachmentDescription colorAttachment{};
 	colorAttachment.format = swapChainImageFormat;							 // Format of the swap chain images.
 	colorAttachment.samples = msaaSamples;								     // Use multisampling for the color attachment.
 	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;					 // Clear the attachment at the start of rendering.
-	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;					 // Store the attachment contents after rendering.
+	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;				 // Only the resolved image is kept, so the transient MSAA contents can be discarded.
 	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;		 // No stencil operations.
 	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;               // Image layout before rendering.
@@ -956,7 +1165,7 @@ void VulkanRenderer::CreateRenderPass() {
 =======
 >>>>>>> Testing
 
-	// Configure the subpass.
+	// Configure the scene subpass.
 	VkSubpassDescription subpass{};
 	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS; // Graphics pipeline binding.
 	subpass.colorAttachmentCount = 1;                           // Number of color attachments.
@@ -964,6 +1173,14 @@ void VulkanRenderer::CreateRenderPass() {
 	subpass.pDepthStencilAttachment = &depthAttachmentRef;      // Reference to the depth attachment.
 	subpass.pResolveAttachments = &colorAttachmentResolveRef;   // Reference to the resolve attachment.
 
+	// Configure the overlay subpass, which renders onto the resolved image.
+	VkSubpassDescription overlaySubpass{};
+	overlaySubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	overlaySubpass.colorAttachmentCount = 1;
+	overlaySubpass.pColorAttachments = &colorAttachmentResolveRef;
+
+	std::array<VkSubpassDescription, 2> subpasses = { subpass, overlaySubpass };
+
 	// Configure the subpass dependency for synchronization.
 	VkSubpassDependency dependency{};
 	dependency.srcSubpass = VK_SUBPASS_EXTERNAL;       // External subpass (pre-rendering).
@@ -976,6 +1193,18 @@ void VulkanRenderer::CreateRenderPass() {
 	dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
 		VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;  // Write access for color and depth.
 
+	// The overlay blends over the resolve, which is written at the end of the scene subpass.
+	VkSubpassDependency overlayDependency{};
+	overlayDependency.srcSubpass = 0;
+	overlayDependency.dstSubpass = 1;
+	overlayDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	overlayDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	overlayDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	overlayDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	overlayDependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+	std::array<VkSubpassDependency, 2> dependencies = { dependency, overlayDependency };
+
 	// Combine attachments into an array.
 	std::array<VkAttachmentDescription, 3> attachments = {
 		colorAttachment, depthAttachment, colorAttachmentResolve
@@ -986,251 +1215,149 @@ void VulkanRenderer::CreateRenderPass() {
 	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO; // Specify the structure type.
 	renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size()); // Number of attachments.
 	renderPassInfo.pAttachments = attachments.data();  // Pointer to the attachment array.
-	renderPassInfo.subpassCount = 1;                   // Number of subpasses.
-	renderPassInfo.pSubpasses = &subpass;              // Pointer to the subpass description.
-	renderPassInfo.dependencyCount = 1;                // Number of dependencies.
-	renderPassInfo.pDependencies = &dependency;        // Pointer to the dependency.
+	renderPassInfo.subpassCount = static_cast<uint32_t>(subpasses.size());        // Number of subpasses.
+	renderPassInfo.pSubpasses = subpasses.data();                                 // Pointer to the subpass descriptions.
+	renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());  // Number of dependencies.
+	renderPassInfo.pDependencies = dependencies.data();                           // Pointer to the dependencies.
 
 	// Create the render pass and check for errors.
-	if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS) {
+	if (vkCreateRenderPass(device, &renderPassInfo, allocator, &renderPass) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create render pass!");
 	}
 }
-<<<<<<< HEAD
-=======
-void VulkanRenderer::CreateImGuiRenderPass() {
-	VkAttachmentDescription colorAttachment{};
-	colorAttachment.format = swapChainImageFormat;
-	colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;			// Use a single sample for ImGui
-	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;		// Use LOAD to preserve the previously rendered scene
-	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-	VkAttachmentReference colorAttachmentRef{};
-	colorAttachmentRef.attachment = 0;
-	colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-	VkSubpassDescription subpass{};
-	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-	subpass.colorAttachmentCount = 1;
-	subpass.pColorAttachments = &colorAttachmentRef;
-
-	VkRenderPassCreateInfo renderPassInfo{};
-	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-	renderPassInfo.attachmentCount = 1;
-	renderPassInfo.pAttachments = &colorAttachment;
-	renderPassInfo.subpassCount = 1;
-	renderPassInfo.pSubpasses = &subpass;
-
-	if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &imguiRenderPass) != VK_SUCCESS) {
-		throw std::runtime_error("Failed to create ImGui render pass!");
-	}
-}
->>>>>>> Testing
 /**
- * @brief Creates the descriptor set layout.
+ * @brief Creates the descriptor set layouts from the scene shaders' reflected interface.
  *
- * A descriptor set layout defines the structure of resource bindings (e.g., uniform buffers,
- * samplers) used by shaders. This method sets up bindings for a uniform buffer and a combined
- * image sampler.
+ * The bindings come from the SPIR-V of shader.vert and shader.frag, so the layouts follow the
+ * shaders rather than being restated here. What the shaders cannot express is added on top:
+ * in set 0 the camera uniform block and instance slice are dynamic descriptors into the frame
+ * ring buffer, and set 1's bindless texture array is sized to textureDescriptorCapacity and is
+ * partially bound and update-after-bind. The CPU structs and vertex attributes are checked
+ * against the shaders' block layouts and inputs first, so a mismatch fails at load instead of
+ * rendering garbage.
  *
- * @throws std::runtime_error if descriptor set layout creation fails.
+ * @throws std::runtime_error if the shaders do not match the CPU structs or layout creation fails.
  */
 void VulkanRenderer::CreateDescriptorSetLayout() {
-	// Define a binding for a uniform buffer object (UBO).
-	VkDescriptorSetLayoutBinding uboLayoutBinding{};
-	uboLayoutBinding.binding = 0;                                // Binding index in the shader.
-	uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; // Type of resource (UBO).
-	uboLayoutBinding.descriptorCount = 1;                        // Number of UBOs bound.
-	uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;    // Accessible in the vertex shader.
-	uboLayoutBinding.pImmutableSamplers = nullptr;               // No immutable samplers.
-
-	// Define a binding for a combined image sampler (texture).
-	VkDescriptorSetLayoutBinding samplerLayoutBinding{};
-	samplerLayoutBinding.binding = 1;                               // Binding index in the shader.
-	samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; // Type: texture sampler.
-	samplerLayoutBinding.descriptorCount = 1;                       // Number of samplers bound.
-	samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT; // Accessible in the fragment shader.
-	samplerLayoutBinding.pImmutableSamplers = nullptr;              // No immutable samplers.
-
-	// Combine both bindings into an array.
-	std::array<VkDescriptorSetLayoutBinding, 2> bindings = { uboLayoutBinding, samplerLayoutBinding };
-
-	// Configure the descriptor set layout creation information.
-	VkDescriptorSetLayoutCreateInfo layoutInfo{};
-	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO; // Specify the structure type.
-	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());       // Number of bindings.
-	layoutInfo.pBindings = bindings.data();                                 // Pointer to the bindings.
-
-	// Create the descriptor set layout and check for errors.
-	if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS) {
-		throw std::runtime_error("Failed to create descriptor set layout!");
+	sceneShaderInterface = ShaderReflection::Reflect(shaderCompiler->Compile(VERTEX_SHADER_PATH));
+	sceneShaderInterface.Merge(ShaderReflection::Reflect(shaderCompiler->Compile(FRAGMENT_SHADER_PATH)));
+	sceneShaderInterface.CheckBufferLayout(0, 0, sizeof(UniformBufferObject), 0);
+	sceneShaderInterface.CheckBufferLayout(0, 1, 0, sizeof(InstanceData));
+	sceneShaderInterface.CheckBufferLayout(0, 2, 0, sizeof(uint32_t));
+	sceneShaderInterface.CheckVertexInputs(Vertex::GetAttributeDescriptions());
+	// The depth pre-pass shares the scene's pipeline layout and reads the position stream.
+	ShaderReflection depthInterface = ShaderReflection::Reflect(shaderCompiler->Compile(DEPTH_SHADER_PATH));
+	depthInterface.CheckBufferLayout(0, 0, sizeof(UniformBufferObject), 0);
+	depthInterface.CheckBufferLayout(0, 1, 0, sizeof(InstanceData));
+	depthInterface.CheckBufferLayout(0, 2, 0, sizeof(uint32_t));
+	depthInterface.CheckVertexInputs(Vertex::GetPositionAttributeDescriptions());
+
+	std::vector<DescriptorSetLayoutDesc> sets = LayoutCache::DescribeSets(sceneShaderInterface);
+	if (sets.size() != 2) {
+		throw std::runtime_error("Scene shaders must use descriptor sets 0 and 1!");
 	}
+
+	// Set 0: the uniform block and instances are bound at a per-frame offset into the ring buffer.
+	sets[0].FindBinding(0)->descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+	sets[0].FindBinding(1)->descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+	descriptorSetLayout = layoutCache->GetSetLayout(sets[0]);
+
+	// Set 1: unwritten elements are allowed (partially bound), and new textures may be written
+	// while earlier frames that never sample them are still in flight.
+	sets[1].FindBinding(0)->descriptorCount = textureDescriptorCapacity;
+	sets[1].SetBindingFlags(0,
+		VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+		VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+		VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT);
+	sets[1].flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+	textureDescriptorSetLayout = layoutCache->GetSetLayout(sets[1]);
 }
 /**
- * @brief Creates the Vulkan graphics pipeline.
+ * @brief Creates the pipeline layout and the scene pipeline.
+ *
+ * Pipelines themselves come from the PipelineStateCache, one per PipelineDesc. The fill variant
+ * is compiled here and is the fallback for any variant still compiling. Without
+ * VK_EXT_extended_dynamic_state3 the polygon mode cannot be set at record time, so the
+ * wireframe variant is queued on the compile thread right away and toggling it stays a lookup.
  *
- * The graphics pipeline defines the entire rendering process, including shaders, input assembly,
- * rasterization, blending, and more. This method sets up and configures all pipeline stages,
- * creates a pipeline layout, and compiles the graphics pipeline.
+ * The shaders are compiled from their GLSL sources, which are watched so edits are picked up by
+ * ReloadChangedShaders while the app runs.
  *
  * @throws std::runtime_error if the graphics pipeline or pipeline layout creation fails.
  */
 void VulkanRenderer::CreateGraphicsPipeline() {
-	// Load and create shader modules.
-	auto vertShaderCode = readFile("VulkanShaders/vert.spv");
-	auto fragShaderCode = readFile("VulkanShaders/frag.spv");
-
-	VkShaderModule vertShaderModule = CreateShaderModule(vertShaderCode);
-	VkShaderModule fragShaderModule = CreateShaderModule(fragShaderCode);
-
-	// Configure the vertex shader stage.
-	VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
-	vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-	vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-	vertShaderStageInfo.module = vertShaderModule;
-	vertShaderStageInfo.pName = "main"; // Entry point function.
-
-	// Configure the fragment shader stage.
-	VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
-	fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-	fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-	fragShaderStageInfo.module = fragShaderModule;
-	fragShaderStageInfo.pName = "main"; // Entry point function.
-
-	VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
-
-	// Configure vertex input for passing vertex data to the pipeline.
-	VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-
-	auto bindingDescription = Vertex::GetBindingDescription();
-	auto attributeDescriptions = Vertex::GetAttributeDescriptions();
-
-	vertexInputInfo.vertexBindingDescriptionCount = 1;
-	vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-	vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-	vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
-
-	// Configure input assembly for assembling primitives.
-	VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-	inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;  // Draw triangles.
-	inputAssembly.primitiveRestartEnable = VK_FALSE;               // No primitive restart.
-
-	// Define a viewport and scissor rectangle (dynamic states).
-	VkViewport viewport{};
-	viewport.x = 0.0f;
-	viewport.y = 0.0f;
-	viewport.width = (float)swapChainExtent.width;
-	viewport.height = (float)swapChainExtent.height;
-	viewport.minDepth = 0.0f;
-	viewport.maxDepth = 1.0f;
-
-	VkRect2D scissor{};
-	scissor.offset = { 0, 0 };
-	scissor.extent = swapChainExtent;
-
-	std::vector<VkDynamicState> dynamicStates{ 
-		VK_DYNAMIC_STATE_VIEWPORT,
-		VK_DYNAMIC_STATE_SCISSOR,
-		VK_DYNAMIC_STATE_POLYGON_MODE_EXT
-	};
-	VkPipelineDynamicStateCreateInfo dynamicState{};
-	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-	dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-	dynamicState.pDynamicStates = dynamicStates.data();
-
-	// Configure viewport and scissor in the pipeline.
-	VkPipelineViewportStateCreateInfo viewportState{};
-	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-	viewportState.viewportCount = 1;
-	viewportState.scissorCount = 1;
-
-	// Configure rasterization.
-	VkPipelineRasterizationStateCreateInfo rasterizer{};
-	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-	rasterizer.depthClampEnable = VK_FALSE;					 // Don't clamp depth values.
-	rasterizer.rasterizerDiscardEnable = VK_FALSE;           // Ensure rasterization occurs.
-	rasterizer.polygonMode = currentPolygonMode;             // Fill polygons.
-	rasterizer.lineWidth = 1.0f;
-	rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;             // Back-face culling.
-	rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;  // Counter-clockwise is front.
-	rasterizer.depthBiasEnable = VK_FALSE;
-
-	// Configure multisampling.
-	VkPipelineMultisampleStateCreateInfo multisampling{};
-	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-	multisampling.sampleShadingEnable = VK_TRUE;          // Enable sample shading.
-	multisampling.rasterizationSamples = msaaSamples;     // Multisample settings.
-	multisampling.minSampleShading = 0.2f;
-
-	// Configure depth and stencil testing.
-	VkPipelineDepthStencilStateCreateInfo depthStencil{};
-	depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-	depthStencil.depthTestEnable = VK_TRUE;
-	depthStencil.depthWriteEnable = VK_TRUE;
-	depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
-
-	// Configure color blending.
-	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
-		VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-	colorBlendAttachment.blendEnable = VK_TRUE;
-	colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-	colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-	colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-
-	VkPipelineColorBlendStateCreateInfo colorBlending{};
-	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-	colorBlending.attachmentCount = 1;
-	colorBlending.pAttachments = &colorBlendAttachment;
-
-	// Configure push constants (optional).
-	VkPushConstantRange pushConstantRange{};
-	pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-	pushConstantRange.offset = 0;
-	pushConstantRange.size = sizeof(PushConstants);
-
-	// Configure the pipeline layout.
-	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	pipelineLayoutInfo.setLayoutCount = 1;
-	pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
-	pipelineLayoutInfo.pushConstantRangeCount = 1;
-	pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
-
-	if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
-		throw std::runtime_error("Failed to create pipeline layout!");
-	}
-
-	// Configure the graphics pipeline.
-	VkGraphicsPipelineCreateInfo pipelineInfo{};
-	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-	pipelineInfo.stageCount = 2;
-	pipelineInfo.pStages = shaderStages;
-	pipelineInfo.pVertexInputState = &vertexInputInfo;
-	pipelineInfo.pInputAssemblyState = &inputAssembly;
-	pipelineInfo.pViewportState = &viewportState;
-	pipelineInfo.pRasterizationState = &rasterizer;
-	pipelineInfo.pMultisampleState = &multisampling;
-	pipelineInfo.pDepthStencilState = &depthStencil;
-	pipelineInfo.pColorBlendState = &colorBlending;
-	pipelineInfo.pDynamicState = &dynamicState;
-	pipelineInfo.layout = pipelineLayout;
-	pipelineInfo.renderPass = renderPass;
-	pipelineInfo.subpass = 0;
-
-	if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS) {
-		throw std::runtime_error("Failed to create graphics pipeline!");
-	}
-
-	// Cleanup shader modules after pipeline creation.
-	vkDestroyShaderModule(device, fragShaderModule, nullptr);
-	vkDestroyShaderModule(device, vertShaderModule, nullptr);
+	// The push constant range, if any, is whatever the shaders declare.
+	pipelineLayout = layoutCache->GetPipelineLayout({ descriptorSetLayout, textureDescriptorSetLayout }, sceneShaderInterface.pushConstants);
+
+	// The pipelines are created before the depth image, which uses the same format.
+	depthFormat = FindDepthFormat();
+	shaderWatcher = std::make_unique<FileWatcher>();
+	shaderWatcher->Watch(VERTEX_SHADER_PATH);
+	shaderWatcher->Watch(FRAGMENT_SHADER_PATH);
+	shaderWatcher->Watch(DEPTH_SHADER_PATH);
+	pipelineStates = std::make_unique<PipelineStateCache>(device, allocator, pipelineCache->Get(), shaderCompiler.get());
+	fallbackPipeline = pipelineStates->Get(ScenePipelineDesc(VK_POLYGON_MODE_FILL));
+	graphicsPipeline = fallbackPipeline;
+	if (!dynamicPolygonModeSupported) {
+		pipelineStates->Prefetch(ScenePipelineDesc(VK_POLYGON_MODE_LINE));
+	}
+}
+/**
+ * @brief Describes the scene pipeline for the current render target and shader features.
+ *
+ * Changing sceneShaderFeatures yields a different description, so the next frame picks up the
+ * matching variant, compiled on the compile threads while the previous one stays in use.
+ *
+ * @param polygonMode Fill or wireframe; only part of the key when it cannot be set dynamically.
+ * @param afterDepthPrepass Shade only the fragments the depth pre-pass kept: test for EQUAL depth and write none.
+ */
+PipelineDesc VulkanRenderer::ScenePipelineDesc(VkPolygonMode polygonMode, bool afterDepthPrepass) const {
+	PipelineDesc desc;
+	desc.vertexShader = VERTEX_SHADER_PATH;
+	desc.fragmentShader = FRAGMENT_SHADER_PATH;
+	desc.layout = pipelineLayout;
+	desc.renderPass = renderPass;  // Null with dynamic rendering, which uses the formats instead.
+	desc.subpass = 0;
+	desc.colorFormat = swapChainImageFormat;
+	desc.depthFormat = depthFormat;
+	desc.samples = msaaSamples;
+	desc.sampleShading = true;
+	desc.dynamicPolygonMode = dynamicPolygonModeSupported;
+	desc.polygonMode = dynamicPolygonModeSupported ? VK_POLYGON_MODE_FILL : polygonMode;
+	desc.alphaBlend = true;
+	desc.fragmentConstants = sceneShaderFeatures.FragmentConstants();
+	if (afterDepthPrepass) {
+		desc.depthWrite = false;
+		desc.depthCompareOp = VK_COMPARE_OP_EQUAL;
+	}
+	return desc;
+}
+/**
+ * @brief Describes the depth pre-pass pipeline: depth.vert on the position stream and no fragment shader.
+ *
+ * It targets the scene's render pass and attachments, so it is drawn in the same pass right before
+ * the color draws. Its dynamic state matches the scene pipelines', so switching between them keeps
+ * the viewport, scissor and polygon mode already set.
+ */
+PipelineDesc VulkanRenderer::DepthPrepassPipelineDesc() const {
+	PipelineDesc desc = ScenePipelineDesc(VK_POLYGON_MODE_FILL);
+	desc.vertexShader = DEPTH_SHADER_PATH;
+	desc.fragmentShader.clear();
+	desc.fragmentConstants = {};
+	desc.positionOnly = true;
+	desc.sampleShading = false;  // Without a fragment shader there is nothing to run per sample.
+	desc.alphaBlend = false;
+	return desc;
+}
+/**
+ * @brief Maps the feature toggles onto shader.frag's specialization constants.
+ */
+SpecializationConstants VulkanRenderer::SceneShaderFeatures::FragmentConstants() const {
+	SpecializationConstants constants;
+	constants.Set(0, vertexColor);
+	constants.Set(1, alphaTest);
+	constants.Set(2, alphaCutoff);
+	return constants;
 }
 /**
  * @brief Creates framebuffers for the swap chain images.
@@ -1239,9 +1366,16 @@ void VulkanRenderer::CreateGraphicsPipeline() {
  * (color, depth, and resolve attachments) for rendering. This method creates one framebuffer
  * for each swap chain image.
  *
+ * With dynamic rendering no framebuffers are needed, so swap chain recreation only rebuilds
+ * images and image views.
+ *
  * @throws std::runtime_error if any framebuffer creation fails.
  */
 void VulkanRenderer::CreateFramebuffers() {
+	if (useDynamicRendering) {
+		return;
+	}
+
 	// Resize the framebuffer vector to match the number of swap chain images.
 	swapChainFramebuffers.resize(swapChainImageViews.size());
 
@@ -1271,34 +1405,11 @@ void VulkanRenderer::CreateFramebuffers() {
 		framebufferInfo.layers = 1;                                         // Number of layers (1 for 2D images).
 
 		// Create the framebuffer and check for errors.
-		if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &swapChainFramebuffers[i]) != VK_SUCCESS) {
+		if (vkCreateFramebuffer(device, &framebufferInfo, allocator, &swapChainFramebuffers[i]) != VK_SUCCESS) {
 			throw std::runtime_error("Failed to create framebuffer!");
 		}
 	}
 }
-<<<<<<< HEAD
-=======
-void VulkanRenderer::CreateImGuiFramebuffers() {
-	imguiFramebuffers.resize(swapChainImageViews.size());
-
-	for (size_t i = 0; i < swapChainImageViews.size(); i++) {
-		VkImageView attachments[] = { swapChainImageViews[i] };
-
-		VkFramebufferCreateInfo framebufferInfo{};
-		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-		framebufferInfo.renderPass = imguiRenderPass;
-		framebufferInfo.attachmentCount = 1;
-		framebufferInfo.pAttachments = attachments;
-		framebufferInfo.width = swapChainExtent.width;
-		framebufferInfo.height = swapChainExtent.height;
-		framebufferInfo.layers = 1;
-
-		if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &imguiFramebuffers[i]) != VK_SUCCESS) {
-			throw std::runtime_error("Failed to create ImGui framebuffer!");
-		}
-	}
-}
->>>>>>> Testing
 /**
  * @brief Creates the command pool for managing command buffer allocation.
  *
@@ -1319,7 +1430,7 @@ void VulkanRenderer::CreateCommandPool() {
 	poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();  // Use the graphics queue family.
 
 	// Create the command pool and check for errors.
-	if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS) {
+	if (vkCreateCommandPool(device, &poolInfo, allocator, &commandPool) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create command pool!");
 	}
 }
@@ -1327,8 +1438,9 @@ void VulkanRenderer::CreateCommandPool() {
  * @brief Creates the color attachment resources for multisampling.
  *
  * This method creates a color image and its associated memory to store the intermediate
- * multisampled rendering results. A corresponding image view is also created for use in
- * the rendering pipeline.
+ * multisampled rendering results. The image is only written and resolved inside the render pass,
+ * so it is created as a transient attachment backed by lazily allocated memory when available.
+ * A corresponding image view is also created for use in the rendering pipeline.
  *
  * @throws std::runtime_error if image or image view creation fails.
  */
@@ -1336,21 +1448,19 @@ void VulkanRenderer::CreateColorResources() {
 	// Use the swap chain image format for the color attachment.
 	VkFormat colorFormat = swapChainImageFormat;
 
-	// Create the color image with the specified dimensions, format, and usage.
-	createImage(
+	// Create the transient color image with the specified dimensions and format.
+	colorImageLazilyAllocated = createTransientAttachmentImage(
 		device,
 		physicalDevice,
 		swapChainExtent.width,                     // Image width (matches swap chain extent).
 		swapChainExtent.height,                    // Image height (matches swap chain extent).
-		1,                                         // Single mip level (no mipmapping for color attachments).
 		msaaSamples,                               // Multisampling count for anti-aliasing.
 		colorFormat,                               // Format of the color attachment (matches swap chain).
-		VK_IMAGE_TILING_OPTIMAL,                   // Optimal tiling for GPU operations.
-		VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |  // Used as a transient attachment.
 		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,       // Used as a color attachment.
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,       // Memory property for device-local storage.
 		colorImage,                                // Output parameter for the created image.
-		colorImageMemory                           // Output parameter for the allocated image memory.
+		colorImageMemory,                          // Output parameter for the allocated image memory.
+		colorImageAllocationSize,                  // Output parameter for the allocation size.
+		allocator                                  // Host allocation callbacks.
 	);
 
 	// Create an image view for the color image, allowing it to be used in the rendering pipeline.
@@ -1359,7 +1469,8 @@ void VulkanRenderer::CreateColorResources() {
 		colorImage,
 		colorFormat,
 		VK_IMAGE_ASPECT_COLOR_BIT,  // Specify that this is a color image.
-		1                           // Single mip level.
+		1,                          // Single mip level.
+		allocator                   // Host allocation callbacks.
 	);
 }
 /**
@@ -1373,22 +1484,21 @@ void VulkanRenderer::CreateColorResources() {
  */
 void VulkanRenderer::CreateDepthResources() {
 	// Find a suitable format for the depth attachment (e.g., depth stencil format).
-	VkFormat depthFormat = FindDepthFormat();
+	depthFormat = FindDepthFormat();
 
-	// Create the depth image with the specified parameters.
-	createImage(
+	// Create the depth image as a transient attachment; depth is cleared on load and never stored.
+	depthImageLazilyAllocated = createTransientAttachmentImage(
 		device,
 		physicalDevice,
 		swapChainExtent.width,                        // Image width (matches swap chain extent).
 		swapChainExtent.height,                       // Image height (matches swap chain extent).
-		1,                                            // Single mip level (no mipmapping for depth attachments).
 		msaaSamples,                                  // Multisampling count for anti-aliasing.
 		depthFormat,                                  // Format of the depth attachment.
-		VK_IMAGE_TILING_OPTIMAL,                      // Optimal tiling for GPU operations.
 		VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,  // Depth-stencil usage.
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,          // Memory property for device-local storage.
 		depthImage,                                   // Output parameter for the created depth image.
-		depthImageMemory                              // Output parameter for the allocated image memory.
+		depthImageMemory,                             // Output parameter for the allocated image memory.
+		depthImageAllocationSize,                     // Output parameter for the allocation size.
+		allocator                                     // Host allocation callbacks.
 	);
 
 	// Create an image view for the depth attachment to make it accessible in the rendering pipeline.
@@ -1397,7 +1507,8 @@ void VulkanRenderer::CreateDepthResources() {
 		depthImage,
 		depthFormat,
 		VK_IMAGE_ASPECT_DEPTH_BIT,  // Specify that this is a depth image.
-		1                           // Single mip level.
+		1,                          // Single mip level.
+		allocator                   // Host allocation callbacks.
 	);
 
 	// Transition the depth image layout to make it suitable as a depth-stencil attachment.
@@ -1413,86 +1524,39 @@ void VulkanRenderer::CreateDepthResources() {
 	);
 }
 /**
- * @brief Creates uniform buffers for each frame in flight.
+ * @brief Returns how much device memory a transient attachment actually committed.
  *
- * Uniform buffers store data that is updated frequently and passed to shaders, such as transformation matrices.
- * This method creates one uniform buffer for each swap chain image and maps its memory for CPU-side updates.
+ * For lazily allocated memory, vkGetDeviceMemoryCommitment reports the bytes the driver has backed
+ * with physical pages; the remainder of the allocation is VRAM saved at the current resolution.
+ * The commitment can grow while rendering, so the overlay queries it every frame.
  *
- * @throws std::runtime_error if buffer creation or memory mapping fails.
+ * @param memory Memory bound to the attachment image.
+ * @param allocationSize Size of the allocation in bytes.
+ * @param lazilyAllocated Whether the memory comes from a LAZILY_ALLOCATED memory type.
  */
-void VulkanRenderer::CreateUniformBuffers() {
-	// Define the size of the uniform buffer (e.g., size of the UniformBufferObject structure).
-	VkDeviceSize bufferSize = sizeof(UniformBufferObject);
-
-	// Resize the vectors to store buffers, memory, and mapped memory for all frames.
-	uniformBuffers.resize(swapChainImages.size());
-	uniformBuffersMemory.resize(swapChainImages.size());
-	uniformBuffersMapped.resize(swapChainImages.size());
-
-	// Create a uniform buffer for each frame in the swap chain.
-	for (size_t frame = 0; frame < swapChainImages.size(); frame++) {
-		// Create a uniform buffer and allocate device memory for it.
-		createBuffer(
-			device,
-			physicalDevice,
-			bufferSize,                            // Size of the buffer.
-			VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,    // Usage as a uniform buffer.
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |  // Host-visible memory for CPU updates.
-			VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,  // Coherent memory for automatic synchronization.
-			uniformBuffers[frame],                 // Output buffer handle.
-			uniformBuffersMemory[frame]            // Output memory handle.
-		);
-
-		// Check for errors in buffer creation.
-		if (uniformBuffers[frame] == VK_NULL_HANDLE) {
-			throw std::runtime_error("Uniform buffer is VK_NULL_HANDLE!");
-		}
-
-		// Map the memory to a CPU-accessible pointer for updates.
-		vkMapMemory(
-			device,
-			uniformBuffersMemory[frame],  // Memory to map.
-			0,                            // Offset.
-			bufferSize,                   // Size of the memory region to map.
-			0,                            // Flags (reserved).
-			&uniformBuffersMapped[frame]  // Output pointer to the mapped memory.
-		);
+VkDeviceSize VulkanRenderer::GetCommittedMemory(VkDeviceMemory memory, VkDeviceSize allocationSize, bool lazilyAllocated) const {
+	VkDeviceSize committedSize = allocationSize;
+	if (lazilyAllocated) {
+		vkGetDeviceMemoryCommitment(device, memory, &committedSize);
 	}
+	return committedSize;
 }
 /**
- * @brief Creates a descriptor pool for allocating descriptor sets.
+ * @brief Creates the descriptor pool used by ImGui.
  *
- * The descriptor pool allows Vulkan to allocate descriptor sets, which are used to bind
- * resources like uniform buffers and image samplers to shaders. This method calculates
- * the required pool size based on the number of frames and models.
+ * The renderer's own sets come from growable per-frame DescriptorAllocators and the bindless texture
+ * pool, so this pool only needs room for the overlay.
  *
- * @throws std::runtime_error if the descriptor pool parameters are invalid or pool creation fails.
+ * @throws std::runtime_error if pool creation fails.
  */
 void VulkanRenderer::CreateDescriptorPool() {
-<<<<<<< HEAD
-	// Define the descriptor pool sizes
-	std::vector<VkDescriptorPoolSize> poolSizes = {
-		// Uniform buffers
-		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, static_cast<uint32_t>(swapChainImages.size() * modelList.size()) },
-
-		// Combined image samplers
-		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, static_cast<uint32_t>(swapChainImages.size() * modelList.size()) },
-
-		// Additional types for ImGui and other resources
-=======
-	// Use at least 1 as the model count to avoid 0 descriptors.
-	uint32_t modelCount = modelList.empty() ? 1 : static_cast<uint32_t>(modelList.size());
-	uint32_t imageCount = static_cast<uint32_t>(swapChainImages.size());
-
+	// Descriptors for IMGUI and other resources.
 	std::vector<VkDescriptorPoolSize> poolSizes = {
-		// Uniform buffers for each frame-model combination.
-		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, imageCount * modelCount },
-		// Combined image samplers for each frame-model combination.
-		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, imageCount * modelCount },
-		// Additional descriptors for IMGUI and other resources.
->>>>>>> Testing
+		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 100 },
 		{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 100 },
 		{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 100 },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 100 },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 100 },
 		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 100 },
 		{ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 100 }
 	};
@@ -1502,124 +1566,207 @@ void VulkanRenderer::CreateDescriptorPool() {
 	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
 	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
 	poolInfo.pPoolSizes = poolSizes.data();
-<<<<<<< HEAD
-	poolInfo.maxSets = static_cast<uint32_t>(swapChainImages.size() * modelList.size()) + 500; // Add extra capacity for ImGui and other resources
-=======
-	poolInfo.maxSets = imageCount * modelCount + 500;					// Add extra capacity for ImGui and other resources
->>>>>>> Testing
-	poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT; // Enable freeing individual sets
-
-	// Validate descriptor pool parameters.
-	if (poolInfo.maxSets == 0 || poolSizes[0].descriptorCount == 0 || poolSizes[1].descriptorCount == 0) {
-		throw std::runtime_error("Descriptor pool parameters are invalid!");
-	}
+	poolInfo.maxSets = 500;
+	poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT; // ImGui frees its sets individually
 
 	// Create the descriptor pool and check for errors.
-	if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS) {
+	if (vkCreateDescriptorPool(device, &poolInfo, allocator, &descriptorPool) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create descriptor pool!");
 	}
 }
 /**
- * @brief Creates and updates descriptor sets for uniform buffers and texture samplers.
+ * @brief Allocates and writes the per-frame descriptor sets for the frame ring buffer and visible-index buffers.
  *
- * This method allocates descriptor sets for each frame and model combination, then updates
- * the descriptor sets with the appropriate uniform buffer and texture sampler information.
+ * Each frame allocates its set from its own DescriptorAllocator, which adds pools on demand instead
+ * of being sized up front. Rebuilding resets each frame's allocator, recycling its pools rather than
+ * leaking the old sets, so this can be called again whenever the ring or culling buffers are reallocated.
+ * Textures are not part of these sets, so loading a texture never rebuilds them. All writes for all
+ * frames go out in a single vkUpdateDescriptorSets call. The caller must make sure the old sets are
+ * no longer in use by the GPU.
  *
- * @throws std::runtime_error if descriptor set allocation or updates fail.
+ * @throws std::runtime_error if descriptor set allocation fails.
  */
 void VulkanRenderer::CreateDescriptorSets() {
-	// Resize the descriptor sets vector to accommodate all frames and models.
-<<<<<<< HEAD
-	descriptorSets.resize(swapChainImages.size() * modelList.size());
-=======
-	uint32_t modelCount = modelList.empty() ? 1 : static_cast<uint32_t>(modelList.size());
-	descriptorSets.resize(swapChainImages.size() * modelCount);
->>>>>>> Testing
+	const size_t frameCount = MAX_FRAMES_IN_FLIGHT;
+	if (frameDescriptorAllocators.size() != frameCount) {
+		std::vector<DescriptorAllocator::PoolSizeRatio> ratios = {
+			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.0f },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1.0f }
+		};
+		frameDescriptorAllocators.clear();
+		for (size_t frame = 0; frame < frameCount; frame++) {
+			frameDescriptorAllocators.push_back(std::make_unique<DescriptorAllocator>(device, allocator, 1, ratios));
+		}
+	}
+
+	DescriptorWriter writer;
+	descriptorSets.resize(frameCount);
+	for (size_t currFrame = 0; currFrame < frameCount; currFrame++) {
+		// Recycle the frame's pools; the sets that referenced the previous buffers are released with them.
+		DescriptorAllocator& frameAllocator = *frameDescriptorAllocators[currFrame];
+		frameAllocator.Reset();
+		VkDescriptorSet descriptorSet = frameAllocator.Allocate(descriptorSetLayout);
+		descriptorSets[currFrame] = descriptorSet;
+
+		// Binding 0: Camera uniform block; the frame's offset into the ring is supplied at bind time.
+		writer.WriteBuffer(descriptorSet, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+			frameRing->GetBuffer(), 0, sizeof(UniformBufferObject));
+		// Binding 1: Instance slice, likewise offset at bind time.
+		writer.WriteBuffer(descriptorSet, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+			frameRing->GetBuffer(), 0, sizeof(InstanceData) * instanceCapacity);
+		// Binding 2: Visible-instance storage buffer.
+		writer.WriteBuffer(descriptorSet, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+			gpuCuller->GetVisibleInstanceBuffer(static_cast<uint32_t>(currFrame)), 0, VK_WHOLE_SIZE);
+	}
+	writer.Update(device);
+
+	// Cached scene draws bind the old sets (and usually the buffers that were just replaced).
+	sceneResourceVersion++;
+}
+/**
+ * @brief Creates the update-after-bind pool and allocates the global bindless texture set from it.
+ *
+ * The set lives for the renderer's lifetime and is shared by every frame. Its elements start out
+ * unwritten; WriteTextureDescriptor fills one per loaded texture.
+ *
+ * @throws std::runtime_error if pool creation or set allocation fails.
+ */
+void VulkanRenderer::CreateTextureDescriptorSet() {
+	VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, textureDescriptorCapacity };
 
-	// Create a list of descriptor set layouts for allocation.
-	std::vector<VkDescriptorSetLayout> layouts(descriptorSets.size(), descriptorSetLayout);
+	VkDescriptorPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT; // Required for update-after-bind layouts.
+	poolInfo.maxSets = 1;
+	poolInfo.poolSizeCount = 1;
+	poolInfo.pPoolSizes = &poolSize;
+
+	if (vkCreateDescriptorPool(device, &poolInfo, allocator, &textureDescriptorPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create texture descriptor pool!");
+	}
 
-	// Configure descriptor set allocation.
 	VkDescriptorSetAllocateInfo allocInfo{};
 	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-	allocInfo.descriptorPool = descriptorPool;                     // Use the descriptor pool created earlier.
-	allocInfo.descriptorSetCount = static_cast<uint32_t>(descriptorSets.size()); // Number of descriptor sets to allocate.
-	allocInfo.pSetLayouts = layouts.data();                        // Layouts for the descriptor sets.
+	allocInfo.descriptorPool = textureDescriptorPool;
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts = &textureDescriptorSetLayout;
 
-	// Allocate descriptor sets and check for errors.
-	if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data()) != VK_SUCCESS) {
-		throw std::runtime_error("Failed to allocate descriptor sets!");
+	if (vkAllocateDescriptorSets(device, &allocInfo, &textureDescriptorSet) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate texture descriptor set!");
+	}
+	textureDescriptorCount = 0;
+}
+/**
+ * @brief Gives a newly loaded texture the next element of the bindless texture array.
+ *
+ * Exactly one descriptor is written. The element is new, so frames still in flight never sample it
+ * and the set does not need to wait for the GPU or be rebuilt.
+ *
+ * @param texture Texture to write; its descriptor index is set to the element it was written to.
+ *
+ * @throws std::runtime_error if the texture array is full.
+ */
+void VulkanRenderer::WriteTextureDescriptor(Texture* texture) {
+	if (textureDescriptorCount >= textureDescriptorCapacity) {
+		throw std::runtime_error("Too many textures for the bindless texture array!");
 	}
 
-	// Update descriptor sets for each frame and model.
-	for (size_t currFrame = 0; currFrame < swapChainImages.size(); currFrame++) {
-		for (size_t currModel = 0; currModel < modelList.size(); currModel++) {
-			if (currModel >= modelList.size()) {
-				throw std::runtime_error("Model index out of bounds!");
-			}
+	DescriptorWriter writer;
+	writer.WriteImage(textureDescriptorSet, 0, textureDescriptorCount, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+		texture->GetImageView(), texture->GetSampler(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	writer.Update(device);
+	texture->SetDescriptorIndex(textureDescriptorCount++);
+}
+/**
+ * @brief Creates the frame ring buffer, replacing any existing one. The GPU must be idle.
+ *
+ * Each frame's region holds the camera uniform block followed by an InstanceData slice for every
+ * model drawn in that frame. The slices stay persistently mapped so UpdateUniformBuffer and
+ * UpdateInstanceBuffer can write them directly.
+ *
+ * @param capacity Number of instances each frame's slice can hold.
+ *
+ * @throws std::runtime_error if buffer creation fails.
+ */
+void VulkanRenderer::CreateFrameRingBuffer(uint32_t capacity) {
+	frameRing.reset();
+
+	// Leave room for the padding Allocate inserts to align the instance slice after the camera block.
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	VkDeviceSize alignmentSlack = std::max(properties.limits.minUniformBufferOffsetAlignment, properties.limits.minStorageBufferOffsetAlignment);
+	VkDeviceSize frameSize = sizeof(UniformBufferObject) + alignmentSlack + sizeof(InstanceData) * capacity;
+
+	frameRing = std::make_unique<FrameRingBuffer>(device, physicalDevice, allocator, MAX_FRAMES_IN_FLIGHT, frameSize);
+	instanceCapacity = capacity;
+	instanceDataVersions.assign(MAX_FRAMES_IN_FLIGHT, STALE_VERSION);
+}
+/**
+ * @brief Creates one host-visible indirect draw buffer per frame.
+ *
+ * Each buffer holds a DrawCommand per instance batch, written by UpdateIndirectBuffer,
+ * completed by the GPU culling pass and consumed by vkCmdDrawIndexedIndirect.
+ *
+ * @param capacity Number of draw commands each buffer can hold.
+ *
+ * @throws std::runtime_error if buffer creation fails.
+ */
+void VulkanRenderer::CreateIndirectBuffers(uint32_t capacity) {
+	VkDeviceSize bufferSize = sizeof(DrawCommand) * capacity;
 
-			// Access the current model.
-			Model* model = modelList[currModel].get();
-
-			// Calculate the descriptor index for the current frame and model.
-			size_t descriptorIndex = currFrame * modelList.size() + currModel;
-			VkDescriptorSet& descriptorSet = descriptorSets[descriptorIndex];
-
-			// Configure the uniform buffer descriptor.
-			VkDescriptorBufferInfo bufferInfo{};
-			bufferInfo.buffer = uniformBuffers[currFrame]; // Use the frame-specific uniform buffer.
-			bufferInfo.offset = 0;
-			bufferInfo.range = sizeof(UniformBufferObject); // Size of the UBO structure.
-
-			// Configure the texture sampler descriptor for the model.
-			VkDescriptorImageInfo imageInfo{};
-			imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			imageInfo.imageView = model->GetTextureImageView(); // Model-specific image view.
-			imageInfo.sampler = model->GetTextureSampler();     // Model-specific sampler.
-
-			// Write descriptors for the uniform buffer and texture sampler.
-			std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
-
-			// Binding 0: Uniform buffer.
-			descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[0].dstSet = descriptorSet;                   // Descriptor set to update.
-			descriptorWrites[0].dstBinding = 0;                          // Matches UBO binding in the shader.
-			descriptorWrites[0].dstArrayElement = 0;                     // Array index (0 for single descriptor).
-			descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; // Descriptor type.
-			descriptorWrites[0].descriptorCount = 1;                     // Number of descriptors.
-			descriptorWrites[0].pBufferInfo = &bufferInfo;               // Uniform buffer info.
-
-			// Binding 1: Texture sampler.
-			descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[1].dstSet = descriptorSet;   // Descriptor set to update.
-			descriptorWrites[1].dstBinding = 1;           // Matches sampler binding in the shader.
-			descriptorWrites[1].dstArrayElement = 0;      // Array index (0 for single descriptor).
-			descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; // Descriptor type.
-			descriptorWrites[1].descriptorCount = 1;      // Number of descriptors.
-			descriptorWrites[1].pImageInfo = &imageInfo;  // Image sampler info.
-
-			// Update the descriptor sets.
-			vkUpdateDescriptorSets(
-				device,
-				static_cast<uint32_t>(descriptorWrites.size()),  // Number of descriptors to update.
-				descriptorWrites.data(),                         // Descriptors to update.
-				0,
-				nullptr
-			);
+	indirectBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+	indirectBuffersMemory.resize(MAX_FRAMES_IN_FLIGHT);
+	indirectBuffersMapped.resize(MAX_FRAMES_IN_FLIGHT);
+
+	for (size_t frame = 0; frame < indirectBuffers.size(); frame++) {
+		createBuffer(
+			device,
+			physicalDevice,
+			bufferSize,                            // Size of the buffer.
+			VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |  // Source of indirect draw parameters.
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,    // Instance counts are rewritten by the culling shader.
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |  // Host-visible memory for CPU updates.
+			VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,  // Coherent memory for automatic synchronization.
+			indirectBuffers[frame],                // Output buffer handle.
+			indirectBuffersMemory[frame],          // Output memory handle.
+			allocator                              // Host allocation callbacks.
+		);
+
+		vkMapMemory(device, indirectBuffersMemory[frame], 0, bufferSize, 0, &indirectBuffersMapped[frame]);
+	}
+
+	indirectCapacity = capacity;
+}
+/**
+ * @brief Destroys the per-frame indirect draw buffers. The GPU must be idle.
+ */
+void VulkanRenderer::DestroyIndirectBuffers() {
+	for (size_t frame = 0; frame < indirectBuffers.size(); frame++) {
+		if (indirectBuffers[frame] != VK_NULL_HANDLE) {
+			vkDestroyBuffer(device, indirectBuffers[frame], allocator);
+		}
+		if (indirectBuffersMemory[frame] != VK_NULL_HANDLE) {
+			vkUnmapMemory(device, indirectBuffersMemory[frame]);
+			vkFreeMemory(device, indirectBuffersMemory[frame], allocator);
 		}
 	}
+	indirectBuffers.clear();
+	indirectBuffersMemory.clear();
+	indirectBuffersMapped.clear();
+	indirectCapacity = 0;
 }
 /**
  * @brief Allocates command buffers for rendering.
  *
  * Command buffers are used to record rendering and compute commands that are submitted to a queue.
- * This method allocates one primary command buffer for each swap chain image to handle per-frame rendering.
+ * This method allocates one primary command buffer for each frame in flight.
  *
  * @throws std::runtime_error if command buffer allocation fails.
  */
 void VulkanRenderer::CreateCommandBuffers() {
-	// Resize the command buffer vector to match the number of swap chain images.
-	commandBuffers.resize(swapChainImages.size());
+	// One command buffer per frame in flight, independent of the swap chain image count.
+	commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
 
 	// Configure the command buffer allocation information.
 	VkCommandBufferAllocateInfo allocInfo{};
@@ -1648,9 +1795,9 @@ void VulkanRenderer::CreateCommandBuffers() {
  */
 void VulkanRenderer::CreateSyncObjects() {
 	// Resize vectors to store synchronization objects for each frame in flight.
-	imageAvailableSemaphores.resize(swapChainImages.size());  // Signals when an image is available for rendering.
-	renderFinishedSemaphores.resize(swapChainImages.size());  // Signals when rendering is finished.
-	inFlightFences.resize(swapChainImages.size());            // Ensures frames are not reused prematurely.
+	imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);  // Signals when an image is available for rendering.
+	renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);  // Signals when rendering is finished.
+	inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);            // Ensures frames are not reused prematurely.
 
 	// Configure semaphore creation information.
 	VkSemaphoreCreateInfo semaphoreInfo{};
@@ -1662,11 +1809,11 @@ void VulkanRenderer::CreateSyncObjects() {
 	fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;         // Initialize fences in the signaled state.
 
 	// Create synchronization objects for each frame in flight.
-	for (size_t i = 0; i < swapChainImages.size(); i++) {
+	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
 		// Create semaphores and fences and check for errors.
-		if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &imageAvailableSemaphores[i]) != VK_SUCCESS ||
-			vkCreateSemaphore(device, &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]) != VK_SUCCESS ||
-			vkCreateFence(device, &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS) {
+		if (vkCreateSemaphore(device, &semaphoreInfo, allocator, &imageAvailableSemaphores[i]) != VK_SUCCESS ||
+			vkCreateSemaphore(device, &semaphoreInfo, allocator, &renderFinishedSemaphores[i]) != VK_SUCCESS ||
+			vkCreateFence(device, &fenceInfo, allocator, &inFlightFences[i]) != VK_SUCCESS) {
 			throw std::runtime_error("Failed to create synchronization objects for a frame!");
 		}
 	}
@@ -1678,7 +1825,7 @@ void VulkanRenderer::CreateSyncObjects() {
 <<<<<<< HEAD
 
 =======
-void VulkanRenderer::RenderImGui(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+void VulkanRenderer::RenderImGui(VkCommandBuffer commandBuffer) {
 	ImGui_ImplVulkan_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
 	ImGui::NewFrame();
@@ -1689,13 +1836,98 @@ void VulkanRenderer::RenderImGui(VkCommandBuffer commandBuffer, uint32_t imageIn
 	ImGui::Begin("Performance Metrics");
 	ImGui::Text("FPS: %.2f", fps);
 	ImGui::Text("Frame Time: %.3f ms", deltaTime * 1000.0f);
+	char hitchLabel[64];
+	std::snprintf(hitchLabel, sizeof(hitchLabel), "%u hitches (last %.1f ms)", hitchCount, lastHitchMs);
+	ImGui::PlotLines("##FrameTimes", frameTimeHistory.data(), static_cast<int>(frameTimeHistory.size()),
+		static_cast<int>(frameTimeHistoryIndex), hitchLabel, 0.0f, FLT_MAX, ImVec2(0.0f, 60.0f));
 	ImGui::Text("Elapsed Time: %.2f s", elapsedTime);
 	ImGui::Text("Frame Count: %llu", frameCount);
-	ImGui::Text("# of Models: %llu", modelList.size());
+	ImGui::Text("Startup: %.1f ms (pipeline cache %s)", startupTimeMs, pipelineCache->WasLoaded() ? "warm" : "cold");
+	ImGui::Text("# of Models: %u", scene.GetEntityCount());
+	ImGui::Text("Draw Calls: %zu", instanceBatches.size());
+	ImGui::Text("Frame Ring: %.1f / %.1f KiB", frameRing->GetUsedSize() / 1024.0, frameRing->GetFrameSize() / 1024.0);
+	const double toMiB = 1.0 / (1024.0 * 1024.0);
+	ImGui::Text("Transient Attachments: color %.1f / %.1f MiB, depth %.1f / %.1f MiB committed%s",
+		GetCommittedMemory(colorImageMemory, colorImageAllocationSize, colorImageLazilyAllocated) * toMiB, colorImageAllocationSize * toMiB,
+		GetCommittedMemory(depthImageMemory, depthImageAllocationSize, depthImageLazilyAllocated) * toMiB, depthImageAllocationSize * toMiB,
+		colorImageLazilyAllocated && depthImageLazilyAllocated ? "" : " (no lazily allocated memory type)");
+	const RenderGraph::Stats& graphStats = renderGraphs[currentFrame]->GetStats();
+	ImGui::Text("Render Graph: %u passes (%u culled), %u barriers, %u layout transitions",
+		graphStats.passes - graphStats.culledPasses, graphStats.culledPasses, graphStats.barrierBatches, graphStats.imageBarriers);
+	const PipelineStateCache::Stats& pipelineStats = pipelineStates->GetStats();
+	ImGui::Text("Pipelines: %u variants, %llu lookups, %.1f ms compiling%s", pipelineStats.pipelines,
+		static_cast<unsigned long long>(pipelineStats.lookups), pipelineStats.compileMs, dynamicPolygonModeSupported ? "" : " (static polygon mode)");
+	ImGui::Text("Pipeline Compiles: %u pending, %llu fallback draws, longest %.1f ms", pipelineStats.pending,
+		static_cast<unsigned long long>(pipelineStats.fallbacks), pipelineStats.longestCompileMs);
+	const ShaderCompiler::Stats& shaderStats = shaderCompiler->GetStats();
+	ImGui::Text("Shaders: %u compiled (%.1f ms), %u cached, %u bundled, %u reloads (%s)", shaderStats.compiles, shaderStats.compileMs,
+		shaderStats.cacheHits, shaderStats.bundleHits, shaderReloads, shaderWatcher->UsesNotifications() ? "inotify" : "polling");
+	const LayoutCache::Stats& layoutStats = layoutCache->GetStats();
+	ImGui::Text("Layouts: %u set, %u pipeline, %llu reused", layoutStats.setLayouts, layoutStats.pipelineLayouts,
+		static_cast<unsigned long long>(layoutStats.hits));
+	ImGui::Checkbox("Vertex Color", &sceneShaderFeatures.vertexColor);
+	ImGui::Checkbox("Alpha Test", &sceneShaderFeatures.alphaTest);
+	ImGui::Checkbox("Depth Pre-Pass", &depthPrepassEnabled);
+	if (depthPrepassEnabled && depthPrepassPipeline == VK_NULL_HANDLE) {
+		ImGui::SameLine();
+		ImGui::TextDisabled(sceneShaderFeatures.alphaTest || currentPolygonMode != VK_POLYGON_MODE_FILL ? "(off for alpha test and wireframe)" : "(compiling)");
+	}
+	// Each configuration keeps its last average, so toggling the pre-pass compares the two side by side.
+	if (!gpuTimer->IsSupported()) {
+		ImGui::Text("GPU Timings: no timestamp support on the graphics queue");
+	}
+	if (gpuTimings[0].samples > 0) {
+		ImGui::Text("GPU Single Pass: scene %.3f ms, frame %.3f ms", gpuTimings[0].sceneMs, gpuTimings[0].frameMs);
+	}
+	if (gpuTimings[1].samples > 0) {
+		ImGui::Text("GPU Depth Pre-Pass: scene %.3f ms (depth %.3f ms), frame %.3f ms",
+			gpuTimings[1].sceneMs, gpuTimings[1].prepassMs, gpuTimings[1].frameMs);
+	}
+	// A separate overlay render pass would load and store the whole 32-bit swap chain image once more.
+	const double overlayBytesSaved = 2.0 * 4.0 * swapChainExtent.width * swapChainExtent.height;
+	if (useDynamicRendering) {
+		ImGui::Text("Backend: dynamic rendering (overlay reloads %.1f MiB/frame)", overlayBytesSaved / (1024.0 * 1024.0));
+	}
+	else {
+		ImGui::Text("Backend: render pass");
+		ImGui::Text("Overlay Subpass: %.1f MiB/frame of attachment traffic saved", overlayBytesSaved / (1024.0 * 1024.0));
+	}
+	ImGui::Text("Binds Avoided: pipeline %u, material %u, mesh %u",
+		bindStats.draws - bindStats.pipelineChanges, bindStats.draws - bindStats.materialChanges, bindStats.draws - bindStats.meshChanges);
+	ImGui::Text("Scene Record Time: %.3f ms%s", sceneRecordTimeMs, sceneCommandsReused ? " (cached)" : "");
+	ImGui::BeginDisabled(!indirectDrawSupported || drawBenchmarkRunning);
+	ImGui::Checkbox(multiDrawIndirectSupported ? "Indirect Draw (multi-draw)" : "Indirect Draw", &useIndirectDraw);
+	if (ImGui::Button("Run Draw Benchmark")) {
+		drawBenchmarkRunning = true;
+		drawBenchmarkStep = 0;
+		drawBenchmarkFrame = 0;
+		drawBenchmarkDirectMs = 0.0;
+		drawBenchmarkIndirectMs = 0.0;
+	}
+	ImGui::EndDisabled();
+	ImGui::BeginDisabled(drawBenchmarkRunning || recordBenchmarkRunning);
+	ImGui::Checkbox("Instancing", &instancingEnabled);
+	ImGui::Checkbox("Depth Sort", &depthSortEnabled);
+	ImGui::Checkbox("Cache Scene Commands", &sceneCommandCacheEnabled);
+	int threads = static_cast<int>(recordingThreadCount);
+	if (ImGui::SliderInt("Recording Threads", &threads, 1, static_cast<int>(commandRecorder->GetMaxRanges()))) {
+		recordingThreadCount = static_cast<uint32_t>(threads);
+	}
+	if (ImGui::Button("Run Recording Benchmark")) {
+		recordBenchmarkRunning = true;
+		recordBenchmarkThreads = 1;
+		recordBenchmarkFrame = 0;
+		recordBenchmarkMs = 0.0;
+	}
+	ImGui::EndDisabled();
 	// --- New Add Model Button ---
+	// Spawns are deferred to the next frame since this command buffer is mid-recording.
 	if (ImGui::Button("Add Model")) {
-		// Here we use default paths; you could also allow the user to input a path.
-		AddModel(MODEL_PATH, TEXTURE_PATH);
+		RequestModelSpawn(1);
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Add 1000 Models")) {
+		RequestModelSpawn(1000);
 	}
 	if (ImGui::Button("Quit")) {
 		glfwSetWindowShouldClose(window, GLFW_TRUE);
@@ -1704,9 +1936,9 @@ void VulkanRenderer::RenderImGui(VkCommandBuffer commandBuffer, uint32_t imageIn
 
 	// === Models Debug Info Panel ===
 	ImGui::Begin("Models Debug Info");
-	for (size_t i = 0; i < modelList.size(); ++i) {
-		const auto& model = modelList[i];
-		glm::mat4 modelMatrix = model->GetModelMatrix();
+	const size_t debugModelCount = std::min<size_t>(scene.GetEntityCount(), 16);  // Listing thousands of matrices stalls the UI.
+	for (size_t i = 0; i < debugModelCount; ++i) {
+		const glm::mat4& modelMatrix = scene.GetWorldMatrices()[i];
 
 		ImGui::Text("Model %zu Matrix:", i + 1);
 		for (int row = 0; row < 4; ++row) {
@@ -1717,26 +1949,53 @@ void VulkanRenderer::RenderImGui(VkCommandBuffer commandBuffer, uint32_t imageIn
 		ImGui::Separator();
 	}
 	ImGui::End();
-	ImGui::Render();  // Ensures ImGui prepares its draw data
 
+	// === GPU Culling Panel ===
+	ImGui::Begin("GPU Culling");
+	ImGui::BeginDisabled(!useIndirectDraw);
+	ImGui::Checkbox("Frustum Culling", &gpuCullingEnabled);
+	ImGui::EndDisabled();
+	ImGui::Text("Draw Count: %s", drawIndirectCountSupported ? "GPU (DrawIndexedIndirectCount)" : "CPU (fallback)");
+	ImGui::Text("Visible Objects: %u / %u", cullStats.visibleObjects, scene.GetEntityCount());
+	ImGui::Text("Culled Objects: %u", scene.GetEntityCount() - std::min(cullStats.visibleObjects, scene.GetEntityCount()));
+	ImGui::Text("Visible Draws: %u / %zu", cullStats.visibleDraws, instanceBatches.size());
+	ImGui::End();
 
-	// Create RenderPass for GUI 
-	VkRenderPassBeginInfo imguiRenderPassInfo{};
-	imguiRenderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-	imguiRenderPassInfo.renderPass = imguiRenderPass;
-	imguiRenderPassInfo.framebuffer = imguiFramebuffers[imageIndex];
-	imguiRenderPassInfo.renderArea.offset = { 0, 0 };
-	imguiRenderPassInfo.renderArea.extent = swapChainExtent;
-
-	VkClearValue clearValue = { 0.0f, 0.0f, 0.0f, 0.0f };
-	imguiRenderPassInfo.clearValueCount = 1;
-	imguiRenderPassInfo.pClearValues = &clearValue;
+	// === CPU Culling Panel ===
+	ImGui::Begin("CPU Culling");
+	ImGui::Checkbox("Frustum Culling (SIMD)", &cpuCullingEnabled);
+	ImGui::Text("Path: %s", FrustumCuller::GetPathName(FrustumCuller::GetBestPath()));
+	ImGui::Text("Visible Objects: %zu / %u", visibleModels.size(), scene.GetEntityCount());
+	ImGui::Text("Cull Time: %.3f ms", cpuCullTimeMs);
+	ImGui::End();
 
-	vkCmdBeginRenderPass(commandBuffer, &imguiRenderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+	// === Host Allocator Panel ===
+	if (enableHostAllocator) {
+		ImGui::Begin("Host Allocator");
+		for (uint32_t scope = 0; scope < HostAllocator::SCOPE_COUNT; scope++) {
+			HostAllocator::ScopeStats stats = hostAllocator.GetScopeStats(static_cast<VkSystemAllocationScope>(scope));
+			ImGui::Text("%-8s %8.1f KB (peak %8.1f KB)  live %llu",
+				HostAllocator::GetScopeName(static_cast<VkSystemAllocationScope>(scope)),
+				stats.currentBytes / 1024.0, stats.peakBytes / 1024.0,
+				static_cast<unsigned long long>(stats.liveAllocations));
+		}
+		ImGui::Separator();
+		HostAllocator::ScopeStats totalStats = hostAllocator.GetTotalStats();
+		HostAllocator::PoolStats poolStats = hostAllocator.GetPoolStats();
+		ImGui::Text("Total: %.1f KB (peak %.1f KB), %llu allocations",
+			totalStats.currentBytes / 1024.0, totalStats.peakBytes / 1024.0,
+			static_cast<unsigned long long>(totalStats.totalAllocations));
+		ImGui::Text("Pools: %.1f / %.1f KB in %llu chunks",
+			poolStats.usedBytes / 1024.0, poolStats.reservedBytes / 1024.0,
+			static_cast<unsigned long long>(poolStats.chunkCount));
+		ImGui::Text("Large: %.1f KB  Driver-internal: %.1f KB",
+			poolStats.largeBytes / 1024.0, hostAllocator.GetInternalBytes() / 1024.0);
+		ImGui::End();
+	}
+	ImGui::Render();  // Ensures ImGui prepares its draw data
 
+	// Draw into the overlay subpass the caller has already moved to.
 	ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
-
-	vkCmdEndRenderPass(commandBuffer);
 }
 >>>>>>> Testing
 /**
@@ -1744,7 +2003,7 @@ void VulkanRenderer::RenderImGui(VkCommandBuffer commandBuffer, uint32_t imageIn
  *
  * This method initializes, configures, and loads 3D models into the Vulkan rendering pipeline.
  * Models are scaled, rotated, and positioned in the scene, and their geometry and textures are
- * loaded from files. Finally, the models are added to the `modelList`.
+ * loaded from files. Finally, the models are added to the `scene`.
  *
  * @throws std::runtime_error if loading model data or textures fails.
  */
@@ -1759,17 +2018,23 @@ void VulkanRenderer::LoadModels() {
 	model1 = std::make_unique<Model>(device, physicalDevice, graphicsQueue, commandPool);
 =======
 void VulkanRenderer::LoadDefualtModels() {
-	// Create unique pointers for the models.
-	std::unique_ptr<Model> model0;
+	// Create the scene entities for the models.
+	Entity model0;
 
-	// Initialize models with device and rendering resources.
-	model0 = std::make_unique<Model>(device, physicalDevice, graphicsQueue, commandPool);
+	// Initialize models from the shared mesh and texture caches, loading them on first use.
+	try {
+		model0 = scene.CreateEntity(GetOrLoadMesh(MODEL_PATH).get(), GetOrLoadTexture(TEXTURE_PATH).get());
+	}
+	catch (const std::runtime_error& e) {
+		// Throw an error if loading fails, with details about the failure.
+		throw std::runtime_error(std::string("Failed to load model: ") + e.what());
+	}
 >>>>>>> Testing
 
 	// Model 1 defaults
-	model0->SetPosition(glm::vec3(0.50f, 0.00f, 0.00f));
-	model0->SetScale(glm::vec3(0.50f, 0.50f, 0.50f));
-	model0->SetRotation(glm::vec3(0.0f, 0.0f, 0.0f));
+	scene.SetPosition(model0, glm::vec3(0.50f, 0.00f, 0.00f));
+	scene.SetScale(model0, glm::vec3(0.50f, 0.50f, 0.50f));
+	scene.SetRotation(model0, glm::vec3(0.0f, 0.0f, 0.0f));
 
 <<<<<<< HEAD
 	// Model 2 defaults
@@ -1790,21 +2055,462 @@ void VulkanRenderer::LoadDefualtModels() {
 		// Add the models to the rendering model list.
 		modelList.push_back(std::move(model0));
 		modelList.push_back(std::move(model1));
+	}
+	catch (const std::runtime_error& e) {
+		// Throw an error if loading fails, with details about the failure.
+		throw std::runtime_error(std::string("Failed to load model: ") + e.what());
+	}
 =======
+>>>>>>> Testing
+}
+/**
+ * @brief Returns the cached mesh for a file, loading it on first use.
+ *
+ * @param modelPath Path to the mesh file.
+ * @return Shared mesh that every model using this file references.
+ *
+ * @throws std::runtime_error if the mesh cannot be loaded.
+ */
+std::shared_ptr<Mesh> VulkanRenderer::GetOrLoadMesh(const std::string& modelPath) {
+	auto it = meshCache.find(modelPath);
+	if (it != meshCache.end()) {
+		return it->second;
+	}
+
+	auto mesh = std::make_shared<Mesh>(*geometryBuffer);
+	mesh->LoadFromFile(modelPath.c_str());
+	mesh->SetSortIndex(static_cast<uint32_t>(meshCache.size()));
+	meshCache.emplace(modelPath, mesh);
+	// The geometry buffer may have been reallocated, which invalidates the cached scene draws that bind it.
+	sceneResourceVersion++;
+	return mesh;
+}
+/**
+ * @brief Returns the cached texture for a file, loading it on first use.
+ *
+ * @param texturePath Path to the texture file.
+ * @return Shared texture that every model using this file references.
+ *
+ * @throws std::runtime_error if the texture cannot be loaded or the bindless texture array is full.
+ */
+std::shared_ptr<Texture> VulkanRenderer::GetOrLoadTexture(const std::string& texturePath) {
+	auto it = textureCache.find(texturePath);
+	if (it != textureCache.end()) {
+		return it->second;
+	}
+
+	auto texture = std::make_shared<Texture>(device, physicalDevice, graphicsQueue, commandPool, allocator);
+	texture->LoadFromFile(texturePath.c_str());
+	WriteTextureDescriptor(texture.get());
+	textureCache.emplace(texturePath, texture);
+	return texture;
+}
+/**
+ * @brief Adds the models queued by RequestModelSpawn, laying them out on a grid.
+ */
+void VulkanRenderer::ProcessPendingModels() {
+	for (uint32_t i = 0; i < pendingModelSpawns; i++) {
+		size_t n = scene.GetEntityCount();
+		glm::vec3 gridPosition(
+			static_cast<float>(n % 100) * 1.5f,
+			0.0f,
+			-static_cast<float>(n / 100) * 1.5f
+		);
+		AddModel(MODEL_PATH, TEXTURE_PATH, gridPosition);
+	}
+	pendingModelSpawns = 0;
+}
+/**
+ * @brief Fills visibleModels with the models to draw this frame.
+ *
+ * Brings world matrices and bounds up to date first. With CPU culling on, the bounds are
+ * tested against the camera frustum with FrustumCuller's SIMD path; otherwise every model is listed.
+ */
+void VulkanRenderer::CullModels() {
+	scene.UpdateTransforms(&threadPool);
+
+	if (!cpuCullingEnabled) {
+		// The list is always 0 .. count - 1, so it only needs rewriting when the count changes.
+		if (visibleModels.size() != scene.GetEntityCount()) {
+			visibleModels.resize(scene.GetEntityCount());
+			std::iota(visibleModels.begin(), visibleModels.end(), 0u);
+		}
+		cpuCullTimeMs = 0.0f;
+		return;
+	}
+
+	auto cullStart = std::chrono::high_resolution_clock::now();
+	scene.GetBounds().Cull(Frustum::FromViewProjection(GetProjectionMatrix() * camera->GetViewMatrix()), visibleModels);
+	auto cullEnd = std::chrono::high_resolution_clock::now();
+	cpuCullTimeMs = std::chrono::duration<float, std::milli>(cullEnd - cullStart).count();
+}
+/**
+ * @brief Grows the frame ring buffer so each frame's instance slice fits every model.
+ *
+ * Waits for the GPU first, since the ring is shared by in-flight frames' descriptor sets. The new
+ * ring holds no data, so every frame's instances are rewritten afterwards.
+ */
+void VulkanRenderer::ReserveInstanceCapacity() {
+	if (scene.GetEntityCount() <= instanceCapacity) {
+		return;
+	}
+
+	uint32_t newCapacity = std::max(instanceCapacity * 2, scene.GetEntityCount());
+	vkDeviceWaitIdle(device);
+	CreateFrameRingBuffer(newCapacity);
+	gpuCuller->Resize(instanceCapacity, indirectCapacity);
+	CreateDescriptorSets();
+	batchedSceneVersion = STALE_VERSION;
+}
+/**
+ * @brief Sorts the visible models into draws and writes their model matrices and texture indices into the frame's instance slice.
+ *
+ * Every visible model is queued in the render queue under a key of its pipeline, material, mesh and
+ * view depth, and the radix-sorted queue is cut into batches wherever the mesh changes, so each batch
+ * is one instanced draw. With depth sorting its instances run front to back, an order the GPU
+ * culling pass preserves. Textures are selected per instance from
+ * the bindless array and do not split batches. Must run after ReserveInstanceCapacity and the frame's
+ * camera allocation. Models rejected by CPU culling get no instance at all.
+ *
+ * Without CPU culling the result depends only on the scene and, when depth sorting, the camera, so the
+ * batches are kept until either changes and a frame's buffers are only rewritten if they hold an older
+ * scene version.
+ *
+ * @param frame Index of the frame whose instance slice is written. Its fence must already be signaled.
+ */
+void VulkanRenderer::UpdateInstanceBuffer(uint32_t frame) {
+	// The slice always spans the full capacity, which keeps its offset the same from frame to frame
+	// and matches the range the descriptor was written with.
+	FrameRingBuffer::Allocation allocation = frameRing->Allocate(sizeof(InstanceData) * instanceCapacity);
+	frameInstances = static_cast<InstanceData*>(allocation.data);
+	frameDynamicOffsets[1] = static_cast<uint32_t>(allocation.offset);
+
+	CullModels();
+
+	// CPU culling depends on the camera, so its batches are rebuilt every frame.
+	const uint64_t sceneVersion = scene.GetVersion();
+	const glm::mat4 view = camera->GetViewMatrix();
+	if (!cpuCullingEnabled && sceneVersion == batchedSceneVersion && instancingEnabled == batchedWithInstancing
+		&& depthSortEnabled == batchedWithDepthSort && (!depthSortEnabled || view == batchedViewMatrix)) {
+		if (instanceDataVersions[frame] != sceneVersion) {
+			ScatterInstances(frame);
+		}
+		return;
+	}
+	batchedSceneVersion = cpuCullingEnabled ? STALE_VERSION : sceneVersion;
+	batchedWithInstancing = instancingEnabled;
+	batchedWithDepthSort = depthSortEnabled;
+	batchedViewMatrix = view;
+	std::fill(instanceDataVersions.begin(), instanceDataVersions.end(), STALE_VERSION);
+
+	// Queue every visible model under its sort key. There is a single opaque pass and pipeline, and
+	// textures come from the bindless array, so only the mesh and depth fields differ for now.
+	const std::vector<Mesh*>& meshes = scene.GetMeshes();
+	const std::vector<glm::mat4>& worldMatrices = scene.GetWorldMatrices();
+	renderQueue.Clear();
+	renderQueue.Reserve(visibleModels.size());
+	// The camera looks down -z in view space. The key's depth field spans [0, 1], so depths are
+	// spread over the range the visible models actually cover rather than clamped at a fixed distance.
+	auto viewDepth = [&view](const glm::mat4& world) {
+		return -(view[0][2] * world[3].x + view[1][2] * world[3].y + view[2][2] * world[3].z + view[3][2]);
+	};
+	float nearestDepth = 0.0f;
+	float depthScale = 0.0f;
+	if (depthSortEnabled && !visibleModels.empty()) {
+		float farthestDepth = -FLT_MAX;
+		nearestDepth = FLT_MAX;
+		for (uint32_t model : visibleModels) {
+			float depth = viewDepth(worldMatrices[model]);
+			nearestDepth = std::min(nearestDepth, depth);
+			farthestDepth = std::max(farthestDepth, depth);
+		}
+		depthScale = farthestDepth > nearestDepth ? 1.0f / (farthestDepth - nearestDepth) : 0.0f;
+	}
+	for (uint32_t model : visibleModels) {
+		float depth = depthScale > 0.0f ? (viewDepth(worldMatrices[model]) - nearestDepth) * depthScale : 0.0f;
+		renderQueue.Push(RenderQueue::MakeKey(0, 0, 0, meshes[model]->GetSortIndex(), depth), model);
+	}
+	renderQueue.Sort();
+
+	// Cut the sorted queue into batches wherever the mesh changes. Without instancing every model
+	// starts a batch of its own.
+	const std::vector<RenderQueue::Item>& items = renderQueue.GetItems();
+	instanceBatches.clear();
+	modelBatchIndices.resize(items.size());
+	bindStats = {};
+	uint64_t previousKey = 0;
+	for (uint32_t slot = 0; slot < items.size(); slot++) {
+		Mesh* mesh = meshes[items[slot].index];
+		if (!instancingEnabled || instanceBatches.empty() || instanceBatches.back().mesh != mesh) {
+			uint64_t key = items[slot].key;
+			bool first = instanceBatches.empty();
+			bindStats.pipelineChanges += first || RenderQueue::GetPipeline(key) != RenderQueue::GetPipeline(previousKey);
+			bindStats.materialChanges += first || RenderQueue::GetMaterial(key) != RenderQueue::GetMaterial(previousKey);
+			bindStats.meshChanges += first || instanceBatches.back().mesh != mesh;
+			previousKey = key;
+
+			instanceBatches.push_back({ mesh, slot, 0 });
+		}
+		instanceBatches.back().instanceCount++;
+		modelBatchIndices[slot] = static_cast<uint32_t>(instanceBatches.size() - 1);
+	}
+	bindStats.draws = static_cast<uint32_t>(instanceBatches.size());
+
+	// Grow the indirect buffers now, since resizing the culler discards the culling bounds written below.
+	if (instanceBatches.size() > indirectCapacity) {
+		uint32_t newCapacity = std::max(indirectCapacity * 2, static_cast<uint32_t>(instanceBatches.size()));
+		vkDeviceWaitIdle(device);
+		DestroyIndirectBuffers();
+		CreateIndirectBuffers(newCapacity);
+		gpuCuller->Resize(instanceCapacity, indirectCapacity);
+		CreateDescriptorSets();
+	}
+
+	ScatterInstances(frame);
+}
+/**
+ * @brief Writes the sorted models into the frame's instance slice and culling inputs.
+ *
+ * Batches cover consecutive runs of the render queue, so instance slot i belongs to queue item i.
+ *
+ * @param frame Index of the frame whose buffers are written. Its fence must already be signaled.
+ */
+void VulkanRenderer::ScatterInstances(uint32_t frame) {
+	InstanceData* instances = frameInstances;
+	CullObject* cullObjects = gpuCuller->GetObjects(frame);
+	const std::vector<RenderQueue::Item>& items = renderQueue.GetItems();
+	const std::vector<glm::mat4>& worldMatrices = scene.GetWorldMatrices();
+	const std::vector<Mesh*>& meshes = scene.GetMeshes();
+	const std::vector<Texture*>& textures = scene.GetTextures();
+	for (uint32_t slot = 0; slot < items.size(); slot++) {
+		uint32_t model = items[slot].index;
+		instances[slot].model = worldMatrices[model];
+		instances[slot].textureIndex = textures[model]->GetDescriptorIndex();
+		cullObjects[slot].boundingSphere = meshes[model]->GetBoundingSphere();
+		cullObjects[slot].drawIndex = modelBatchIndices[slot];
+	}
+	instanceDataVersions[frame] = cpuCullingEnabled ? STALE_VERSION : scene.GetVersion();
+}
+/**
+ * @brief Writes one indirect draw command per instance batch into the frame's indirect buffer.
+ *
+ * Must run after UpdateInstanceBuffer so the batch list and instance offsets are current.
+ * Instance counts hold the batch sizes, which the GPU culling pass replaces with the visible counts.
+ * Every batch is drawn with the same pipeline and descriptor sets, so all of them form a single draw run.
+ *
+ * @param frame Index of the frame whose indirect buffer is written. Its fence must already be signaled.
+ */
+void VulkanRenderer::UpdateIndirectBuffer(uint32_t frame) {
+	// The fence has signaled, so the culling counters from this frame's previous use are final.
+	cullStats = gpuCuller->BeginFrame(frame);
+
+	// Textures come from the bindless array, so nothing between batches needs rebinding.
+	drawRuns.clear();
+	if (!instanceBatches.empty()) {
+		drawRuns.push_back({ 0, static_cast<uint32_t>(instanceBatches.size()) });
+	}
+
+	auto* commands = static_cast<DrawCommand*>(indirectBuffersMapped[frame]);
+	for (uint32_t runIndex = 0; runIndex < drawRuns.size(); runIndex++) {
+		const DrawRun& run = drawRuns[runIndex];
+		for (uint32_t i = run.firstDraw; i < run.firstDraw + run.drawCount; i++) {
+			const InstanceBatch& batch = instanceBatches[i];
+			commands[i].command = batch.mesh->GetDrawCommand(batch.instanceCount, batch.firstInstance);
+			commands[i].runIndex = runIndex;
+			commands[i].runFirstDraw = run.firstDraw;
+		}
+	}
+}
+/**
+ * @brief Advances the draw benchmark by one frame.
+ *
+ * For each object count in DRAW_BENCHMARK_COUNTS the scene is grown to that size, then scene
+ * recording time is averaged over DRAW_BENCHMARK_SAMPLE_FRAMES frames with direct draws and again
+ * with indirect draws, after DRAW_BENCHMARK_WARMUP_FRAMES frames of warm-up each. Results are
+ * written to stdout. Called at the start of DrawFrame, so sceneRecordTimeMs holds the previous frame.
+ */
+void VulkanRenderer::UpdateDrawBenchmark() {
+	if (!drawBenchmarkRunning) {
+		return;
+	}
+
+	const uint32_t phaseFrames = DRAW_BENCHMARK_WARMUP_FRAMES + DRAW_BENCHMARK_SAMPLE_FRAMES;
+
+	// Accumulate the frame that was just recorded, skipping warm-up frames.
+	if (drawBenchmarkFrame > 0) {
+		uint32_t previousFrame = drawBenchmarkFrame - 1;
+		if (previousFrame % phaseFrames >= DRAW_BENCHMARK_WARMUP_FRAMES) {
+			(previousFrame < phaseFrames ? drawBenchmarkDirectMs : drawBenchmarkIndirectMs) += sceneRecordTimeMs;
+		}
+	}
+
+	// Report the finished step and move on to the next object count.
+	if (drawBenchmarkFrame == 2 * phaseFrames) {
+		std::cout << std::setw(10) << scene.GetEntityCount()
+			<< std::setw(8) << instanceBatches.size()
+			<< std::setw(14) << std::fixed << std::setprecision(4) << drawBenchmarkDirectMs / DRAW_BENCHMARK_SAMPLE_FRAMES
+			<< std::setw(14) << drawBenchmarkIndirectMs / DRAW_BENCHMARK_SAMPLE_FRAMES << "\n";
+
+		drawBenchmarkStep++;
+		drawBenchmarkFrame = 0;
+		drawBenchmarkDirectMs = 0.0;
+		drawBenchmarkIndirectMs = 0.0;
+		if (drawBenchmarkStep == DRAW_BENCHMARK_COUNTS.size()) {
+			drawBenchmarkRunning = false;
+			useIndirectDraw = indirectDrawSupported;
+			std::cout << "Draw benchmark finished.\n";
+			return;
+		}
+	}
+
+	// Grow the scene at the start of each step; the spawns are processed later this frame.
+	if (drawBenchmarkFrame == 0) {
+		if (drawBenchmarkStep == 0) {
+			std::cout << "Draw benchmark (scene record time, ms per frame):\n"
+				<< std::setw(10) << "Objects" << std::setw(8) << "Draws"
+				<< std::setw(14) << "Direct" << std::setw(14) << "Indirect" << "\n";
+		}
+		uint32_t target = DRAW_BENCHMARK_COUNTS[drawBenchmarkStep];
+		if (scene.GetEntityCount() + pendingModelSpawns < target) {
+			RequestModelSpawn(target - scene.GetEntityCount() - pendingModelSpawns);
+		}
+	}
+
+	useIndirectDraw = drawBenchmarkFrame >= phaseFrames;
+	drawBenchmarkFrame++;
+}
+/**
+ * @brief Advances the recording thread scaling benchmark by one frame.
+ *
+ * The scene is grown to RECORD_BENCHMARK_OBJECT_COUNT models and drawn through the direct path with
+ * instancing off, so every model is a draw of its own. Scene recording time is then averaged over
+ * DRAW_BENCHMARK_SAMPLE_FRAMES frames for 1, 2, 4, ... recording threads up to the recorder's limit,
+ * after DRAW_BENCHMARK_WARMUP_FRAMES frames of warm-up each. Results are written to stdout.
+ * Called at the start of DrawFrame, so sceneRecordTimeMs holds the previous frame.
+ */
+void VulkanRenderer::UpdateRecordBenchmark() {
+	if (!recordBenchmarkRunning) {
+		return;
+	}
 
+	const uint32_t phaseFrames = DRAW_BENCHMARK_WARMUP_FRAMES + DRAW_BENCHMARK_SAMPLE_FRAMES;
+	const uint32_t maxThreads = commandRecorder->GetMaxRanges();
+
+	// Accumulate the frame that was just recorded, skipping warm-up frames.
+	if (recordBenchmarkFrame > DRAW_BENCHMARK_WARMUP_FRAMES) {
+		recordBenchmarkMs += sceneRecordTimeMs;
+	}
+
+	// Report the finished thread count and move on to the next one.
+	if (recordBenchmarkFrame == phaseFrames) {
+		double averageMs = recordBenchmarkMs / DRAW_BENCHMARK_SAMPLE_FRAMES;
+		if (recordBenchmarkThreads == 1) {
+			recordBenchmarkBaselineMs = averageMs;
+		}
+		std::cout << std::setw(10) << recordBenchmarkThreads
+			<< std::setw(8) << instanceBatches.size()
+			<< std::setw(14) << std::fixed << std::setprecision(4) << averageMs
+			<< std::setw(11) << std::setprecision(2) << recordBenchmarkBaselineMs / averageMs << "x\n";
+
+		recordBenchmarkFrame = 0;
+		recordBenchmarkMs = 0.0;
+		if (recordBenchmarkThreads == maxThreads) {
+			recordBenchmarkRunning = false;
+			instancingEnabled = true;
+			useIndirectDraw = indirectDrawSupported;
+			recordingThreadCount = maxThreads;
+			std::cout << "Recording benchmark finished.\n";
+			return;
+		}
+		recordBenchmarkThreads = std::min(recordBenchmarkThreads * 2, maxThreads);
+	}
+
+	// Grow the scene before the first step; the spawns are processed later this frame.
+	if (recordBenchmarkFrame == 0 && recordBenchmarkThreads == 1) {
+		std::cout << "Recording benchmark (scene record time, ms per frame):\n"
+			<< std::setw(10) << "Threads" << std::setw(8) << "Draws"
+			<< std::setw(14) << "Record" << std::setw(12) << "Speedup" << "\n";
+		if (scene.GetEntityCount() + pendingModelSpawns < RECORD_BENCHMARK_OBJECT_COUNT) {
+			RequestModelSpawn(RECORD_BENCHMARK_OBJECT_COUNT - scene.GetEntityCount() - pendingModelSpawns);
+		}
+	}
+
+	instancingEnabled = false;
+	useIndirectDraw = false;
+	recordingThreadCount = recordBenchmarkThreads;
+	recordBenchmarkFrame++;
+}
+/**
+ * @brief Applies edits to the scene shaders' sources by rebuilding the pipelines that use them.
+ *
+ * Called at the start of DrawFrame, between frames. Detecting a change is a non-blocking read, so
+ * frames without edits pay nothing else. With a change the GPU is drained, since the old pipelines
+ * may still be in use, and the fill variant is rebuilt at once; other variants go back to the
+ * compile threads. A shader that fails to compile, or breaks the fill variant, is reported and the
+ * old pipelines stay in use.
+ */
+void VulkanRenderer::ReloadChangedShaders() {
+	std::vector<std::string> changed = shaderWatcher->PollChanges();
+	if (changed.empty()) {
+		return;
+	}
+
+	vkDeviceWaitIdle(device);
+	// Report variants that failed before the edit on their own, so they do not abort the reload.
+	pipelineStates->WaitIdle();
 	try {
-		// Load geometry data for the models.
-		model0->LoadFromFile(MODEL_PATH.c_str());   // Load geometry for the second model.
-		model0->LoadTexture(TEXTURE_PATH.c_str());  // Load texture for the second model.
+		pipelineStates->PublishCompleted();
+	}
+	catch (const std::runtime_error& error) {
+		std::cerr << error.what() << "\n";
+	}
 
-		// Add the models to the rendering model list.
-		//modelList.push_back(std::move(model0));
->>>>>>> Testing
+	const PipelineDesc fallbackDesc = ScenePipelineDesc(VK_POLYGON_MODE_FILL);
+	std::vector<PipelineDesc> staleVariants;
+	for (const std::string& path : changed) {
+		try {
+			std::vector<PipelineDesc> removed = pipelineStates->ReloadShader(path, fallbackDesc);
+			fallbackPipeline = pipelineStates->Get(fallbackDesc);
+			graphicsPipeline = fallbackPipeline;
+			staleVariants.insert(staleVariants.end(), removed.begin(), removed.end());
+			shaderReloads++;
+			std::cout << "Reloaded " << path << " (" << removed.size() << " pipelines)\n";
+		}
+		catch (const std::runtime_error& error) {
+			std::cerr << error.what() << "\n";
+		}
 	}
-	catch (const std::runtime_error& e) {
-		// Throw an error if loading fails, with details about the failure.
-		throw std::runtime_error(std::string("Failed to load model: ") + e.what());
+	if (staleVariants.empty()) {
+		return;
+	}
+
+	for (const PipelineDesc& desc : staleVariants) {
+		pipelineStates->Prefetch(desc);
 	}
+	// A new pipeline can reuse a destroyed one's handle, so the cached scene draws cannot tell them apart.
+	sceneResourceVersion++;
+}
+/**
+ * @brief Folds the GPU timings of the current frame's previous use into gpuTimings.
+ *
+ * Whether that use drew the depth pre-pass shows in whether it wrote TIMESTAMP_PREPASS_END, so
+ * each configuration keeps its own average and stays on the overlay after switching to the other.
+ * Must be called right after GpuTimer::BeginFrame.
+ */
+void VulkanRenderer::UpdateGpuTimings() {
+	std::optional<double> sceneMs = gpuTimer->GetElapsedMs(currentFrame, TIMESTAMP_SCENE_BEGIN, TIMESTAMP_SCENE_END);
+	std::optional<double> frameMs = gpuTimer->GetElapsedMs(currentFrame, TIMESTAMP_FRAME_BEGIN, TIMESTAMP_FRAME_END);
+	if (!sceneMs || !frameMs) {
+		return;
+	}
+	std::optional<double> prepassMs = gpuTimer->GetElapsedMs(currentFrame, TIMESTAMP_SCENE_BEGIN, TIMESTAMP_PREPASS_END);
+
+	GpuTimings& timings = gpuTimings[prepassMs ? 1 : 0];
+	const float weight = timings.samples == 0 ? 1.0f : GPU_TIMING_SMOOTHING;
+	timings.prepassMs += weight * (static_cast<float>(prepassMs.value_or(0.0)) - timings.prepassMs);
+	timings.sceneMs += weight * (static_cast<float>(*sceneMs) - timings.sceneMs);
+	timings.frameMs += weight * (static_cast<float>(*frameMs) - timings.frameMs);
+	timings.samples++;
 }
 /**
  * @brief Updates the uniform buffer with per-frame transformation data.
@@ -1813,25 +2519,14 @@ void VulkanRenderer::LoadDefualtModels() {
  * The view matrix defines the camera's position and orientation, while the projection matrix handles
  * perspective projection.
  *
- * @param currentImage The index of the current frame's swap chain image.
+ * The block is the first allocation of the frame's ring buffer region, so it must be written after
+ * FrameRingBuffer::BeginFrame and before anything else is allocated.
  */
-void VulkanRenderer::UpdateUniformBuffer(uint32_t currentImage) {
-	float aspectRatio = swapChainExtent.width / static_cast<float>(swapChainExtent.height);
-
+void VulkanRenderer::UpdateUniformBuffer() {
 	// Create a uniform buffer object to hold the transformation data.
 	UniformBufferObject ubo{};
 	ubo.view = camera->GetViewMatrix();  // Get dynamic view matrix from the camera
-
-	// Generate the projection matrix using glm::perspective
-	ubo.proj = glm::perspective(
-		glm::radians(45.0f),  // Field of view (45 degrees)
-		aspectRatio,          // Aspect ratio from swap chain extent
-		0.1f,                 // Near clipping plane
-		10.0f                 // Far clipping plane
-	);
-
-	// Invert the Y-axis in the projection matrix to match Vulkan's coordinate system
-	ubo.proj[1][1] *= -1;
+	ubo.proj = GetProjectionMatrix();
 
 <<<<<<< HEAD
 	/*
@@ -1868,8 +2563,30 @@ void VulkanRenderer::UpdateUniformBuffer(uint32_t currentImage) {
 
 =======
 >>>>>>> Testing
-	// Copy the uniform buffer object data to the mapped memory for the current frame.
-	memcpy(uniformBuffersMapped[currentImage], &ubo, sizeof(ubo));
+	// Copy the uniform buffer object data into the frame's region of the ring buffer.
+	FrameRingBuffer::Allocation allocation = frameRing->Allocate(sizeof(ubo));
+	memcpy(allocation.data, &ubo, sizeof(ubo));
+	frameDynamicOffsets[0] = static_cast<uint32_t>(allocation.offset);
+}
+/**
+ * @brief Builds the camera projection matrix for the current swap chain extent.
+ *
+ * Shared by the uniform buffer and the GPU culling pass so both see the same frustum.
+ */
+glm::mat4 VulkanRenderer::GetProjectionMatrix() const {
+	float aspectRatio = swapChainExtent.width / static_cast<float>(swapChainExtent.height);
+
+	// Generate the projection matrix using glm::perspective
+	glm::mat4 proj = glm::perspective(
+		glm::radians(45.0f),  // Field of view (45 degrees)
+		aspectRatio,          // Aspect ratio from swap chain extent
+		NEAR_PLANE,           // Near clipping plane
+		FAR_PLANE             // Far clipping plane
+	);
+
+	// Invert the Y-axis in the projection matrix to match Vulkan's coordinate system
+	proj[1][1] *= -1;
+	return proj;
 }
 /**
  * @brief Records commands into a command buffer for rendering a frame.
@@ -1894,6 +2611,11 @@ void VulkanRenderer::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t
 		throw std::runtime_error("Failed to begin recording command buffer!");
 	}
 
+	// Collect the GPU timings of this frame's previous use before its queries are reset for this one.
+	gpuTimer->BeginFrame(commandBuffer, currentFrame);
+	UpdateGpuTimings();
+	gpuTimer->WriteTimestamp(commandBuffer, currentFrame, TIMESTAMP_FRAME_BEGIN, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+
 <<<<<<< HEAD
 	// Configure the render pass begin info.
 =======
@@ -1902,7 +2624,7 @@ void VulkanRenderer::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t
 	VkRenderPassBeginInfo renderPassInfo{};
 	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;  // Specify the structure type.
 	renderPassInfo.renderPass = renderPass;                           // Render pass to use.
-	renderPassInfo.framebuffer = swapChainFramebuffers[imageIndex];   // Framebuffer for the current swap chain image.
+	renderPassInfo.framebuffer = useDynamicRendering ? VK_NULL_HANDLE : swapChainFramebuffers[imageIndex]; // Framebuffer for the current swap chain image.
 	renderPassInfo.renderArea.offset = { 0, 0 };                      // Render from the top-left corner.
 	renderPassInfo.renderArea.extent = swapChainExtent;               // Render to the full extent of the swap chain image.
 
@@ -1932,13 +2654,117 @@ void VulkanRenderer::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t
 	renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
 	renderPassInfo.pClearValues = clearValues.data();
 
-	// RenderDoc Dubeg Tag for geomotry pass
-	float color[4] = { 0.0f, 1.0f, 0.0f, 1.0f }; // Green for geometry pass
-	BeginDebugMarker(device, commandBuffer, "Geometry Pass", color);
+	// With dynamic rendering the same attachments are named here instead: the multisampled color target
+	// resolves into the swap chain image, and depth is cleared and discarded.
+	VkRenderingAttachmentInfo sceneColorAttachment{};
+	sceneColorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+	sceneColorAttachment.imageView = colorImageView;
+	sceneColorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	sceneColorAttachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+	sceneColorAttachment.resolveImageView = swapChainImageViews[imageIndex];
+	sceneColorAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	sceneColorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	sceneColorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	sceneColorAttachment.clearValue = clearValues[0];
+
+	VkRenderingAttachmentInfo sceneDepthAttachment{};
+	sceneDepthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+	sceneDepthAttachment.imageView = depthImageView;
+	sceneDepthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	sceneDepthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	sceneDepthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	sceneDepthAttachment.clearValue = clearValues[1];
+
+	const bool depthHasStencil = HasStencilComponent(depthFormat);
+	VkRenderingInfo sceneRenderingInfo{};
+	sceneRenderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+	sceneRenderingInfo.renderArea = renderPassInfo.renderArea;
+	sceneRenderingInfo.layerCount = 1;
+	sceneRenderingInfo.colorAttachmentCount = 1;
+	sceneRenderingInfo.pColorAttachments = &sceneColorAttachment;
+	sceneRenderingInfo.pDepthAttachment = &sceneDepthAttachment;
+	sceneRenderingInfo.pStencilAttachment = depthHasStencil ? &sceneDepthAttachment : nullptr;
+
+	// Begins the scene with either backend, for draws recorded inline or in secondary command buffers.
+	auto beginScene = [&](VkCommandBuffer commandBuffer, bool secondaryContents) {
+		if (useDynamicRendering) {
+			sceneRenderingInfo.flags = secondaryContents ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0;
+			vkCmdBeginRendering(commandBuffer, &sceneRenderingInfo);
+		}
+		else {
+			vkCmdBeginRenderPass(commandBuffer, &renderPassInfo,
+				secondaryContents ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+		}
+	};
 
-	// Begin the render pass.
-	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-	// Bind the graphics pipeline.
+	// The frame is declared as a render graph: each pass states what it reads and writes, and the graph
+	// records the passes in order with the barriers between them. Exports are what the frame hands on.
+	RenderGraph& frameGraph = *renderGraphs[currentFrame];
+	frameGraph.Reset();
+	const RenderGraph::ResourceHandle instanceData = frameGraph.ImportBuffer("Instance Data", frameRing->GetBuffer());
+	const RenderGraph::ResourceHandle drawCommands = frameGraph.ImportBuffer("Draw Commands", indirectBuffers[currentFrame]);
+	const RenderGraph::ResourceHandle visibleInstances = frameGraph.ImportBuffer("Visible Instances", gpuCuller->GetVisibleInstanceBuffer(currentFrame));
+	const RenderGraph::ResourceHandle compactedDraws = frameGraph.ImportBuffer("Compacted Draws", gpuCuller->GetCompactedDrawBuffer(currentFrame));
+	const RenderGraph::ResourceHandle drawCounts = frameGraph.ImportBuffer("Draw Counts", gpuCuller->GetDrawCountBuffer(currentFrame));
+	// The render pass does its own layout transitions and orders its attachments against the acquire and the
+	// previous frame through its external dependencies. Dynamic rendering leaves both to the graph.
+	const RenderGraph::Access nothingPending{ 0 };
+	const RenderGraph::ResourceHandle backbuffer = frameGraph.ImportImage("Backbuffer", swapChainImages[imageIndex], VK_IMAGE_ASPECT_COLOR_BIT,
+		useDynamicRendering ? RenderGraph::Access{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0 } : nothingPending);
+	const RenderGraph::ResourceHandle colorTarget = frameGraph.ImportImage("MSAA Color", colorImage, VK_IMAGE_ASPECT_COLOR_BIT,
+		useDynamicRendering ? RenderGraph::Access{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT } : nothingPending);
+	const RenderGraph::ResourceHandle depthTarget = frameGraph.ImportImage("Depth", depthImage,
+		VK_IMAGE_ASPECT_DEPTH_BIT | (depthHasStencil ? VK_IMAGE_ASPECT_STENCIL_BIT : 0),
+		useDynamicRendering ? RenderGraph::Access{ VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT } : nothingPending);
+	// The culling counters are read back by the host once the frame's fence has signaled.
+	frameGraph.Export(drawCounts, { VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT });
+	frameGraph.Export(backbuffer, { VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR });
+
+	// Cull instances and build this frame's draws before the render pass begins.
+	// The direct path draws every instance, so culling only applies to indirect draws.
+	const RenderGraph::Access cullRead{ VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT };
+	const RenderGraph::Access cullWrite{ VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT };
+	frameGraph.AddPass("GPU Culling", [this, viewProjection = GetProjectionMatrix() * camera->GetViewMatrix()](VkCommandBuffer commandBuffer) {
+		gpuCuller->Record(
+			commandBuffer, currentFrame,
+			frameRing->GetBuffer(), frameDynamicOffsets[1], sizeof(InstanceData) * instanceCapacity, indirectBuffers[currentFrame],
+			static_cast<uint32_t>(visibleModels.size()), static_cast<uint32_t>(instanceBatches.size()), static_cast<uint32_t>(drawRuns.size()),
+			viewProjection,
+			gpuCullingEnabled && useIndirectDraw
+		);
+	})
+		.Read(instanceData, cullRead)
+		.Write(drawCommands, cullWrite)
+		.Write(visibleInstances, cullWrite)
+		.Write(compactedDraws, cullWrite)
+		.Write(drawCounts, cullWrite);
+
+	// Pipeline and dynamic state are bound before the render pass begins; the inline path draws with
+	// them, while secondary command buffers inherit no state and bind their own in RecordSceneState.
+	// Bind the graphics pipeline, looked up for this frame's polygon mode. A variant that is still
+	// compiling is drawn with the fallback; variants that finished since the last frame are published first.
+	// One that failed, typically after a broken shader edit, is reported and keeps drawing with the fallback.
+	try {
+		pipelineStates->PublishCompleted();
+	}
+	catch (const std::runtime_error& error) {
+		std::cerr << error.what() << "\n";
+	}
+	// The depth pre-pass is only drawn for opaque filled triangles: alpha-tested texels would leave
+	// depth behind where the color pass discards them, and wireframe has no fill to save. Until both
+	// of its pipelines are compiled the scene is drawn in a single pass.
+	depthPrepassPipeline = VK_NULL_HANDLE;
+	if (depthPrepassEnabled && currentPolygonMode == VK_POLYGON_MODE_FILL && !sceneShaderFeatures.alphaTest) {
+		VkPipeline prepassPipeline = pipelineStates->GetAsync(DepthPrepassPipelineDesc(), VK_NULL_HANDLE);
+		VkPipeline equalPipeline = pipelineStates->GetAsync(ScenePipelineDesc(currentPolygonMode, true), VK_NULL_HANDLE);
+		if (prepassPipeline != VK_NULL_HANDLE && equalPipeline != VK_NULL_HANDLE) {
+			depthPrepassPipeline = prepassPipeline;
+			graphicsPipeline = equalPipeline;
+		}
+	}
+	if (depthPrepassPipeline == VK_NULL_HANDLE) {
+		graphicsPipeline = pipelineStates->GetAsync(ScenePipelineDesc(currentPolygonMode), fallbackPipeline);
+	}
 	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
 	// Set the polygon mode dynamically
 	SetPolygonMode(commandBuffer, currentPolygonMode);
@@ -1978,15 +2804,13 @@ void VulkanRenderer::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t
 		size_t descriptorIndex = imageIndex * modelList.size() + modelIndex;
 
 =======
-	// Record draw commands for each model.
-	const size_t numModels = modelList.size();
-	for (size_t i = 0; i < numModels; i++) {
-		const auto& currModel = modelList[i].get();
-		// Bind the vertex and index buffers for the model.
-		currModel->Bind(commandBuffer);
+	// Every mesh lives in the shared geometry buffer, so it is bound once for the whole pass.
+	geometryBuffer->Bind(commandBuffer);
 
-		// Calculate the descriptor set index.
-		size_t descriptorIndex = imageIndex * modelList.size() + i;
+	// Bind the frame's buffers (set 0) and the global texture array (set 1) once for the whole pass.
+	// Instances carry their own texture index, so nothing is rebound between draws.
+	if (!drawRuns.empty()) {
+		size_t descriptorIndex = currentFrame;
 >>>>>>> Testing
 		// Validate the descriptor index.
 		if (descriptorIndex >= descriptorSets.size()) {
@@ -2007,16 +2831,17 @@ void VulkanRenderer::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t
 			0,
 			nullptr
 =======
-		// Bind the descriptor set.
+		// Bind the descriptor sets.
+		std::array<VkDescriptorSet, 2> boundSets = { descriptorSets[descriptorIndex], textureDescriptorSet };
 		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-			pipelineLayout, 0, 1, &descriptorSets[descriptorIndex],
-			0, nullptr
+			pipelineLayout, 0, static_cast<uint32_t>(boundSets.size()), boundSets.data(),
+			static_cast<uint32_t>(frameDynamicOffsets.size()), frameDynamicOffsets.data()
 >>>>>>> Testing
 		);
 
+<<<<<<< HEAD
 		// Push constants for the model matrix.
 		PushConstants pushConstants{};
-<<<<<<< HEAD
 		pushConstants.model = model->GetModelMatrix();
 		vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &pushConstants);
 
@@ -2078,19 +2903,156 @@ void VulkanRenderer::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t
 	vkCmdEndRenderPass(commandBuffer);
 
 =======
-		pushConstants.model = currModel->GetModelMatrix();
-		vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &pushConstants);
+	}
 
-		// Issue the draw command for the model.
-		currModel->Draw(commandBuffer);
+	// The main render pass draws the scene, resolves it into the backbuffer, draws the overlay on top
+	// and leaves the backbuffer ready to present. With dynamic rendering it only draws and resolves the
+	// scene; the overlay follows in a pass of its own.
+	RenderGraph::PassBuilder geometryPass = frameGraph.AddPass("Geometry", [&](VkCommandBuffer commandBuffer) {
+		// RenderDoc Dubeg Tag for geomotry pass
+		float color[4] = { 0.0f, 1.0f, 0.0f, 1.0f }; // Green for geometry pass
+		BeginDebugMarker(device, commandBuffer, "Geometry Pass", color);
+		gpuTimer->WriteTimestamp(commandBuffer, currentFrame, TIMESTAMP_SCENE_BEGIN, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+		auto sceneRecordStart = std::chrono::high_resolution_clock::now();
+
+		// Record the scene draws inline, or split them across the thread pool into secondary command
+		// buffers that continue the render pass and are executed in draw order. With the depth
+		// pre-pass every batch is drawn twice, so there are twice as many draws to split.
+		const uint32_t drawCount = static_cast<uint32_t>(instanceBatches.size()) * (depthPrepassPipeline != VK_NULL_HANDLE ? 2 : 1);
+		const uint32_t threadCount = std::min({ recordingThreadCount, commandRecorder->GetMaxRanges(),
+			(drawCount + MIN_DRAWS_PER_RECORDING_THREAD - 1) / MIN_DRAWS_PER_RECORDING_THREAD });
+		// The benchmarks time recording, so they never reuse cached draws.
+		const bool cacheSceneCommands = sceneCommandCacheEnabled && !drawBenchmarkRunning && !recordBenchmarkRunning;
+		sceneCommandsReused = false;
+		if (drawCount == 0 || (threadCount <= 1 && !cacheSceneCommands)) {
+			beginScene(commandBuffer, false);
+			RecordScenePasses(commandBuffer, 0, drawCount);
+		}
+		else {
+			beginScene(commandBuffer, true);
+
+			// Secondaries read the frame's own buffers and sets, so each frame in flight and polygon mode
+			// has its own slot. Transforms live in the instance buffer and the culling pass rewrites the
+			// indirect counts every frame, so the recorded draws stay valid until the batch list or a
+			// handle they bind changes.
+			const uint32_t recordSlot = currentFrame * POLYGON_MODE_COUNT + static_cast<uint32_t>(currentPolygonMode);
+			SceneCommandKey& cachedKey = sceneCommandKeys[recordSlot];
+			sceneCommandsReused = cacheSceneCommands && cachedKey.valid
+				&& cachedKey.resourceVersion == sceneResourceVersion && cachedKey.pipeline == graphicsPipeline
+				&& cachedKey.prepassPipeline == depthPrepassPipeline
+				&& cachedKey.indirect == useIndirectDraw
+				&& cachedKey.dynamicOffsets == frameDynamicOffsets
+				&& cachedKey.batches == instanceBatches && cachedKey.runs == drawRuns;
+
+			const std::vector<VkCommandBuffer>* secondaries = nullptr;
+			if (sceneCommandsReused) {
+				secondaries = &commandRecorder->GetRecorded(recordSlot);
+			}
+			else {
+				// Cached secondaries outlive the swap chain image they were recorded for, so they name no framebuffer.
+				VkCommandBufferInheritanceInfo inheritanceInfo{};
+				inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+				inheritanceInfo.renderPass = renderPass;
+				inheritanceInfo.subpass = 0;
+				inheritanceInfo.framebuffer = cacheSceneCommands || useDynamicRendering ? VK_NULL_HANDLE : swapChainFramebuffers[imageIndex];
+
+				// Under dynamic rendering secondaries inherit the attachment formats instead of a render pass.
+				VkCommandBufferInheritanceRenderingInfo inheritanceRenderingInfo{};
+				inheritanceRenderingInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+				inheritanceRenderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+				inheritanceRenderingInfo.colorAttachmentCount = 1;
+				inheritanceRenderingInfo.pColorAttachmentFormats = &swapChainImageFormat;
+				inheritanceRenderingInfo.depthAttachmentFormat = depthFormat;
+				inheritanceRenderingInfo.stencilAttachmentFormat = depthHasStencil ? depthFormat : VK_FORMAT_UNDEFINED;
+				inheritanceRenderingInfo.rasterizationSamples = msaaSamples;
+				if (useDynamicRendering) {
+					inheritanceInfo.pNext = &inheritanceRenderingInfo;
+				}
+
+				secondaries = &commandRecorder->Record(threadPool, recordSlot, threadCount, drawCount, inheritanceInfo,
+					[this](VkCommandBuffer secondary, uint32_t firstDraw, uint32_t endDraw) {
+						RecordSceneState(secondary);
+						RecordScenePasses(secondary, firstDraw, endDraw);
+					});
+
+				cachedKey.valid = cacheSceneCommands;
+				cachedKey.resourceVersion = sceneResourceVersion;
+				cachedKey.pipeline = graphicsPipeline;
+				cachedKey.prepassPipeline = depthPrepassPipeline;
+				cachedKey.indirect = useIndirectDraw;
+				cachedKey.dynamicOffsets = frameDynamicOffsets;
+				cachedKey.batches = instanceBatches;
+				cachedKey.runs = drawRuns;
+			}
+			vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(secondaries->size()), secondaries->data());
+		}
+
+		sceneRecordTimeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - sceneRecordStart).count();
+
+		EndDebugMarker(device, commandBuffer);
+
+		if (useDynamicRendering) {
+			vkCmdEndRendering(commandBuffer);
+			gpuTimer->WriteTimestamp(commandBuffer, currentFrame, TIMESTAMP_SCENE_END, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+			return;
+		}
+
+		// Render the IMGUI overlay in the second subpass, onto the resolved image.
+		vkCmdNextSubpass(commandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+		gpuTimer->WriteTimestamp(commandBuffer, currentFrame, TIMESTAMP_SCENE_END, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+		RenderImGui(commandBuffer);
+
+		// End the render pass.
+		vkCmdEndRenderPass(commandBuffer);
+	});
+	const RenderGraph::Access vertexRead{ VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT };
+	const RenderGraph::Access indirectRead{ VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT };
+	// Layouts are only declared for dynamic rendering; the render pass transitions its attachments itself.
+	const RenderGraph::Access colorWrite{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+		useDynamicRendering ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED };
+	const RenderGraph::Access depthWrite{ VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+		VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+		useDynamicRendering ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED };
+	geometryPass
+		.Read(instanceData, vertexRead)
+		.Read(visibleInstances, vertexRead)
+		.Write(colorTarget, colorWrite)
+		.Write(depthTarget, depthWrite)
+		.Write(backbuffer, colorWrite, useDynamicRendering ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+	if (useIndirectDraw && drawIndirectCountSupported) {
+		geometryPass.Read(compactedDraws, indirectRead).Read(drawCounts, indirectRead);
+	}
+	else if (useIndirectDraw) {
+		geometryPass.Read(drawCommands, indirectRead);
 	}
 
-	EndDebugMarker(device, commandBuffer);
-	// End the render pass.
-	vkCmdEndRenderPass(commandBuffer);
+	// Without a second subpass the overlay loads the resolved image and draws on top of it.
+	if (useDynamicRendering) {
+		frameGraph.AddPass("ImGui", [&](VkCommandBuffer commandBuffer) {
+			VkRenderingAttachmentInfo overlayAttachment{};
+			overlayAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+			overlayAttachment.imageView = swapChainImageViews[imageIndex];
+			overlayAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			overlayAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+			overlayAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+			VkRenderingInfo overlayRenderingInfo{};
+			overlayRenderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+			overlayRenderingInfo.renderArea = renderPassInfo.renderArea;
+			overlayRenderingInfo.layerCount = 1;
+			overlayRenderingInfo.colorAttachmentCount = 1;
+			overlayRenderingInfo.pColorAttachments = &overlayAttachment;
+
+			vkCmdBeginRendering(commandBuffer, &overlayRenderingInfo);
+			RenderImGui(commandBuffer);
+			vkCmdEndRendering(commandBuffer);
+		}).Write(backbuffer, { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+			VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL });
+	}
 
-	// Render the IMGUI overlay.
-	RenderImGui(commandBuffer, imageIndex);
+	frameGraph.Compile();
+	frameGraph.Execute(commandBuffer);
+	gpuTimer->WriteTimestamp(commandBuffer, currentFrame, TIMESTAMP_FRAME_END, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
 
 >>>>>>> Testing
 	// Finish recording commands into the command buffer.
@@ -2098,6 +3060,119 @@ void VulkanRenderer::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t
 		throw std::runtime_error("Failed to record command buffer!");
 	}
 }
+/**
+ * @brief Binds everything the scene draws need into a secondary command buffer.
+ *
+ * Secondaries inherit only the render pass, so each one binds the pipeline, dynamic state, geometry
+ * buffer and descriptor sets itself. Mirrors the state RecordCommandBuffer binds on the primary.
+ */
+void VulkanRenderer::RecordSceneState(VkCommandBuffer commandBuffer) {
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+	SetPolygonMode(commandBuffer, currentPolygonMode);
+
+	VkViewport viewport{};
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = static_cast<float>(swapChainExtent.width);
+	viewport.height = static_cast<float>(swapChainExtent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+	VkRect2D scissor{};
+	scissor.offset = { 0, 0 };
+	scissor.extent = swapChainExtent;
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+	geometryBuffer->Bind(commandBuffer);
+
+	std::array<VkDescriptorSet, 2> boundSets = { descriptorSets[currentFrame], textureDescriptorSet };
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+		pipelineLayout, 0, static_cast<uint32_t>(boundSets.size()), boundSets.data(),
+		static_cast<uint32_t>(frameDynamicOffsets.size()), frameDynamicOffsets.data()
+	);
+}
+/**
+ * @brief Records the draws in [firstDraw, endDraw) of the scene's passes, with the scene state already bound.
+ *
+ * In a single pass these are just the batch list's draws. With the depth pre-pass the range covers
+ * the batch list twice: the first half draws depth with depthPrepassPipeline from the position
+ * stream, the second shades with graphicsPipeline from the full vertices. Ranges are executed in
+ * order, so every pre-pass draw lands before any color draw however the range is split. The range
+ * that finishes the pre-pass also records TIMESTAMP_PREPASS_END.
+ */
+void VulkanRenderer::RecordScenePasses(VkCommandBuffer commandBuffer, uint32_t firstDraw, uint32_t endDraw) {
+	if (depthPrepassPipeline == VK_NULL_HANDLE) {
+		RecordSceneDraws(commandBuffer, firstDraw, endDraw);
+		return;
+	}
+
+	// Both pipelines share the layout and dynamic state, so only the pipeline and vertex stream change.
+	const uint32_t batchCount = static_cast<uint32_t>(instanceBatches.size());
+	if (firstDraw < batchCount) {
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, depthPrepassPipeline);
+		geometryBuffer->BindPositions(commandBuffer);
+		RecordSceneDraws(commandBuffer, firstDraw, std::min(endDraw, batchCount));
+		if (endDraw >= batchCount) {
+			gpuTimer->WriteTimestamp(commandBuffer, currentFrame, TIMESTAMP_PREPASS_END, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+		}
+	}
+	if (endDraw > batchCount) {
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+		geometryBuffer->Bind(commandBuffer);
+		RecordSceneDraws(commandBuffer, std::max(firstDraw, batchCount) - batchCount, endDraw - batchCount);
+	}
+}
+/**
+ * @brief Records the draws in [firstDraw, endDraw) of the current frame's batch list.
+ *
+ * Only reads renderer state, so disjoint ranges can be recorded on several threads at once.
+ * A run drawn with vkCmdDrawIndexedIndirectCount cannot be split, since its draw count covers the
+ * whole run; it is recorded whole by the range that contains its first draw.
+ */
+void VulkanRenderer::RecordSceneDraws(VkCommandBuffer commandBuffer, uint32_t firstDraw, uint32_t endDraw) {
+	const uint32_t stride = sizeof(DrawCommand);
+	for (uint32_t runIndex = 0; runIndex < drawRuns.size(); runIndex++) {
+		const DrawRun& run = drawRuns[runIndex];
+		uint32_t begin = std::max(run.firstDraw, firstDraw);
+		uint32_t end = std::min(run.firstDraw + run.drawCount, endDraw);
+		if (begin >= end) {
+			continue;
+		}
+
+		if (useIndirectDraw && drawIndirectCountSupported) {
+			if (begin != run.firstDraw) {
+				continue;
+			}
+			// Draw only the run's non-empty draws, as compacted and counted by the culling pass.
+			vkCmdDrawIndexedIndirectCount(
+				commandBuffer,
+				gpuCuller->GetCompactedDrawBuffer(currentFrame), run.firstDraw * stride,
+				gpuCuller->GetDrawCountBuffer(currentFrame), GpuCuller::GetDrawCountOffset(runIndex),
+				run.drawCount, stride
+			);
+		}
+		else if (useIndirectDraw) {
+			// Fallback: issue every draw in the range; fully culled draws have an instance count of zero.
+			if (multiDrawIndirectSupported) {
+				vkCmdDrawIndexedIndirect(commandBuffer, indirectBuffers[currentFrame], begin * stride, end - begin, stride);
+			}
+			else {
+				// Without multiDrawIndirect the draw count must be 0 or 1.
+				for (uint32_t draw = begin; draw < end; draw++) {
+					vkCmdDrawIndexedIndirect(commandBuffer, indirectBuffers[currentFrame], draw * stride, 1, stride);
+				}
+			}
+		}
+		else {
+			// Direct path: one instanced draw per batch; the shader reads its transform through the visible list.
+			for (uint32_t batchIndex = begin; batchIndex < end; batchIndex++) {
+				const InstanceBatch& batch = instanceBatches[batchIndex];
+				batch.mesh->Draw(commandBuffer, batch.instanceCount, batch.firstInstance);
+			}
+		}
+	}
+}
 /**
  * @brief Manages the rendering of a single frame.
  *
@@ -2107,6 +3182,12 @@ void VulkanRenderer::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t
  * @throws std::runtime_error if any Vulkan operations (e.g., acquiring images, submitting commands, or presenting) fail.
  */
 void VulkanRenderer::DrawFrame() {
+	// Add models requested by the UI (or the draw benchmark) last frame before anything is recorded.
+	UpdateDrawBenchmark();
+	UpdateRecordBenchmark();
+	ProcessPendingModels();
+	ReloadChangedShaders();
+
 	// Wait for the current frame's fence to ensure the GPU has finished processing the previous frame.
 	vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
 
@@ -2133,12 +3214,17 @@ void VulkanRenderer::DrawFrame() {
 	// Reset the fence for the current frame to unsignaled state.
 	vkResetFences(device, 1, &inFlightFences[currentFrame]);
 
+	// Lay out the frame's region of the ring buffer, camera first and then the batched instances.
+	// The frame's previous use of the region has completed.
+	ReserveInstanceCapacity();
+	frameRing->BeginFrame(currentFrame);
+	UpdateUniformBuffer();
+	UpdateInstanceBuffer(currentFrame);
+	UpdateIndirectBuffer(currentFrame);
+
 	// Reset and record the command buffer for the current frame.
 	vkResetCommandBuffer(commandBuffers[currentFrame], 0);
 	RecordCommandBuffer(commandBuffers[currentFrame], imageIndex);
-
-	// Update the uniform buffer with frame-specific data.
-	UpdateUniformBuffer(currentFrame);
 	
 	// Configure the submit info for rendering.
 	VkSubmitInfo submitInfo{};
@@ -2188,7 +3274,7 @@ void VulkanRenderer::DrawFrame() {
 	}
 
 	// Advance to the next frame, looping back after the last frame.
-	currentFrame = (currentFrame + 1) % swapChainImages.size();
+	currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 }
 
 
@@ -2209,7 +3295,9 @@ void VulkanRenderer::AssignDebugNames() {
 	}
 
 	// Render Pass
-	SetObjectName(device, (uint64_t)renderPass, VK_OBJECT_TYPE_RENDER_PASS, "Main Render Pass");
+	if (renderPass != VK_NULL_HANDLE) {
+		SetObjectName(device, (uint64_t)renderPass, VK_OBJECT_TYPE_RENDER_PASS, "Main Render Pass");
+	}
 
 	// Graphics Pipeline
 	SetObjectName(device, (uint64_t)graphicsPipeline, VK_OBJECT_TYPE_PIPELINE, "Main Graphics Pipeline");
@@ -2227,11 +3315,8 @@ void VulkanRenderer::AssignDebugNames() {
 		SetObjectName(device, (uint64_t)swapChainFramebuffers[i], VK_OBJECT_TYPE_FRAMEBUFFER, name.c_str());
 	}
 
-	// Uniform Buffers
-	for (size_t i = 0; i < uniformBuffers.size(); i++) {
-		std::string name = "Uniform Buffer " + std::to_string(i);
-		SetObjectName(device, (uint64_t)uniformBuffers[i], VK_OBJECT_TYPE_BUFFER, name.c_str());
-	}
+	// Frame Ring Buffer
+	SetObjectName(device, (uint64_t)frameRing->GetBuffer(), VK_OBJECT_TYPE_BUFFER, "Frame Ring Buffer");
 
 	// Command Buffers
 	for (size_t i = 0; i < commandBuffers.size(); i++) {
@@ -2434,13 +3519,28 @@ bool VulkanRenderer::IsDeviceSuitable(VkPhysicalDevice device) {
 	// Ensure required features are supported, including anisotropic filtering.
 	bool supportsAnisotropy = deviceFeatures.samplerAnisotropy;
 
+	// Textures are sampled from a single bindless array, which needs Vulkan 1.2 descriptor indexing.
+	VkPhysicalDeviceVulkan12Features vulkan12Features{};
+	vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	VkPhysicalDeviceFeatures2 features2{};
+	features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	features2.pNext = &vulkan12Features;
+	vkGetPhysicalDeviceFeatures2(device, &features2);
+	bool supportsBindlessTextures = vulkan12Features.descriptorIndexing &&
+		vulkan12Features.shaderSampledImageArrayNonUniformIndexing &&
+		vulkan12Features.descriptorBindingSampledImageUpdateAfterBind &&
+		vulkan12Features.descriptorBindingUpdateUnusedWhilePending &&
+		vulkan12Features.descriptorBindingPartiallyBound &&
+		vulkan12Features.runtimeDescriptorArray;
+
 	// A device is suitable if it satisfies all conditions.
 	return indices.IsComplete() &&  // All required queue families are supported.
 		   isDiscreteGPU &&         // Prefer discrete GPUs for performance.
 		   hasGeometryShader &&     // Geometry shaders must be supported.
 		   extensionsSupported &&   // All required extensions are supported.
 		   swapChainAdequate &&     // Swap chain supports at least one format and present mode.
-		   supportsAnisotropy;      // Anisotropic filtering is supported.
+		   supportsAnisotropy &&    // Anisotropic filtering is supported.
+		   supportsBindlessTextures; // Descriptor indexing for the bindless texture array is supported.
 }
 <<<<<<< HEAD
 
@@ -2651,7 +3751,7 @@ VkShaderModule VulkanRenderer::CreateShaderModule(const std::vector<char>& code)
 	VkShaderModule shaderModule;
 
 	// Create the shader module.
-	if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+	if (vkCreateShaderModule(device, &createInfo, allocator, &shaderModule) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create shader module!");  // Throw an error if creation fails.
 	}
 
@@ -2694,7 +3794,8 @@ void VulkanRenderer::RecreateSwapChain() {
 	CreateFramebuffers();    // Recreate framebuffers for the swap chain.
 <<<<<<< HEAD
 =======
-	CreateImGuiFramebuffers();
+	// Cached scene draws set the old extent as their viewport and scissor.
+	sceneResourceVersion++;
 >>>>>>> Testing
 }
 /**
@@ -2732,34 +3833,26 @@ void VulkanRenderer::CleanupSwapChain() {
 
 
 =======
-	// --- Clean up IMGUI framebuffers ---
-	for (auto framebuffer : imguiFramebuffers) {
-		if (framebuffer != VK_NULL_HANDLE) {
-			vkDestroyFramebuffer(device, framebuffer, nullptr);
-		}
-	}
-	imguiFramebuffers.clear();
-
 	// --- Clean up color image resources (for multisampling) ---
 	if (colorImageView != VK_NULL_HANDLE)
-		vkDestroyImageView(device, colorImageView, nullptr);
+		vkDestroyImageView(device, colorImageView, allocator);
 	if (colorImage != VK_NULL_HANDLE)
-		vkDestroyImage(device, colorImage, nullptr);
+		vkDestroyImage(device, colorImage, allocator);
 	if (colorImageMemory != VK_NULL_HANDLE)
-		vkFreeMemory(device, colorImageMemory, nullptr);
+		vkFreeMemory(device, colorImageMemory, allocator);
 
 	// --- Clean up depth resources ---
 	if (depthImageView != VK_NULL_HANDLE)
-		vkDestroyImageView(device, depthImageView, nullptr);
+		vkDestroyImageView(device, depthImageView, allocator);
 	if (depthImage != VK_NULL_HANDLE)
-		vkDestroyImage(device, depthImage, nullptr);
+		vkDestroyImage(device, depthImage, allocator);
 	if (depthImageMemory != VK_NULL_HANDLE)
-		vkFreeMemory(device, depthImageMemory, nullptr);
+		vkFreeMemory(device, depthImageMemory, allocator);
 
 	// --- Destroy all swap chain framebuffers ---
 	for (auto framebuffer : swapChainFramebuffers) {
 		if (framebuffer != VK_NULL_HANDLE) {
-			vkDestroyFramebuffer(device, framebuffer, nullptr);
+			vkDestroyFramebuffer(device, framebuffer, allocator);
 		}
 	}
 	swapChainFramebuffers.clear();
@@ -2767,14 +3860,14 @@ void VulkanRenderer::CleanupSwapChain() {
 	// --- Destroy all swap chain image views ---
 	for (auto imageView : swapChainImageViews) {
 		if (imageView != VK_NULL_HANDLE) {
-			vkDestroyImageView(device, imageView, nullptr);
+			vkDestroyImageView(device, imageView, allocator);
 		}
 	}
 	swapChainImageViews.clear();
 
 	// --- Destroy the swap chain itself ---
 	if (swapChain != VK_NULL_HANDLE)
-		vkDestroySwapchainKHR(device, swapChain, nullptr);
+		vkDestroySwapchainKHR(device, swapChain, allocator);
 }
 >>>>>>> Testing
 /**
@@ -2881,15 +3974,11 @@ VkSampleCountFlagBits VulkanRenderer::GetMaxUsableSampleCount() {
 
 void VulkanRenderer::SetPolygonMode(VkCommandBuffer commandBuffer, VkPolygonMode mode)
 {
-	auto vkCmdSetPolygonModeEXT = reinterpret_cast<PFN_vkCmdSetPolygonModeEXT>(
-		vkGetDeviceProcAddr(device, "vkCmdSetPolygonModeEXT"));
-
-	if (!vkCmdSetPolygonModeEXT) {
-		throw std::runtime_error("Failed to load vkCmdSetPolygonModeEXT!");
+	// Called from recording threads, so it must not modify renderer state. Without the dynamic
+	// state the bound pipeline variant already has the right mode.
+	if (dynamicPolygonModeSupported) {
+		cmdSetPolygonMode(commandBuffer, mode);
 	}
-
-	vkCmdSetPolygonModeEXT(commandBuffer, mode);
-	currentPolygonMode = mode; // Update the current mode
 }
 
 
@@ -6,6 +6,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -17,7 +18,21 @@
 
 // Project Headers
 #include "Camera.h"
-#include "Model.h"
+#include "DescriptorAllocator.h"
+#include "FrameRingBuffer.h"
+#include "FileWatcher.h"
+#include "FrustumCuller.h"
+#include "GpuCuller.h"
+#include "GpuTimer.h"
+#include "HostAllocator.h"
+#include "LayoutCache.h"
+#include "ParallelCommandRecorder.h"
+#include "PipelineCache.h"
+#include "PipelineStateCache.h"
+#include "RenderGraph.h"
+#include "RenderQueue.h"
+#include "Scene.h"
+#include "ShaderCompiler.h"
 #include "Utilities.h"
 
 /**
@@ -48,7 +63,11 @@ public:
     // Public Methods (interface)
     void Run();
     void Update(float deltaTime);
-    void AddModel(const std::string& modelPath, const std::string& texturePath);
+    void AddModel(const std::string& modelPath, const std::string& texturePath, const glm::vec3& position = glm::vec3(0.0f));
+    void RequestModelSpawn(uint32_t count);
+    void SetDynamicRenderingEnabled(bool enabled);
+    void SetStatsReportEnabled(bool enabled);
+    static void BuildShaderBundle(std::ostream& out);
     //void RemoveModel(uint32_t index);
     //void UpdateDescriptors();
 
@@ -65,6 +84,30 @@ private:
 #else
     static constexpr bool enableValidationLayer = true;
 #endif
+    static constexpr bool enableHostAllocator = true; // Route driver host allocations through HostAllocator.
+    static constexpr uint32_t INITIAL_INSTANCE_CAPACITY = 1024; // Instances per frame before the instance buffers grow.
+    static constexpr uint32_t MAX_TEXTURES = 4096;              // Bindless texture array size, clamped to the device limit.
+    static constexpr uint32_t MAX_DRAW_RUNS = 16;               // Runs of draws the GPU culler can compact separately.
+    static constexpr uint32_t INITIAL_INDIRECT_CAPACITY = 64;   // Indirect draw commands per frame before the buffers grow.
+    static constexpr std::array<uint32_t, 6> DRAW_BENCHMARK_COUNTS{ 1, 10, 100, 1000, 10000, 100000 };
+    static constexpr uint32_t DRAW_BENCHMARK_WARMUP_FRAMES = 8;
+    static constexpr uint32_t DRAW_BENCHMARK_SAMPLE_FRAMES = 64;
+    static constexpr uint32_t RECORD_BENCHMARK_OBJECT_COUNT = 10000; // Models (one draw each) recorded by the thread scaling benchmark.
+    static constexpr uint32_t MIN_DRAWS_PER_RECORDING_THREAD = 256;  // Fewer draws per thread are recorded inline.
+    static constexpr uint32_t POLYGON_MODE_COUNT = 3;                // Fill, line and point each keep their own cached scene draws.
+    static constexpr uint64_t STALE_VERSION = UINT64_MAX;           // Version that never matches, forcing a rebuild.
+    static constexpr float NEAR_PLANE = 0.1f;
+    static constexpr float FAR_PLANE = 10.0f;
+    static constexpr float GPU_TIMING_SMOOTHING = 0.05f;             // Weight of each new frame in the GPU timing averages.
+    // Timestamps written into each frame's command buffer (see UpdateGpuTimings).
+    enum GpuTimestamp : uint32_t {
+        TIMESTAMP_FRAME_BEGIN,
+        TIMESTAMP_SCENE_BEGIN,
+        TIMESTAMP_PREPASS_END,   // Only written by frames that draw the depth pre-pass.
+        TIMESTAMP_SCENE_END,
+        TIMESTAMP_FRAME_END,
+        TIMESTAMP_COUNT
+    };
 
 >>>>>>> Testing
     bool isCursorLocked = false;
@@ -73,8 +116,7 @@ private:
         "VK_LAYER_KHRONOS_validation"
     };
     const std::vector<const char*> deviceExtensions{
-        VK_KHR_SWAPCHAIN_EXTENSION_NAME,
-        "VK_EXT_extended_dynamic_state3"
+        VK_KHR_SWAPCHAIN_EXTENSION_NAME
     };
 <<<<<<< HEAD
 #ifdef NDEBUG
@@ -86,6 +128,12 @@ private:
     // === Core Vulkan Objects ===
 =======
 
+    // ====================================================
+    // Host Allocation
+    // ====================================================
+    HostAllocator hostAllocator;
+    const VkAllocationCallbacks* allocator = enableHostAllocator ? hostAllocator.GetCallbacks() : nullptr;
+
     // ====================================================
     // Core Vulkan Objects & Window
     // ====================================================
@@ -122,9 +170,13 @@ private:
 =======
 >>>>>>> Testing
     VkRenderPass renderPass = VK_NULL_HANDLE;
-    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
-    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
-    VkPipeline graphicsPipeline = VK_NULL_HANDLE;
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;       // Set 0: per-frame uniform and instance buffers, owned by layoutCache.
+    VkDescriptorSetLayout textureDescriptorSetLayout = VK_NULL_HANDLE; // Set 1: bindless texture array.
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;                 // Owned by layoutCache.
+    ShaderReflection sceneShaderInterface;                            // Bindings, push constants and inputs of the scene shaders.
+    VkPipeline graphicsPipeline = VK_NULL_HANDLE;                     // Scene variant for the current polygon mode, owned by pipelineStates.
+    VkPipeline fallbackPipeline = VK_NULL_HANDLE;                     // Fill variant, drawn with while another variant compiles.
+    VkPipeline depthPrepassPipeline = VK_NULL_HANDLE;                 // Position-only depth writer this frame, or null for a single pass.
     std::vector<VkFramebuffer> swapChainFramebuffers;
 
 <<<<<<< HEAD
@@ -135,12 +187,6 @@ private:
     // Synchronization Objects
     const int MAX_FRAMES_IN_FLIGHT = 2;
 =======
-    // ====================================================
-    // IMGUI Debug Pipeline (implementation details moved to .cpp)
-    // ====================================================
-    VkRenderPass imguiRenderPass = VK_NULL_HANDLE;
-    std::vector<VkFramebuffer> imguiFramebuffers;
-
     // ====================================================
     // Command Pool & Buffers
     // ====================================================
@@ -174,24 +220,69 @@ private:
     // ====================================================
     // Memory Resources & Buffers
     // ====================================================
-    std::vector<VkBuffer> uniformBuffers;
-    std::vector<VkDeviceMemory> uniformBuffersMemory;
-    std::vector<void*> uniformBuffersMapped;
     VkImage colorImage = VK_NULL_HANDLE;
     VkDeviceMemory colorImageMemory = VK_NULL_HANDLE;
     VkImageView colorImageView = VK_NULL_HANDLE;
     VkImage depthImage = VK_NULL_HANDLE;
     VkDeviceMemory depthImageMemory = VK_NULL_HANDLE;
     VkImageView depthImageView = VK_NULL_HANDLE;
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+    VkDeviceSize colorImageAllocationSize = 0;   // Transient attachment sizes; the overlay compares them with the committed memory.
+    VkDeviceSize depthImageAllocationSize = 0;
+    bool colorImageLazilyAllocated = false;
+    bool depthImageLazilyAllocated = false;
+
+    // Per-frame camera and instance data, written linearly and bound with dynamic offsets.
+    std::unique_ptr<FrameRingBuffer> frameRing;
+    std::array<uint32_t, 2> frameDynamicOffsets{}; // Set 0 bindings 0 (camera) and 1 (instances) of the current frame.
+    InstanceData* frameInstances = nullptr;        // The current frame's instance slice.
+    uint32_t instanceCapacity = 0;                 // Instances each frame's slice holds.
+
+    // Per-frame VkDrawIndexedIndirectCommand per instance batch.
+    std::vector<VkBuffer> indirectBuffers;
+    std::vector<VkDeviceMemory> indirectBuffersMemory;
+    std::vector<void*> indirectBuffersMapped;
+    uint32_t indirectCapacity = 0;
 
 >>>>>>> Testing
-    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
-    std::vector<VkDescriptorSet> descriptorSets;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;        // ImGui's descriptors.
+    std::vector<std::unique_ptr<DescriptorAllocator>> frameDescriptorAllocators; // Growable pools per frame, reset when its set is rebuilt.
+    std::vector<VkDescriptorSet> descriptorSets;             // Set 0 of each frame.
+    VkDescriptorPool textureDescriptorPool = VK_NULL_HANDLE; // Update-after-bind pool holding the bindless set.
+    VkDescriptorSet textureDescriptorSet = VK_NULL_HANDLE;   // Global texture array, bound once per frame.
+    uint32_t textureDescriptorCapacity = 0;                  // Array elements, MAX_TEXTURES or the device limit.
+    uint32_t textureDescriptorCount = 0;                     // Array elements written so far.
 
     // === Configuration Values ===
     VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
     VkPolygonMode currentPolygonMode = VK_POLYGON_MODE_FILL;
 
+    // Toggles compiled into the scene fragment shader; must match the constant_ids in shader.frag.
+    struct SceneShaderFeatures {
+        bool vertexColor = true;    // constant_id 0: modulate the texture by the vertex color.
+        bool alphaTest = false;     // constant_id 1: discard texels with alpha below alphaCutoff.
+        float alphaCutoff = 0.5f;   // constant_id 2.
+
+        SpecializationConstants FragmentConstants() const;
+    };
+    SceneShaderFeatures sceneShaderFeatures;
+    bool indirectDrawSupported = false;       // drawIndirectFirstInstance is available.
+    bool multiDrawIndirectSupported = false;  // multiDrawIndirect is available.
+    bool useIndirectDraw = false;             // Draw batches from the indirect buffer instead of vkCmdDrawIndexed.
+    bool drawIndirectCountSupported = false;  // Vulkan 1.2 drawIndirectCount is available.
+    bool dynamicPolygonModeSupported = false; // VK_EXT_extended_dynamic_state3 polygon mode; otherwise wireframe is its own pipeline.
+    bool dynamicRenderingRequested = true;    // Use dynamic rendering when the device supports it.
+    bool statsReportRequested = false;        // Print startup timing and host allocation usage to stdout (--stats).
+    bool useDynamicRendering = false;         // Render with vkCmdBeginRendering; no render pass or framebuffers exist.
+    bool gpuCullingEnabled = true;            // Frustum cull instances in the compute pre-pass.
+    bool cpuCullingEnabled = false;           // Frustum cull models on the CPU before batching.
+    bool instancingEnabled = true;            // Batch models sharing a mesh; off gives every model its own draw.
+    bool depthSortEnabled = false;            // Order draws sharing state front to back; re-sorts whenever the camera moves.
+    uint32_t recordingThreadCount = 1;        // Most threads recording the scene draws; 1 records inline into the primary.
+    bool sceneCommandCacheEnabled = true;     // Keep executing the recorded scene draws until what they reference changes.
+    bool depthPrepassEnabled = false;         // Lay down depth first, then shade only the visible fragments.
+    PFN_vkCmdSetPolygonModeEXT cmdSetPolygonMode = nullptr; // Loaded once so recording threads never query it.
+
 <<<<<<< HEAD
     // === Time Tracking ===
 =======
@@ -205,6 +296,37 @@ private:
     uint64_t frameCount = 0;
     std::chrono::time_point<std::chrono::high_resolution_clock> startTime;
     std::chrono::time_point<std::chrono::high_resolution_clock> lastFrameTime;
+    float startupTimeMs = 0.0f;      // Time from Run to the first frame: window, Vulkan and ImGui setup.
+    static constexpr uint32_t FRAME_TIME_HISTORY_SIZE = 240;
+    std::array<float, FRAME_TIME_HISTORY_SIZE> frameTimeHistory{}; // Recent frame times in ms, oldest at frameTimeHistoryIndex.
+    uint32_t frameTimeHistoryIndex = 0;
+    float frameTimeHistorySumMs = 0.0f;
+    uint32_t hitchCount = 0;         // Frames that took over twice the history's average.
+    float lastHitchMs = 0.0f;
+    float sceneRecordTimeMs = 0.0f;  // CPU time spent recording the scene draws last frame.
+    float cpuCullTimeMs = 0.0f;      // CPU time spent culling models last frame.
+    // GPU time of the scene pass and the frame, averaged separately for each configuration.
+    struct GpuTimings {
+        float prepassMs = 0.0f;      // Scene start to the end of the depth pre-pass draws.
+        float sceneMs = 0.0f;        // Whole scene pass, pre-pass included.
+        float frameMs = 0.0f;        // Whole command buffer.
+        uint32_t samples = 0;
+    };
+    std::array<GpuTimings, 2> gpuTimings{}; // [0] single pass, [1] with the depth pre-pass.
+
+    // Draw benchmark state (see UpdateDrawBenchmark).
+    bool drawBenchmarkRunning = false;
+    size_t drawBenchmarkStep = 0;
+    uint32_t drawBenchmarkFrame = 0;
+    double drawBenchmarkDirectMs = 0.0;
+    double drawBenchmarkIndirectMs = 0.0;
+
+    // Recording benchmark state (see UpdateRecordBenchmark).
+    bool recordBenchmarkRunning = false;
+    uint32_t recordBenchmarkThreads = 0;
+    uint32_t recordBenchmarkFrame = 0;
+    double recordBenchmarkMs = 0.0;
+    double recordBenchmarkBaselineMs = 0.0;  // Single-thread time the speedups are relative to.
 
 <<<<<<< HEAD
     // === Models and Resources ===
@@ -215,8 +337,29 @@ private:
 >>>>>>> Testing
     const std::string MODEL_PATH = "VulkanModels/viking_room.obj";
     const std::string TEXTURE_PATH = "VulkanTextures/viking_room.png";
-    std::vector<std::unique_ptr<Model>> modelList;
+    static constexpr char VERTEX_SHADER_PATH[] = "VulkanShaders/shader.vert";
+    static constexpr char FRAGMENT_SHADER_PATH[] = "VulkanShaders/shader.frag";
+    static constexpr char DEPTH_SHADER_PATH[] = "VulkanShaders/depth.vert";
+    static constexpr char CULL_SHADER_PATH[] = "VulkanShaders/cull.comp";
+    static constexpr char SHADER_BUNDLE_PATH[] = "VulkanShaders/shaders.bundle"; // Written by --build-shaders.
+    Scene scene;                                     // Every placed model, stored as dense component arrays.
+    ThreadPool threadPool;                           // Workers for data-parallel per-frame loops.
+    std::unique_ptr<ParallelCommandRecorder> commandRecorder; // Per-thread secondaries for the scene draws.
     std::unique_ptr<Camera> camera;
+    std::unique_ptr<GeometryBuffer> geometryBuffer;  // Shared vertex and index buffers for every mesh.
+    std::unique_ptr<PipelineCache> pipelineCache;    // Every pipeline is created through it; persisted between runs.
+    std::unique_ptr<ShaderCompiler> shaderCompiler;  // GLSL to SPIR-V for pipelineStates; must outlive it.
+    std::unique_ptr<FileWatcher> shaderWatcher;      // Reports edited shader sources for hot reload.
+    std::unique_ptr<LayoutCache> layoutCache;        // Descriptor set and pipeline layouts, one per distinct description.
+    uint32_t shaderReloads = 0;                      // Shader edits applied since startup.
+    std::unique_ptr<PipelineStateCache> pipelineStates; // Graphics pipeline variants, keyed by PipelineDesc.
+    std::unique_ptr<GpuCuller> gpuCuller;            // Compute frustum culling and draw compaction.
+    GpuCuller::Stats cullStats;                      // Counters from the last completed use of the current frame.
+    std::unique_ptr<GpuTimer> gpuTimer;              // Timestamp queries behind gpuTimings.
+    std::vector<std::unique_ptr<RenderGraph>> renderGraphs; // Per frame in flight: its passes and the barriers between them.
+    std::unordered_map<std::string, std::shared_ptr<Mesh>> meshCache;
+    std::unordered_map<std::string, std::shared_ptr<Texture>> textureCache;
+    uint32_t pendingModelSpawns = 0;
 
 <<<<<<< HEAD
     // === Utility Structures ===
@@ -250,6 +393,52 @@ private:
         alignas(16) glm::mat4 view;
         alignas(16) glm::mat4 proj;
     };
+    struct InstanceBatch {
+        Mesh* mesh;
+        uint32_t firstInstance;
+        uint32_t instanceCount;
+
+        bool operator==(const InstanceBatch& other) const = default;
+    };
+    std::vector<InstanceBatch> instanceBatches;  // One instanced draw per batch.
+    std::vector<uint32_t> visibleModels;         // Dense scene indices drawn this frame (all of them unless CPU culling is on).
+    std::vector<uint32_t> modelBatchIndices;     // Batch index of each visible model, in render queue order.
+    RenderQueue renderQueue;                     // Visible models sorted by state and depth; instance slot i holds item i.
+    struct DrawRun {
+        uint32_t firstDraw;
+        uint32_t drawCount;
+
+        bool operator==(const DrawRun& other) const = default;
+    };
+    std::vector<DrawRun> drawRuns;               // Consecutive batches drawn with the same bound state.
+    uint64_t batchedSceneVersion = STALE_VERSION; // Scene version instanceBatches was built from.
+    bool batchedWithInstancing = true;            // instancingEnabled when instanceBatches was built.
+    bool batchedWithDepthSort = false;            // depthSortEnabled when instanceBatches was built.
+    glm::mat4 batchedViewMatrix{ 1.0f };          // Camera the depth sort of instanceBatches used.
+    // State changes between consecutive draws of the sorted queue; the rest are binds a per-draw renderer would repeat.
+    struct BindStats {
+        uint32_t draws = 0;
+        uint32_t pipelineChanges = 0;
+        uint32_t materialChanges = 0;
+        uint32_t meshChanges = 0;
+    };
+    BindStats bindStats;
+    std::vector<uint64_t> instanceDataVersions; // Scene version held by each frame's instance slice.
+
+    // Everything the recorded scene draws depend on; a recorder slot is reused while its key matches.
+    struct SceneCommandKey {
+        bool valid = false;
+        uint64_t resourceVersion = 0;
+        VkPipeline pipeline = VK_NULL_HANDLE;  // The fallback is swapped out once the real variant is published.
+        VkPipeline prepassPipeline = VK_NULL_HANDLE;
+        bool indirect = false;
+        std::array<uint32_t, 2> dynamicOffsets{};
+        std::vector<InstanceBatch> batches;
+        std::vector<DrawRun> runs;
+    };
+    std::vector<SceneCommandKey> sceneCommandKeys; // One per recorder slot (frame in flight x polygon mode).
+    uint64_t sceneResourceVersion = 0;             // Bumped when a handle recorded into the scene draws is replaced.
+    bool sceneCommandsReused = false;              // The last frame executed cached scene draws.
 
 <<<<<<< HEAD
     // === Core Methods ===
@@ -281,18 +470,20 @@ private:
     void CreateRenderPass();
     void CreateDescriptorSetLayout();
     void CreateGraphicsPipeline();
+    PipelineDesc ScenePipelineDesc(VkPolygonMode polygonMode, bool afterDepthPrepass = false) const;
+    PipelineDesc DepthPrepassPipelineDesc() const;
     void CreateFramebuffers();
-<<<<<<< HEAD
-=======
-    void CreateImGuiRenderPass();
-    void CreateImGuiFramebuffers();
->>>>>>> Testing
     void CreateCommandPool();
     void CreateColorResources();
     void CreateDepthResources();
-    void CreateUniformBuffers();
+    VkDeviceSize GetCommittedMemory(VkDeviceMemory memory, VkDeviceSize allocationSize, bool lazilyAllocated) const;
     void CreateDescriptorPool();
     void CreateDescriptorSets();
+    void CreateTextureDescriptorSet();
+    void WriteTextureDescriptor(Texture* texture);
+    void CreateFrameRingBuffer(uint32_t capacity);
+    void CreateIndirectBuffers(uint32_t capacity);
+    void DestroyIndirectBuffers();
     void CreateCommandBuffers();
     void CreateSyncObjects();
 
@@ -303,11 +494,27 @@ private:
     // ====================================================
     // Rendering & Drawing Methods
     // ====================================================
-    void RenderImGui(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+    void RenderImGui(VkCommandBuffer commandBuffer);
     void LoadDefualtModels();
+    std::shared_ptr<Mesh> GetOrLoadMesh(const std::string& modelPath);
+    std::shared_ptr<Texture> GetOrLoadTexture(const std::string& texturePath);
+    void ProcessPendingModels();
+    void CullModels();
+    void ReserveInstanceCapacity();
+    void UpdateInstanceBuffer(uint32_t frame);
+    void ScatterInstances(uint32_t frame);
+    void UpdateIndirectBuffer(uint32_t frame);
+    void UpdateDrawBenchmark();
+    void UpdateRecordBenchmark();
+    void ReloadChangedShaders();
+    void UpdateGpuTimings();
 >>>>>>> Testing
-    void UpdateUniformBuffer(uint32_t currentImage);
+    void UpdateUniformBuffer();
+    glm::mat4 GetProjectionMatrix() const;
     void RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+    void RecordSceneState(VkCommandBuffer commandBuffer);
+    void RecordScenePasses(VkCommandBuffer commandBuffer, uint32_t firstDraw, uint32_t endDraw);
+    void RecordSceneDraws(VkCommandBuffer commandBuffer, uint32_t firstDraw, uint32_t endDraw);
     void DrawFrame();
 
 <<<<<<< HEAD
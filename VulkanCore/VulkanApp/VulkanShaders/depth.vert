@@ -0,0 +1,33 @@
+#version 450
+
+// Depth pre-pass: the same transform as shader.vert, fed by the position-only vertex stream.
+// The color pass tests against this depth with EQUAL, so both must compute gl_Position identically.
+
+layout(set = 0, binding = 0) uniform UniformBufferObject {
+	mat4 view;
+	mat4 proj;
+} ubo;
+
+struct InstanceData {
+	mat4 model;         // Model transformation matrix
+	uint textureIndex;  // Element of the bindless texture array
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer InstanceBuffer {
+	InstanceData data[];  // One entry per instance
+} instances;
+
+layout(std430, set = 0, binding = 2) readonly buffer VisibleInstanceBuffer {
+	uint indices[];  // Instance index per drawn instance, compacted by the culling pass
+} visible;
+
+
+layout(location = 0) in vec3 inPosition;
+
+invariant gl_Position;
+
+
+void main() {
+ InstanceData instance = instances.data[visible.indices[gl_InstanceIndex]];
+ gl_Position =  ubo.proj * ubo.view * instance.model * vec4(inPosition, 1.0);
+}
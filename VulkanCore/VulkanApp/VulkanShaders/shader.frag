@@ -1,15 +1,23 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 layout(location = 0) in vec3 inColor;
 layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in uint fragTextureIndex;
 
 layout(location = 0) out vec4 outColor;
-layout(binding = 1) uniform sampler2D texSampler;
+layout(set = 1, binding = 0) uniform sampler2D textures[];  // Bindless texture array, indexed per instance
+
+// Feature toggles, fixed when the pipeline is created, so a disabled feature costs nothing.
+layout(constant_id = 0) const bool VERTEX_COLOR = true;    // Modulate the texture by the vertex color.
+layout(constant_id = 1) const bool ALPHA_TEST = false;     // Discard texels with alpha below ALPHA_CUTOFF.
+layout(constant_id = 2) const float ALPHA_CUTOFF = 0.5;
 
 void main() {
- outColor = texture(texSampler, fragTexCoord);
- outColor = texture(texSampler, fragTexCoord * 2.0);
- outColor = vec4(inColor * texture(texSampler,
-	fragTexCoord).rgb, 1.0);
-	//outColor = vec4(1.0, 1.0, 1.0, 1.0);
+ // The index can differ between instances within one draw, so it must be marked non-uniform.
+ vec4 texel = texture(textures[nonuniformEXT(fragTextureIndex)], fragTexCoord);
+ if (ALPHA_TEST && texel.a < ALPHA_CUTOFF) {
+	discard;
+ }
+ outColor = vec4(VERTEX_COLOR ? inColor * texel.rgb : texel.rgb, 1.0);
 }
\ No newline at end of file
@@ -1,14 +1,23 @@
 #version 450
 
-layout(push_constant) uniform PushConstants {
-	mat4 model;  // Model transformation matrix
-} pushConstants;
-	
 layout(set = 0, binding = 0) uniform UniformBufferObject {
 	mat4 view;
 	mat4 proj;
 } ubo;
 
+struct InstanceData {
+	mat4 model;         // Model transformation matrix
+	uint textureIndex;  // Element of the bindless texture array
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer InstanceBuffer {
+	InstanceData data[];  // One entry per instance
+} instances;
+
+layout(std430, set = 0, binding = 2) readonly buffer VisibleInstanceBuffer {
+	uint indices[];  // Instance index per drawn instance, compacted by the culling pass
+} visible;
+
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
@@ -16,12 +25,18 @@ layout(location = 2) in vec2 inTexCoord;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) flat out uint fragTextureIndex;
+
+// Must match depth.vert exactly, or the color pass fails its EQUAL test against the depth pre-pass.
+invariant gl_Position;
 
 
 void main() {
- gl_Position =  ubo.proj * ubo.view * pushConstants.model * vec4(inPosition, 1.0);
+ InstanceData instance = instances.data[visible.indices[gl_InstanceIndex]];
+ gl_Position =  ubo.proj * ubo.view * instance.model * vec4(inPosition, 1.0);
 
  fragColor = inColor;
  fragTexCoord = inTexCoord;
+ fragTextureIndex = instance.textureIndex;
 }
 
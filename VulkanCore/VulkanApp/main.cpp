@@ -1,9 +1,44 @@
 #include "VulkanRenderer.h"
 
+#include <cstring>
 
-int main() {
+
+int main(int argc, char* argv[]) {
 	try {
-		VulkanRenderer().Run();
+		// Run the CPU-only microbenchmarks and the shader build without creating a window or a Vulkan device.
+		if (argc > 1 && std::strcmp(argv[1], "--cull-benchmark") == 0) {
+			FrustumCuller::RunBenchmark(1000000, std::cout);
+			return EXIT_SUCCESS;
+		}
+		if (argc > 1 && std::strcmp(argv[1], "--scene-benchmark") == 0) {
+			Scene::RunBenchmark(100000, std::cout);
+			return EXIT_SUCCESS;
+		}
+		if (argc > 1 && std::strcmp(argv[1], "--sort-benchmark") == 0) {
+			RenderQueue::RunBenchmark(1000000, std::cout);
+			return EXIT_SUCCESS;
+		}
+		if (argc > 1 && std::strcmp(argv[1], "--build-shaders") == 0) {
+			VulkanRenderer::BuildShaderBundle(std::cout);
+			return EXIT_SUCCESS;
+		}
+
+		// Renderer options can be combined in any order.
+		auto hasOption = [argc, argv](const char* option) {
+			for (int i = 1; i < argc; i++) {
+				if (std::strcmp(argv[i], option) == 0) {
+					return true;
+				}
+			}
+			return false;
+		};
+
+		// Dynamic rendering is used when the device supports it; --render-pass forces the render pass path.
+		// --stats prints the startup timing and the host allocation report at exit.
+		VulkanRenderer renderer;
+		renderer.SetDynamicRenderingEnabled(!hasOption("--render-pass"));
+		renderer.SetStatsReportEnabled(hasOption("--stats"));
+		renderer.Run();
 	}
 	catch (const std::exception& e) {
 		std::cerr << e.what() << "\n"; ///< Output exception message